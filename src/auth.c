@@ -113,7 +113,7 @@ ErrorCode create_user(const char* username, const char* password, int role) {
     // Log the user creation
     char log_details[100];
     snprintf(log_details, sizeof(log_details), "Created user: %s with role: %d", username, role);
-    log_action("SYSTEM", "Auth", "Create User", log_details);
+    log_write_action("SYSTEM", "Auth", "Create User", log_details);
     
     return SUCCESS;
 }
@@ -189,7 +189,7 @@ ErrorCode change_password(const char* username, const char* old_password, const
                 // Log password change
                 char log_details[100];
                 snprintf(log_details, sizeof(log_details), "Password changed for user: %s", username);
-                log_action(users[i].userID, "Auth", "Password Change", log_details);
+                log_write_action(users[i].userID, "Auth", "Password Change", log_details);
                 
                 return SUCCESS;
             } else {
@@ -0,0 +1,16 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32C (Castagnoli), the checksum framing audit log records. Computed with
+// the SSE4.2 crc32 instruction when the CPU has it, otherwise with a
+// slicing-by-8 table. Pass 0 to start; passing a previous result continues
+// the checksum over more bytes.
+uint32_t crc32c(uint32_t crc, const void* data, size_t length);
+
+// Name of the implementation in use: "sse4.2" or "table"
+const char* crc32c_implementation();
+
+#endif // CRC32C_H
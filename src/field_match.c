@@ -0,0 +1,248 @@
+#include "field_match.h"
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIELD_MATCH_X86 1
+#include <immintrin.h>
+#endif
+
+// Block kernel: marks matches among count records, returns how many matched
+typedef int (*FieldBlockKernel)(const FieldPattern* pattern, const unsigned char* field, size_t stride,
+                                size_t readable, int count, unsigned char* marks);
+
+// Helper function comparing the span bytes of one field
+static inline int match_scalar(const FieldPattern* pattern, const unsigned char* field) {
+    return memcmp(field, pattern->bytes, pattern->span) == 0;
+}
+
+static int block_scalar(const FieldPattern* pattern, const unsigned char* field, size_t stride,
+                        size_t readable, int count, unsigned char* marks) {
+    (void)readable;
+    int matches = 0;
+    for (int i = 0; i < count; i++, field += stride) {
+        int match = match_scalar(pattern, field);
+        if (marks) {
+            marks[i] = (unsigned char)match;
+        }
+        matches += match;
+    }
+    return matches;
+}
+
+#ifdef FIELD_MATCH_X86
+
+// Helper function comparing one field with 16-byte loads. Spans of 16 bytes
+// or more are covered by loads inside the span, the last one overlapping the
+// one before; a shorter span needs 16 readable bytes and masks the excess.
+static inline int match_sse2(const FieldPattern* pattern, const unsigned char* field, size_t readable) {
+    size_t span = pattern->span;
+    if (span < 16) {
+        if (readable < 16) {
+            return match_scalar(pattern, field);
+        }
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)field),
+                                    _mm_loadu_si128((const __m128i*)pattern->bytes));
+        unsigned int need = (1u << span) - 1;
+        return ((unsigned int)_mm_movemask_epi8(eq) & need) == need;
+    }
+
+    for (size_t offset = 0;; offset += 16) {
+        if (offset + 16 > span) {
+            offset = span - 16;
+        }
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(field + offset)),
+                                    _mm_loadu_si128((const __m128i*)(pattern->bytes + offset)));
+        if (_mm_movemask_epi8(eq) != 0xFFFF) {
+            return 0;
+        }
+        if (offset + 16 >= span) {
+            return 1;
+        }
+    }
+}
+
+static int block_sse2(const FieldPattern* pattern, const unsigned char* field, size_t stride,
+                      size_t readable, int count, unsigned char* marks) {
+    int matches = 0;
+    for (int i = 0; i < count; i++, field += stride) {
+        int match = match_sse2(pattern, field, readable);
+        if (marks) {
+            marks[i] = (unsigned char)match;
+        }
+        matches += match;
+    }
+    return matches;
+}
+
+// AVX2 covers spans of 32 bytes or more with 32-byte loads; shorter spans
+// gain nothing from them and use the SSE2 comparison
+__attribute__((target("avx2")))
+static int block_avx2(const FieldPattern* pattern, const unsigned char* field, size_t stride,
+                      size_t readable, int count, unsigned char* marks) {
+    size_t span = pattern->span;
+    if (span < 32) {
+        return block_sse2(pattern, field, stride, readable, count, marks);
+    }
+
+    int matches = 0;
+    for (int i = 0; i < count; i++, field += stride) {
+        int match = 1;
+        for (size_t offset = 0;; offset += 32) {
+            if (offset + 32 > span) {
+                offset = span - 32;
+            }
+            __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(field + offset)),
+                                           _mm256_loadu_si256((const __m256i*)(pattern->bytes + offset)));
+            if ((unsigned int)_mm256_movemask_epi8(eq) != 0xFFFFFFFFu) {
+                match = 0;
+                break;
+            }
+            if (offset + 32 >= span) {
+                break;
+            }
+        }
+        if (marks) {
+            marks[i] = (unsigned char)match;
+        }
+        matches += match;
+    }
+    return matches;
+}
+
+#endif // FIELD_MATCH_X86
+
+// Global variables for the selected kernel. A kernel may be forced while scan
+// workers run, so both are atomic; a worker uses either kernel, never a torn one.
+static _Atomic FieldBlockKernel block_kernel = block_scalar;
+static atomic_int active_kernel = FIELD_KERNEL_SCALAR;
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+// Helper function to check whether the CPU runs a kernel
+static int kernel_supported(FieldKernel kernel) {
+    switch (kernel) {
+        case FIELD_KERNEL_SCALAR:
+            return 1;
+#ifdef FIELD_MATCH_X86
+        case FIELD_KERNEL_SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case FIELD_KERNEL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return 0;
+    }
+}
+
+// Helper function to install a kernel
+static void install_kernel(FieldKernel kernel) {
+    FieldBlockKernel block = block_scalar;
+    switch (kernel) {
+#ifdef FIELD_MATCH_X86
+        case FIELD_KERNEL_SSE2:
+            block = block_sse2;
+            break;
+        case FIELD_KERNEL_AVX2:
+            block = block_avx2;
+            break;
+#endif
+        default:
+            kernel = FIELD_KERNEL_SCALAR;
+            break;
+    }
+    atomic_store(&block_kernel, block);
+    atomic_store(&active_kernel, (int)kernel);
+}
+
+// Helper function to pick the widest kernel the CPU runs
+static void select_kernel() {
+    if (kernel_supported(FIELD_KERNEL_AVX2)) {
+        install_kernel(FIELD_KERNEL_AVX2);
+    } else if (kernel_supported(FIELD_KERNEL_SSE2)) {
+        install_kernel(FIELD_KERNEL_SSE2);
+    } else {
+        install_kernel(FIELD_KERNEL_SCALAR);
+    }
+}
+
+// Function to force a kernel, or return to automatic selection
+ErrorCode field_match_use_kernel(FieldKernel kernel) {
+    pthread_once(&kernel_once, select_kernel);
+
+    if (kernel == FIELD_KERNEL_AUTO) {
+        select_kernel();
+        return SUCCESS;
+    }
+    if (!kernel_supported(kernel)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    install_kernel(kernel);
+    return SUCCESS;
+}
+
+// Function to name the kernel in use
+const char* field_match_kernel_name() {
+    pthread_once(&kernel_once, select_kernel);
+
+    switch (atomic_load(&active_kernel)) {
+        case FIELD_KERNEL_SSE2:
+            return "sse2";
+        case FIELD_KERNEL_AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+// Function to compile a key for fields of width bytes
+ErrorCode field_pattern_init(FieldPattern* pattern, const char* key, size_t width, FieldMatchMode mode) {
+    if (!pattern || !key || width == 0 || width > FIELD_MATCH_MAX_WIDTH ||
+        (mode != FIELD_MATCH_EQUAL && mode != FIELD_MATCH_PREFIX)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(pattern, 0, sizeof(FieldPattern));
+    pattern->width = width;
+
+    size_t length = strlen(key);
+    size_t span = mode == FIELD_MATCH_EQUAL ? length + 1 : length;  // Equality includes the NUL
+    if (span > width) {
+        pattern->impossible = 1;
+        return SUCCESS;
+    }
+
+    memcpy(pattern->bytes, key, length);
+    pattern->span = span;
+    return SUCCESS;
+}
+
+// Function to match the field of one record
+int field_match_record(const FieldPattern* pattern, const void* record, size_t record_size, size_t field_offset) {
+    return field_match_block(pattern, record, record_size, field_offset, 1, NULL);
+}
+
+// Function to mark the records whose field matches
+int field_match_block(const FieldPattern* pattern, const void* records, size_t stride, size_t field_offset,
+                      int count, unsigned char* marks) {
+    if (!pattern || !records || count <= 0 || field_offset + pattern->width > stride) {
+        return 0;
+    }
+
+    if (pattern->impossible) {
+        if (marks) {
+            memset(marks, 0, (size_t)count);
+        }
+        return 0;
+    }
+
+    pthread_once(&kernel_once, select_kernel);
+
+    // Loads may run to the end of each record, never past it
+    const unsigned char* field = (const unsigned char*)records + field_offset;
+    FieldBlockKernel block = atomic_load_explicit(&block_kernel, memory_order_relaxed);
+    return block(pattern, field, stride, stride - field_offset, count, marks);
+}
@@ -0,0 +1,53 @@
+#ifndef FIELD_MATCH_H
+#define FIELD_MATCH_H
+
+#include "data_structures.h"
+#include <stddef.h>
+
+// Equality and prefix kernels for the fixed-width char[] fields of records
+// (LogEntry.userID, Payment.studentID, ...). A key is compiled once into a
+// FieldPattern; fields are then compared with 16-byte (SSE2) or 32-byte
+// (AVX2) loads instead of strcmp, only over the bytes the key decides: its
+// characters plus, for equality, the terminating NUL. Bytes after the NUL
+// never affect the result, so fields need not be zero padded.
+//
+// The kernel is picked at runtime from the CPU's features, with a scalar
+// fallback on other architectures. The block functions evaluate a run of
+// records in one call.
+
+#define FIELD_MATCH_MAX_WIDTH 64
+
+typedef enum {
+    FIELD_MATCH_EQUAL = 0,    // Field equals the key
+    FIELD_MATCH_PREFIX = 1    // Field starts with the key
+} FieldMatchMode;
+
+typedef enum {
+    FIELD_KERNEL_AUTO = 0,
+    FIELD_KERNEL_SCALAR = 1,
+    FIELD_KERNEL_SSE2 = 2,
+    FIELD_KERNEL_AVX2 = 3
+} FieldKernel;
+
+typedef struct {
+    unsigned char bytes[FIELD_MATCH_MAX_WIDTH + 32];  // Key, zero padded past the compared span
+    size_t span;              // Bytes compared
+    size_t width;             // Size of the field
+    int impossible;           // The key cannot fit the field, nothing matches
+} FieldPattern;
+
+// Compiling a key for fields of width bytes
+ErrorCode field_pattern_init(FieldPattern* pattern, const char* key, size_t width, FieldMatchMode mode);
+
+// Matching one record's field, or marking the matches among count records laid
+// out stride bytes apart; marks may be NULL. Both return the number of matches.
+int field_match_record(const FieldPattern* pattern, const void* record, size_t record_size, size_t field_offset);
+int field_match_block(const FieldPattern* pattern, const void* records, size_t stride, size_t field_offset,
+                      int count, unsigned char* marks);
+
+// Kernel selection, for benchmarks and tests; returns ERROR_INVALID_INPUT
+// when the CPU lacks the instruction set
+ErrorCode field_match_use_kernel(FieldKernel kernel);
+const char* field_match_kernel_name();
+
+#endif // FIELD_MATCH_H
@@ -1,15 +1,24 @@
 #include "file_io.h"
+#include "log_store.h"
+#include "log_query.h"
+#include "log_scan.h"
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
 
 // Define file paths
 #define STUDENTS_FILE "data/students.dat"
 #define OFFICERS_FILE "data/officers.dat"
 #define PAYMENTS_FILE "data/payments.dat"
-#define LOGS_FILE "data/logs.dat"
 
 // Helper function to get file size
 long get_file_size(const char* filename) {
@@ -37,19 +46,44 @@ int file_exists(const char* filename) {
 
 // Helper function to ensure directory exists
 ErrorCode ensure_directory_exists(const char* dir_path) {
-    // On Windows, we'd use CreateDirectory, but for portability we'll use system command
-    // This is a simplified implementation - in production, use platform-specific APIs
-    char command[512];
-    snprintf(command, sizeof(command), "mkdir \"%s\" 2>nul", dir_path);
-    
-    int result = system(command);
-    if (result == 0 || result == 1) {  // mkdir returns 1 if directory already exists
+    if (!dir_path) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Create the directory directly instead of forking a shell for mkdir
+#ifdef _WIN32
+    int result = _mkdir(dir_path);
+#else
+    int result = mkdir(dir_path, 0755);
+#endif
+    if (result == 0 || errno == EEXIST) {
         return SUCCESS;
     }
     
     return ERROR_FILE_OPERATION;
 }
 
+// Helper function to map a file of fixed-size records as a read-only view.
+// A missing file is an empty view; a trailing partial record is ignored.
+static ErrorCode open_record_view(const char* path, size_t record_size, MappedFile* map,
+                                  const void** items, int* count) {
+    *items = NULL;
+    *count = 0;
+    
+    ErrorCode result = mapped_file_open(path, MAPPED_ACCESS_SEQUENTIAL, map);
+    if (result == ERROR_DATA_NOT_FOUND) {
+        memset(map, 0, sizeof(MappedFile));
+        return SUCCESS;
+    }
+    if (result != SUCCESS) {
+        return result;
+    }
+    
+    *items = map->data;
+    *count = (int)(map->size / record_size);
+    return SUCCESS;
+}
+
 // File I/O functions for Students
 ErrorCode save_student(const Student* student) {
     if (!student) {
@@ -87,23 +121,25 @@ ErrorCode load_student(const char* student_id, Student* student) {
         return ERROR_DATA_NOT_FOUND;
     }
     
-    FILE* file = fopen(STUDENTS_FILE, "rb");
-    if (!file) {
+    // Walk the mapped records in place instead of reading them one by one
+    StudentView view;
+    ErrorCode result = view_all_students(&view);
+    if (result != SUCCESS) {
         log_error(ERROR_FILE_OPERATION, "load_student", "Could not open students file for reading");
         return ERROR_FILE_OPERATION;
     }
     
-    Student temp_student;
-    while (fread(&temp_student, sizeof(Student), 1, file) == 1) {
-        if (strcmp(temp_student.studentID, student_id) == 0) {
-            *student = temp_student;
-            fclose(file);
-            return SUCCESS;
+    result = ERROR_DATA_NOT_FOUND;
+    for (int i = 0; i < view.count; i++) {
+        if (strcmp(view.items[i].studentID, student_id) == 0) {
+            *student = view.items[i];
+            result = SUCCESS;
+            break;
         }
     }
     
-    fclose(file);
-    return ERROR_DATA_NOT_FOUND;
+    release_student_view(&view);
+    return result;
 }
 
 ErrorCode update_student(const Student* student) {
@@ -261,50 +297,53 @@ ErrorCode list_all_students(Student** students, int* count) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (!file_exists(STUDENTS_FILE)) {
-        *students = NULL;
-        *count = 0;
-        return SUCCESS;
-    }
-    
-    FILE* file = fopen(STUDENTS_FILE, "rb");
-    if (!file) {
-        return ERROR_FILE_OPERATION;
+    StudentView view;
+    ErrorCode result = view_all_students(&view);
+    if (result != SUCCESS) {
+        return result;
     }
     
-    long file_size = get_file_size(STUDENTS_FILE);
-    if (file_size < 0) {
-        fclose(file);
-        return ERROR_FILE_OPERATION;
-    }
-    
-    int student_count = file_size / sizeof(Student);
-    if (student_count == 0) {
+    if (view.count == 0) {
+        release_student_view(&view);
         *students = NULL;
         *count = 0;
-        fclose(file);
         return SUCCESS;
     }
     
-    Student* all_students = (Student*)safe_malloc(student_count * sizeof(Student));
+    // Callers own and may modify the result, so copy it out of the mapping once
+    Student* all_students = (Student*)safe_malloc(view.count * sizeof(Student));
     if (!all_students) {
-        fclose(file);
+        release_student_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
-    
-    int read_count = fread(all_students, sizeof(Student), student_count, file);
-    fclose(file);
-    
-    if (read_count != student_count) {
-        safe_free((void**)&all_students);
-        return ERROR_FILE_OPERATION;
-    }
+    memcpy(all_students, view.items, view.count * sizeof(Student));
     
     *students = all_students;
-    *count = student_count;
+    *count = view.count;
+    release_student_view(&view);
     return SUCCESS;
 }
 
+// Function to map all students as a read-only view
+ErrorCode view_all_students(StudentView* view) {
+    if (!view) {
+        return ERROR_INVALID_INPUT;
+    }
+    
+    const void* items = NULL;
+    ErrorCode result = open_record_view(STUDENTS_FILE, sizeof(Student), &view->map, &items, &view->count);
+    view->items = (const Student*)items;
+    return result;
+}
+
+void release_student_view(StudentView* view) {
+    if (view) {
+        mapped_file_close(&view->map);
+        view->items = NULL;
+        view->count = 0;
+    }
+}
+
 // File I/O functions for Officers
 ErrorCode save_officer(const Officer* officer) {
     if (!officer) {
@@ -342,23 +381,25 @@ ErrorCode load_officer(const char* officer_id, Officer* officer) {
         return ERROR_DATA_NOT_FOUND;
     }
     
-    FILE* file = fopen(OFFICERS_FILE, "rb");
-    if (!file) {
+    // Walk the mapped records in place instead of reading them one by one
+    OfficerView view;
+    ErrorCode result = view_all_officers(&view);
+    if (result != SUCCESS) {
         log_error(ERROR_FILE_OPERATION, "load_officer", "Could not open officers file for reading");
         return ERROR_FILE_OPERATION;
     }
     
-    Officer temp_officer;
-    while (fread(&temp_officer, sizeof(Officer), 1, file) == 1) {
-        if (strcmp(temp_officer.officerID, officer_id) == 0) {
-            *officer = temp_officer;
-            fclose(file);
-            return SUCCESS;
+    result = ERROR_DATA_NOT_FOUND;
+    for (int i = 0; i < view.count; i++) {
+        if (strcmp(view.items[i].officerID, officer_id) == 0) {
+            *officer = view.items[i];
+            result = SUCCESS;
+            break;
         }
     }
     
-    fclose(file);
-    return ERROR_DATA_NOT_FOUND;
+    release_officer_view(&view);
+    return result;
 }
 
 ErrorCode update_officer(const Officer* officer) {
@@ -516,50 +557,53 @@ ErrorCode list_all_officers(Officer** officers, int* count) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (!file_exists(OFFICERS_FILE)) {
-        *officers = NULL;
-        *count = 0;
-        return SUCCESS;
-    }
-    
-    FILE* file = fopen(OFFICERS_FILE, "rb");
-    if (!file) {
-        return ERROR_FILE_OPERATION;
+    OfficerView view;
+    ErrorCode result = view_all_officers(&view);
+    if (result != SUCCESS) {
+        return result;
     }
     
-    long file_size = get_file_size(OFFICERS_FILE);
-    if (file_size < 0) {
-        fclose(file);
-        return ERROR_FILE_OPERATION;
-    }
-    
-    int officer_count = file_size / sizeof(Officer);
-    if (officer_count == 0) {
+    if (view.count == 0) {
+        release_officer_view(&view);
         *officers = NULL;
         *count = 0;
-        fclose(file);
         return SUCCESS;
     }
     
-    Officer* all_officers = (Officer*)safe_malloc(officer_count * sizeof(Officer));
+    // Callers own and may modify the result, so copy it out of the mapping once
+    Officer* all_officers = (Officer*)safe_malloc(view.count * sizeof(Officer));
     if (!all_officers) {
-        fclose(file);
+        release_officer_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
-    
-    int read_count = fread(all_officers, sizeof(Officer), officer_count, file);
-    fclose(file);
-    
-    if (read_count != officer_count) {
-        safe_free((void**)&all_officers);
-        return ERROR_FILE_OPERATION;
-    }
+    memcpy(all_officers, view.items, view.count * sizeof(Officer));
     
     *officers = all_officers;
-    *count = officer_count;
+    *count = view.count;
+    release_officer_view(&view);
     return SUCCESS;
 }
 
+// Function to map all officers as a read-only view
+ErrorCode view_all_officers(OfficerView* view) {
+    if (!view) {
+        return ERROR_INVALID_INPUT;
+    }
+    
+    const void* items = NULL;
+    ErrorCode result = open_record_view(OFFICERS_FILE, sizeof(Officer), &view->map, &items, &view->count);
+    view->items = (const Officer*)items;
+    return result;
+}
+
+void release_officer_view(OfficerView* view) {
+    if (view) {
+        mapped_file_close(&view->map);
+        view->items = NULL;
+        view->count = 0;
+    }
+}
+
 // File I/O functions for Payments
 ErrorCode save_payment(const Payment* payment) {
     if (!payment) {
@@ -597,23 +641,25 @@ ErrorCode load_payment(const char* payment_id, Payment* payment) {
         return ERROR_DATA_NOT_FOUND;
     }
     
-    FILE* file = fopen(PAYMENTS_FILE, "rb");
-    if (!file) {
+    // Walk the mapped records in place instead of reading them one by one
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
+    if (result != SUCCESS) {
         log_error(ERROR_FILE_OPERATION, "load_payment", "Could not open payments file for reading");
         return ERROR_FILE_OPERATION;
     }
     
-    Payment temp_payment;
-    while (fread(&temp_payment, sizeof(Payment), 1, file) == 1) {
-        if (strcmp(temp_payment.paymentID, payment_id) == 0) {
-            *payment = temp_payment;
-            fclose(file);
-            return SUCCESS;
+    result = ERROR_DATA_NOT_FOUND;
+    for (int i = 0; i < view.count; i++) {
+        if (strcmp(view.items[i].paymentID, payment_id) == 0) {
+            *payment = view.items[i];
+            result = SUCCESS;
+            break;
         }
     }
     
-    fclose(file);
-    return ERROR_DATA_NOT_FOUND;
+    release_payment_view(&view);
+    return result;
 }
 
 ErrorCode update_payment(const Payment* payment) {
@@ -771,135 +817,97 @@ ErrorCode list_all_payments(Payment** payments, int* count) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (!file_exists(PAYMENTS_FILE)) {
-        *payments = NULL;
-        *count = 0;
-        return SUCCESS;
-    }
-    
-    FILE* file = fopen(PAYMENTS_FILE, "rb");
-    if (!file) {
-        return ERROR_FILE_OPERATION;
-    }
-    
-    long file_size = get_file_size(PAYMENTS_FILE);
-    if (file_size < 0) {
-        fclose(file);
-        return ERROR_FILE_OPERATION;
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
+    if (result != SUCCESS) {
+        return result;
     }
     
-    int payment_count = file_size / sizeof(Payment);
-    if (payment_count == 0) {
+    if (view.count == 0) {
+        release_payment_view(&view);
         *payments = NULL;
         *count = 0;
-        fclose(file);
         return SUCCESS;
     }
     
-    Payment* all_payments = (Payment*)safe_malloc(payment_count * sizeof(Payment));
+    // Callers own and may modify the result, so copy it out of the mapping once
+    Payment* all_payments = (Payment*)safe_malloc(view.count * sizeof(Payment));
     if (!all_payments) {
-        fclose(file);
+        release_payment_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
-    
-    int read_count = fread(all_payments, sizeof(Payment), payment_count, file);
-    fclose(file);
-    
-    if (read_count != payment_count) {
-        safe_free((void**)&all_payments);
-        return ERROR_FILE_OPERATION;
-    }
+    memcpy(all_payments, view.items, view.count * sizeof(Payment));
     
     *payments = all_payments;
-    *count = payment_count;
+    *count = view.count;
+    release_payment_view(&view);
     return SUCCESS;
 }
 
-// File I/O functions for Logs
-ErrorCode save_log(const LogEntry* log) {
-    if (!log) {
+// Function to map all payments as a read-only view
+ErrorCode view_all_payments(PaymentView* view) {
+    if (!view) {
         return ERROR_INVALID_INPUT;
     }
     
-    // Ensure data directory exists
-    ErrorCode dir_result = ensure_directory_exists("data");
-    if (dir_result != SUCCESS) {
-        return dir_result;
-    }
-    
-    FILE* file = fopen(LOGS_FILE, "ab");
-    if (!file) {
-        log_error(ERROR_FILE_OPERATION, "save_log", "Could not open logs file for writing");
-        return ERROR_FILE_OPERATION;
+    const void* items = NULL;
+    ErrorCode result = open_record_view(PAYMENTS_FILE, sizeof(Payment), &view->map, &items, &view->count);
+    view->items = (const Payment*)items;
+    return result;
+}
+
+void release_payment_view(PaymentView* view) {
+    if (view) {
+        mapped_file_close(&view->map);
+        view->items = NULL;
+        view->count = 0;
     }
-    
-    if (fwrite(log, sizeof(LogEntry), 1, file) != 1) {
-        fclose(file);
-        log_error(ERROR_FILE_OPERATION, "save_log", "Could not write log data");
-        return ERROR_FILE_OPERATION;
+}
+
+// File I/O functions for Logs
+ErrorCode save_log(const LogEntry* log) {
+    if (!log) {
+        return ERROR_INVALID_INPUT;
     }
     
-    fclose(file);
-    return SUCCESS;
+    // Records are appended to the active segment of the log store
+    return log_store_append(log);
 }
 
+// Helper function to run a query on the parallel scan engine, which returns
+// the matches in timestamp order
+static ErrorCode collect_logs(time_t start, time_t end, const char* posting_key, LogPostingKind posting_kind,
+                              LogEntry** logs, int* count) {
+    LogScanQuery query = { start, end, NULL, NULL, posting_key, posting_kind, NULL };
+    return log_scan_collect(&query, logs, count);
+}
+
+// The load functions materialize a query for callers that need the whole
+// result set at once; log_query.h streams records instead
 ErrorCode load_logs_by_date(const char* date, LogEntry** logs, int* count) {
     if (!date || !logs || !count) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (!file_exists(LOGS_FILE)) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;
-    }
-    
-    FILE* file = fopen(LOGS_FILE, "rb");
-    if (!file) {
-        return ERROR_FILE_OPERATION;
-    }
-    
-    // First, count matching logs
-    LogEntry temp_log;
-    int matching_count = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        char date_str[11];
-        strftime(date_str, sizeof(date_str), "%Y-%m-%d", localtime(&temp_log.timestamp));
-        if (strcmp(date_str, date) == 0) {
-            matching_count++;
-        }
-    }
-    
-    if (matching_count == 0) {
+    time_t start;
+    time_t end;
+    if (!log_query_date_range(date, &start, &end)) {
         *logs = NULL;
         *count = 0;
-        fclose(file);
-        return SUCCESS;
+        return SUCCESS;  // An invalid date matches nothing
     }
     
-    // Allocate memory for logs
-    LogEntry* matching_logs = (LogEntry*)safe_malloc(matching_count * sizeof(LogEntry));
-    if (!matching_logs) {
-        fclose(file);
-        return ERROR_MEMORY_ALLOCATION;
-    }
-    
-    // Read matching logs
-    rewind(file);
-    int index = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        char date_str[11];
-        strftime(date_str, sizeof(date_str), "%Y-%m-%d", localtime(&temp_log.timestamp));
-        if (strcmp(date_str, date) == 0) {
-            matching_logs[index] = temp_log;
-            index++;
-        }
+    return collect_logs(start, end, NULL, LOG_POSTING_USER, logs, count);
+}
+
+ErrorCode load_logs_by_time_range(time_t start, time_t end, LogEntry** logs, int* count) {
+    if (!logs || !count || (start != 0 && end != 0 && end < start)) {
+        return ERROR_INVALID_INPUT;
     }
     
-    fclose(file);
-    *logs = matching_logs;
-    *count = matching_count;
-    return SUCCESS;
+    // Only overlapping segments are opened, and each is entered at the first
+    // index block that can reach start, so cost follows the range, not history
+    return collect_logs(start, end, NULL, LOG_POSTING_USER, logs, count);
 }
 
 ErrorCode load_logs_by_user(const char* user_id, LogEntry** logs, int* count) {
@@ -907,54 +915,26 @@ ErrorCode load_logs_by_user(const char* user_id, LogEntry** logs, int* count) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (!file_exists(LOGS_FILE)) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;
-    }
-    
-    FILE* file = fopen(LOGS_FILE, "rb");
-    if (!file) {
-        return ERROR_FILE_OPERATION;
-    }
-    
-    // First, count matching logs
-    LogEntry temp_log;
-    int matching_count = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        if (strcmp(temp_log.userID, user_id) == 0) {
-            matching_count++;
-        }
-    }
-    
-    if (matching_count == 0) {
-        *logs = NULL;
-        *count = 0;
-        fclose(file);
-        return SUCCESS;
-    }
-    
-    // Allocate memory for logs
-    LogEntry* matching_logs = (LogEntry*)safe_malloc(matching_count * sizeof(LogEntry));
-    if (!matching_logs) {
-        fclose(file);
-        return ERROR_MEMORY_ALLOCATION;
+    return collect_logs(0, 0, user_id, LOG_POSTING_USER, logs, count);
+}
+
+ErrorCode load_logs_by_module(const char* module, LogEntry** logs, int* count) {
+    if (!module || !logs || !count) {
+        return ERROR_INVALID_INPUT;
     }
     
-    // Read matching logs
-    rewind(file);
-    int index = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        if (strcmp(temp_log.userID, user_id) == 0) {
-            matching_logs[index] = temp_log;
-            index++;
-        }
+    return collect_logs(0, 0, module, LOG_POSTING_MODULE, logs, count);
+}
+
+// Every predicate of the query is applied during the scan; each segment is
+// read through its most selective index
+ErrorCode load_logs_matching(const LogQuery* query, LogEntry** logs, int* count) {
+    if (!query || !logs || !count || (query->start != 0 && query->end != 0 && query->end < query->start)) {
+        return ERROR_INVALID_INPUT;
     }
     
-    fclose(file);
-    *logs = matching_logs;
-    *count = matching_count;
-    return SUCCESS;
+    LogScanQuery scan = { query->start, query->end, NULL, NULL, NULL, LOG_POSTING_USER, query };
+    return log_scan_collect(&scan, logs, count);
 }
 
 ErrorCode load_all_logs(LogEntry** logs, int* count) {
@@ -962,48 +942,7 @@ ErrorCode load_all_logs(LogEntry** logs, int* count) {
         return ERROR_INVALID_INPUT;
     }
     
-    if (!file_exists(LOGS_FILE)) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;
-    }
-    
-    FILE* file = fopen(LOGS_FILE, "rb");
-    if (!file) {
-        return ERROR_FILE_OPERATION;
-    }
-    
-    long file_size = get_file_size(LOGS_FILE);
-    if (file_size < 0) {
-        fclose(file);
-        return ERROR_FILE_OPERATION;
-    }
-    
-    int log_count = file_size / sizeof(LogEntry);
-    if (log_count == 0) {
-        *logs = NULL;
-        *count = 0;
-        fclose(file);
-        return SUCCESS;
-    }
-    
-    LogEntry* all_logs = (LogEntry*)safe_malloc(log_count * sizeof(LogEntry));
-    if (!all_logs) {
-        fclose(file);
-        return ERROR_MEMORY_ALLOCATION;
-    }
-    
-    int read_count = fread(all_logs, sizeof(LogEntry), log_count, file);
-    fclose(file);
-    
-    if (read_count != log_count) {
-        safe_free((void**)&all_logs);
-        return ERROR_FILE_OPERATION;
-    }
-    
-    *logs = all_logs;
-    *count = log_count;
-    return SUCCESS;
+    return collect_logs(0, 0, NULL, LOG_POSTING_USER, logs, count);
 }
 
 // Generic file utility functions
@@ -2,14 +2,38 @@
 #define FILE_IO_H
 
 #include "data_structures.h"
+#include "mapped_file.h"
+#include "log_query.h"
 #include <stdio.h>
 
+// Read-only views of a data file's records, read in place from a memory
+// mapping; valid until released and never to be modified
+typedef struct {
+    const Student* items;
+    int count;
+    MappedFile map;
+} StudentView;
+
+typedef struct {
+    const Officer* items;
+    int count;
+    MappedFile map;
+} OfficerView;
+
+typedef struct {
+    const Payment* items;
+    int count;
+    MappedFile map;
+} PaymentView;
+
 // File I/O functions for Students
 ErrorCode save_student(const Student* student);
 ErrorCode load_student(const char* student_id, Student* student);
 ErrorCode update_student(const Student* student);
 ErrorCode delete_student(const char* student_id);
 ErrorCode list_all_students(Student** students, int* count);
+ErrorCode view_all_students(StudentView* view);
+void release_student_view(StudentView* view);
 
 // File I/O functions for Officers
 ErrorCode save_officer(const Officer* officer);
@@ -17,6 +41,8 @@ ErrorCode load_officer(const char* officer_id, Officer* officer);
 ErrorCode update_officer(const Officer* officer);
 ErrorCode delete_officer(const char* officer_id);
 ErrorCode list_all_officers(Officer** officers, int* count);
+ErrorCode view_all_officers(OfficerView* view);
+void release_officer_view(OfficerView* view);
 
 // File I/O functions for Payments
 ErrorCode save_payment(const Payment* payment);
@@ -24,11 +50,16 @@ ErrorCode load_payment(const char* payment_id, Payment* payment);
 ErrorCode update_payment(const Payment* payment);
 ErrorCode delete_payment(const char* payment_id);
 ErrorCode list_all_payments(Payment** payments, int* count);
+ErrorCode view_all_payments(PaymentView* view);
+void release_payment_view(PaymentView* view);
 
 // File I/O functions for Logs
 ErrorCode save_log(const LogEntry* log);
 ErrorCode load_logs_by_date(const char* date, LogEntry** logs, int* count);
+ErrorCode load_logs_by_time_range(time_t start, time_t end, LogEntry** logs, int* count);
 ErrorCode load_logs_by_user(const char* user_id, LogEntry** logs, int* count);
+ErrorCode load_logs_by_module(const char* module, LogEntry** logs, int* count);
+ErrorCode load_logs_matching(const LogQuery* query, LogEntry** logs, int* count);
 ErrorCode load_all_logs(LogEntry** logs, int* count);
 
 // Generic file utility functions
@@ -0,0 +1,1062 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_aggregate.h"
+#include "log_bloom.h"
+#include "log_postings.h"
+#include "log_time_index.h"
+#include "log_columnar.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define SUMMARY_MAGIC "LSUM"
+#define SUMMARY_VERSION 1
+#define SUMMARY_KEY_LEN (MAX_MODULE_LEN + MAX_ACTION_LEN + MAX_ID_LEN)
+#define KEY_SEPARATOR '\x1f'
+#define INITIAL_GROUP_CAPACITY 64
+#define SECONDS_PER_HOUR 3600
+#define ROLLUP_MAGIC "LRUP"
+#define ROLLUP_VERSION 1
+#define ROLLUP_MANIFEST_MAGIC "LRMF"
+#define ROLLUP_MANIFEST LOG_STORE_DIR "/ROLLUPS"
+
+// Columns a count reads from an archived segment when no predicate or key
+// function needs the whole record
+#define COUNTED_COLUMNS (LOG_COLUMN_BIT(LOG_COLUMN_TIMESTAMP) | LOG_COLUMN_BIT(LOG_COLUMN_MODULE) | \
+                         LOG_COLUMN_BIT(LOG_COLUMN_ACTION) | LOG_COLUMN_BIT(LOG_COLUMN_USER))
+
+// Summary file header, followed by row_count rows in hour order
+typedef struct {
+    char magic[4];
+    int version;
+    long long record_count;   // Records of the segment the summary describes
+    int row_count;
+    int reserved;
+} SummaryHeader;
+
+// Records of one local hour sharing module, action and user
+typedef struct {
+    time_t hour;
+    char module[MAX_MODULE_LEN];
+    char action[MAX_ACTION_LEN];
+    char user_id[MAX_ID_LEN];
+    long long count;
+} SummaryRow;
+
+// Rollup file header (rollup-YYYYMM.rlp), followed by segment_count directory
+// entries and then each segment's summary rows, in directory order
+typedef struct {
+    char magic[4];
+    int version;
+    int segment_count;
+    int reserved;
+} RollupHeader;
+
+// Summary rows kept for a dropped segment
+typedef struct {
+    int segment_id;
+    int row_count;
+    long long first_row;
+    time_t min_hour;
+    time_t max_hour;
+} RollupDirEntry;
+
+// Rollup manifest header, followed by month_count YYYYMM month numbers
+typedef struct {
+    char magic[4];
+    int version;
+    int month_count;
+    int reserved;
+} RollupManifestHeader;
+
+// Contents of one rollup file
+typedef struct {
+    RollupDirEntry* directory;
+    int segment_count;
+    SummaryRow* rows;
+    int row_count;
+} Rollup;
+
+// Open-addressing hash table of group counts
+typedef struct {
+    int used;
+    time_t bucket;
+    char key[SUMMARY_KEY_LEN];
+    long long count;
+} GroupSlot;
+
+typedef struct {
+    GroupSlot* slots;
+    int capacity;
+    int size;
+} GroupTable;
+
+// Local day of the last bucketed timestamp, so mktime runs once per day
+typedef struct {
+    time_t day_start;
+    time_t day_end;
+} DayCache;
+
+// State of one aggregation
+typedef struct {
+    const LogAggregateQuery* query;
+    GroupTable groups;
+    DayCache days;
+    long long total;
+} Aggregation;
+
+// Serializes summary builds, which share temporary file names
+static pthread_mutex_t summary_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Serializes rollup and rollup manifest updates
+static pthread_mutex_t rollup_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Helper function to hash a (bucket, key) pair with FNV-1a
+static unsigned int hash_group(time_t bucket, const char* key) {
+    unsigned int hash = 2166136261u ^ (unsigned int)bucket ^ (unsigned int)((long long)bucket >> 32);
+    for (const char* p = key; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ErrorCode groups_init(GroupTable* table, int capacity) {
+    table->slots = (GroupSlot*)calloc(capacity, sizeof(GroupSlot));
+    if (!table->slots) {
+        log_error(ERROR_MEMORY_ALLOCATION, "groups_init", "Failed to allocate group table");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    table->capacity = capacity;
+    table->size = 0;
+    return SUCCESS;
+}
+
+static void groups_free(GroupTable* table) {
+    free(table->slots);
+    table->slots = NULL;
+    table->capacity = 0;
+    table->size = 0;
+}
+
+// Helper function to find the slot for a group, or the empty slot where it belongs
+static GroupSlot* groups_slot(GroupTable* table, time_t bucket, const char* key) {
+    unsigned int mask = (unsigned int)table->capacity - 1;
+    unsigned int index = hash_group(bucket, key) & mask;
+    while (table->slots[index].used &&
+           (table->slots[index].bucket != bucket || strcmp(table->slots[index].key, key) != 0)) {
+        index = (index + 1) & mask;
+    }
+    return &table->slots[index];
+}
+
+static ErrorCode groups_add(GroupTable* table, time_t bucket, const char* key, long long count) {
+    if (table->size * 2 >= table->capacity) {
+        GroupTable grown;
+        ErrorCode result = groups_init(&grown, table->capacity * 2);
+        if (result != SUCCESS) {
+            return result;
+        }
+        for (int i = 0; i < table->capacity; i++) {
+            if (table->slots[i].used) {
+                *groups_slot(&grown, table->slots[i].bucket, table->slots[i].key) = table->slots[i];
+                grown.size++;
+            }
+        }
+        free(table->slots);
+        *table = grown;
+    }
+
+    GroupSlot* slot = groups_slot(table, bucket, key);
+    if (!slot->used) {
+        slot->used = 1;
+        slot->bucket = bucket;
+        safe_strcpy(slot->key, key, sizeof(slot->key));
+        table->size++;
+    }
+    slot->count += count;
+    return SUCCESS;
+}
+
+// Helper function to find the local day holding a timestamp
+static void day_of(DayCache* cache, time_t timestamp) {
+    if (cache->day_end > cache->day_start && timestamp >= cache->day_start && timestamp < cache->day_end) {
+        return;
+    }
+
+    struct tm local;
+    localtime_r(&timestamp, &local);
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_isdst = -1;
+    cache->day_start = mktime(&local);
+
+    local.tm_mday++;
+    local.tm_isdst = -1;
+    cache->day_end = mktime(&local);
+}
+
+// Helper function to find the start of the local hour holding a timestamp
+static time_t hour_of(DayCache* cache, time_t timestamp) {
+    day_of(cache, timestamp);
+    return cache->day_start + (timestamp - cache->day_start) / SECONDS_PER_HOUR * SECONDS_PER_HOUR;
+}
+
+// Helper function to check an optional string filter
+static int field_accepts(const char* filter, const char* value) {
+    return !filter || !filter[0] || strcmp(filter, value) == 0;
+}
+
+// Helper function to count one record into its group
+static ErrorCode aggregate_record(Aggregation* aggregation, const LogEntry* entry) {
+    const LogAggregateQuery* query = aggregation->query;
+
+    if ((query->start != 0 && entry->timestamp < query->start) ||
+        (query->end != 0 && entry->timestamp > query->end) ||
+        !field_accepts(query->module, entry->module) ||
+        !field_accepts(query->action, entry->action) ||
+        !field_accepts(query->user_id, entry->userID) ||
+        (query->predicate && !query->predicate(entry, query->context))) {
+        return SUCCESS;
+    }
+
+    time_t bucket = 0;
+    const char* key = "";
+    char custom_key[LOG_AGGREGATE_KEY_LEN];
+
+    switch (query->group_by) {
+        case LOG_GROUP_MODULE:
+            key = entry->module;
+            break;
+        case LOG_GROUP_ACTION:
+            key = entry->action;
+            break;
+        case LOG_GROUP_USER:
+            key = entry->userID;
+            break;
+        case LOG_GROUP_HOUR:
+            bucket = hour_of(&aggregation->days, entry->timestamp);
+            break;
+        case LOG_GROUP_DAY:
+            day_of(&aggregation->days, entry->timestamp);
+            bucket = aggregation->days.day_start;
+            break;
+        case LOG_GROUP_CUSTOM:
+            custom_key[0] = '\0';
+            if (!query->key_function(entry, custom_key, sizeof(custom_key), query->context)) {
+                return SUCCESS;
+            }
+            custom_key[sizeof(custom_key) - 1] = '\0';
+            key = custom_key;
+            break;
+    }
+
+    aggregation->total++;
+    return groups_add(&aggregation->groups, bucket, key, 1);
+}
+
+// Helper function to count the matching records of a segment in one pass
+static ErrorCode aggregate_segment_records(Aggregation* aggregation, const LogSegmentInfo* info) {
+    const LogAggregateQuery* query = aggregation->query;
+
+    LogSegmentReader reader;
+    ErrorCode result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        return result;
+    }
+    if (!query->predicate && !query->key_function) {
+        log_segment_reader_set_columns(&reader, COUNTED_COLUMNS);
+    }
+
+    // Enter the segment at the first index block that can reach start
+    if (query->start != 0 && info->min_timestamp < query->start) {
+        LogTimeIndexEntry* entries = NULL;
+        int entry_count = 0;
+        if (log_time_index_load(info, &entries, &entry_count) == SUCCESS && entry_count > 0) {
+            log_segment_reader_seek(&reader, log_time_index_find_start(entries, entry_count, query->start));
+        }
+        safe_free((void**)&entries);
+    }
+
+    const LogEntry* entry;
+    while (result == SUCCESS && (entry = log_segment_reader_next(&reader)) != NULL) {
+        result = aggregate_record(aggregation, entry);
+    }
+
+    log_segment_reader_close(&reader);
+    return result;
+}
+
+// Helper function to build the summary path for a segment: seg-*.dat -> seg-*.sum
+static void summary_path(const LogSegmentInfo* info, char* buffer, size_t buffer_size) {
+    log_store_segment_path(info, buffer, buffer_size);
+
+    char* extension = strrchr(buffer, '.');
+    if (extension && strlen(extension) == 4) {
+        strcpy(extension, ".sum");
+    } else {
+        safe_strcat(buffer, ".sum", buffer_size);
+    }
+}
+
+// Helper function to split a packed module/action/user key into a summary row
+static void unpack_summary_key(const char* key, SummaryRow* row) {
+    char* fields[3] = { row->module, row->action, row->user_id };
+    size_t sizes[3] = { sizeof(row->module), sizeof(row->action), sizeof(row->user_id) };
+
+    const char* start = key;
+    for (int i = 0; i < 3; i++) {
+        const char* end = strchr(start, KEY_SEPARATOR);
+        size_t length = end ? (size_t)(end - start) : strlen(start);
+        if (length >= sizes[i]) {
+            length = sizes[i] - 1;
+        }
+        memcpy(fields[i], start, length);
+        fields[i][length] = '\0';
+        start = end ? end + 1 : start + strlen(start);
+    }
+}
+
+static int compare_summary_rows(const void* a, const void* b) {
+    const SummaryRow* left = (const SummaryRow*)a;
+    const SummaryRow* right = (const SummaryRow*)b;
+    if (left->hour != right->hour) {
+        return left->hour < right->hour ? -1 : 1;
+    }
+    return 0;
+}
+
+// Helper function to write the summary rows of a segment
+static ErrorCode write_summary_file(const LogSegmentInfo* info, const GroupTable* groups, long long record_count) {
+    char path[128];
+    char temp_path[140];
+    summary_path(info, path, sizeof(path));
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    SummaryRow* rows = NULL;
+    if (groups->size > 0) {
+        rows = (SummaryRow*)calloc(groups->size, sizeof(SummaryRow));
+        if (!rows) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    }
+
+    int row_count = 0;
+    for (int i = 0; i < groups->capacity; i++) {
+        const GroupSlot* slot = &groups->slots[i];
+        if (slot->used) {
+            rows[row_count].hour = slot->bucket;
+            unpack_summary_key(slot->key, &rows[row_count]);
+            rows[row_count].count = slot->count;
+            row_count++;
+        }
+    }
+    if (row_count > 0) {
+        qsort(rows, row_count, sizeof(SummaryRow), compare_summary_rows);
+    }
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        free(rows);
+        return ERROR_FILE_OPERATION;
+    }
+
+    SummaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SUMMARY_MAGIC, sizeof(header.magic));
+    header.version = SUMMARY_VERSION;
+    header.record_count = record_count;
+    header.row_count = row_count;
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && row_count > 0) {
+        ok = fwrite(rows, sizeof(SummaryRow), row_count, file) == (size_t)row_count;
+    }
+    fclose(file);
+    free(rows);
+
+    if (!ok) {
+        remove(temp_path);
+        return ERROR_FILE_OPERATION;
+    }
+
+    remove(path);
+    if (rename(temp_path, path) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Function to write the summary of a sealed segment from its records
+ErrorCode log_aggregate_build_summary(const LogSegmentInfo* info) {
+    if (!info || !info->sealed) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    GroupTable groups;
+    ErrorCode result = groups_init(&groups, INITIAL_GROUP_CAPACITY);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    LogSegmentReader reader;
+    result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        groups_free(&groups);
+        return result;
+    }
+    log_segment_reader_set_columns(&reader, COUNTED_COLUMNS);
+
+    DayCache days;
+    memset(&days, 0, sizeof(days));
+
+    const LogEntry* entry;
+    char key[SUMMARY_KEY_LEN];
+    while (result == SUCCESS && (entry = log_segment_reader_next(&reader)) != NULL) {
+        snprintf(key, sizeof(key), "%s%c%s%c%s", entry->module, KEY_SEPARATOR, entry->action,
+                 KEY_SEPARATOR, entry->userID);
+        result = groups_add(&groups, hour_of(&days, entry->timestamp), key, 1);
+    }
+    log_segment_reader_close(&reader);
+
+    if (result == SUCCESS) {
+        pthread_mutex_lock(&summary_lock);
+        result = write_summary_file(info, &groups, info->record_count);
+        pthread_mutex_unlock(&summary_lock);
+    }
+
+    groups_free(&groups);
+    return result;
+}
+
+// Helper function to load the summary rows of a segment.
+// Returns ERROR_DATA_NOT_FOUND when the file is missing or does not describe the segment.
+static ErrorCode load_summary(const LogSegmentInfo* info, SummaryRow** rows, int* row_count) {
+    char path[128];
+    summary_path(info, path, sizeof(path));
+
+    *rows = NULL;
+    *row_count = 0;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    SummaryHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, SUMMARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SUMMARY_VERSION || header.row_count < 0 ||
+        header.record_count != info->record_count) {
+        fclose(file);
+        return ERROR_DATA_NOT_FOUND;
+    }
+    if (header.row_count == 0) {
+        fclose(file);
+        return SUCCESS;
+    }
+
+    SummaryRow* loaded = (SummaryRow*)safe_malloc(header.row_count * sizeof(SummaryRow));
+    if (!loaded) {
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int ok = fread(loaded, sizeof(SummaryRow), header.row_count, file) == (size_t)header.row_count;
+    fclose(file);
+
+    if (!ok) {
+        free(loaded);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    *rows = loaded;
+    *row_count = header.row_count;
+    return SUCCESS;
+}
+
+// Helper function to check whether an hour lies entirely inside the query's
+// range; straddling is set when it lies partly inside
+static int hour_in_range(const LogAggregateQuery* query, time_t hour, int* straddling) {
+    time_t last = hour + SECONDS_PER_HOUR - 1;
+    int after_start = query->start == 0 || hour >= query->start;
+    int before_end = query->end == 0 || last <= query->end;
+    int disjoint = (query->start != 0 && last < query->start) || (query->end != 0 && hour > query->end);
+
+    *straddling = !disjoint && !(after_start && before_end);
+    return !disjoint && after_start && before_end;
+}
+
+// Helper function to count one summary row into its group
+static ErrorCode aggregate_summary_row(Aggregation* aggregation, const SummaryRow* row) {
+    const LogAggregateQuery* query = aggregation->query;
+    if (!field_accepts(query->module, row->module) ||
+        !field_accepts(query->action, row->action) ||
+        !field_accepts(query->user_id, row->user_id)) {
+        return SUCCESS;
+    }
+
+    time_t bucket = 0;
+    const char* key = "";
+    switch (query->group_by) {
+        case LOG_GROUP_MODULE:
+            key = row->module;
+            break;
+        case LOG_GROUP_ACTION:
+            key = row->action;
+            break;
+        case LOG_GROUP_USER:
+            key = row->user_id;
+            break;
+        case LOG_GROUP_HOUR:
+            bucket = row->hour;
+            break;
+        default:
+            day_of(&aggregation->days, row->hour);
+            bucket = aggregation->days.day_start;
+            break;
+    }
+
+    aggregation->total += row->count;
+    return groups_add(&aggregation->groups, bucket, key, row->count);
+}
+
+// Helper function to count a sealed segment from its summary.
+// Returns ERROR_DATA_NOT_FOUND when the summary cannot answer the query exactly.
+static ErrorCode aggregate_segment_summary(Aggregation* aggregation, const LogSegmentInfo* info) {
+    const LogAggregateQuery* query = aggregation->query;
+
+    SummaryRow* rows = NULL;
+    int row_count = 0;
+    ErrorCode result = load_summary(info, &rows, &row_count);
+    if (result == ERROR_DATA_NOT_FOUND) {
+        result = log_aggregate_build_summary(info);
+        if (result == SUCCESS) {
+            result = load_summary(info, &rows, &row_count);
+        }
+    }
+    if (result != SUCCESS) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    // A range bound inside an hour needs the records themselves
+    for (int i = 0; i < row_count; i++) {
+        int straddling;
+        hour_in_range(query, rows[i].hour, &straddling);
+        if (straddling) {
+            free(rows);
+            return ERROR_DATA_NOT_FOUND;
+        }
+    }
+
+    for (int i = 0; i < row_count && result == SUCCESS; i++) {
+        int straddling;
+        if (hour_in_range(query, rows[i].hour, &straddling)) {
+            result = aggregate_summary_row(aggregation, &rows[i]);
+        }
+    }
+
+    free(rows);
+    return result;
+}
+
+// Helper function to build the path of a month's rollup file
+static void rollup_path(int month, char* buffer, size_t buffer_size) {
+    snprintf(buffer, buffer_size, "%s/rollup-%06d.rlp", LOG_STORE_DIR, month);
+}
+
+// Helper function to write a file atomically through a temporary file
+static ErrorCode replace_file(const char* path, const void* header, size_t header_size,
+                              const void* first, size_t first_size, const void* second, size_t second_size) {
+    char temp_path[140];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    int ok = fwrite(header, header_size, 1, file) == 1 &&
+             (first_size == 0 || fwrite(first, first_size, 1, file) == 1) &&
+             (second_size == 0 || fwrite(second, second_size, 1, file) == 1);
+    fclose(file);
+
+    if (!ok) {
+        remove(temp_path);
+        return ERROR_FILE_OPERATION;
+    }
+
+    remove(path);
+    if (rename(temp_path, path) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Helper function to load the list of months that have a rollup file
+static ErrorCode load_rollup_manifest(int** months, int* month_count) {
+    *months = NULL;
+    *month_count = 0;
+
+    FILE* file = fopen(ROLLUP_MANIFEST, "rb");
+    if (!file) {
+        return SUCCESS;  // No rollups yet
+    }
+
+    RollupManifestHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, ROLLUP_MANIFEST_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ROLLUP_VERSION || header.month_count < 0) {
+        fclose(file);
+        log_error(ERROR_FILE_OPERATION, "load_rollup_manifest", "Rollup manifest is corrupted");
+        return ERROR_FILE_OPERATION;
+    }
+    if (header.month_count == 0) {
+        fclose(file);
+        return SUCCESS;
+    }
+
+    int* loaded = (int*)safe_malloc(header.month_count * sizeof(int));
+    if (!loaded) {
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int ok = fread(loaded, sizeof(int), header.month_count, file) == (size_t)header.month_count;
+    fclose(file);
+
+    if (!ok) {
+        free(loaded);
+        log_error(ERROR_FILE_OPERATION, "load_rollup_manifest", "Rollup manifest is truncated");
+        return ERROR_FILE_OPERATION;
+    }
+
+    *months = loaded;
+    *month_count = header.month_count;
+    return SUCCESS;
+}
+
+static ErrorCode write_rollup_manifest(const int* months, int month_count) {
+    RollupManifestHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ROLLUP_MANIFEST_MAGIC, sizeof(header.magic));
+    header.version = ROLLUP_VERSION;
+    header.month_count = month_count;
+
+    return replace_file(ROLLUP_MANIFEST, &header, sizeof(header), months, month_count * sizeof(int), NULL, 0);
+}
+
+static void rollup_free(Rollup* rollup) {
+    free(rollup->directory);
+    free(rollup->rows);
+    memset(rollup, 0, sizeof(Rollup));
+}
+
+// Helper function to load a month's rollup file.
+// Returns ERROR_DATA_NOT_FOUND when the month has no readable rollup.
+static ErrorCode load_rollup(int month, Rollup* rollup) {
+    memset(rollup, 0, sizeof(Rollup));
+
+    char path[128];
+    rollup_path(month, path, sizeof(path));
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    RollupHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, ROLLUP_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ROLLUP_VERSION || header.segment_count <= 0) {
+        fclose(file);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    rollup->directory = (RollupDirEntry*)safe_malloc(header.segment_count * sizeof(RollupDirEntry));
+    if (!rollup->directory) {
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    if (fread(rollup->directory, sizeof(RollupDirEntry), header.segment_count, file) !=
+        (size_t)header.segment_count) {
+        fclose(file);
+        rollup_free(rollup);
+        return ERROR_DATA_NOT_FOUND;
+    }
+    rollup->segment_count = header.segment_count;
+
+    for (int i = 0; i < rollup->segment_count; i++) {
+        const RollupDirEntry* entry = &rollup->directory[i];
+        if (entry->row_count < 0 || entry->first_row != rollup->row_count) {
+            fclose(file);
+            rollup_free(rollup);
+            return ERROR_DATA_NOT_FOUND;
+        }
+        rollup->row_count += entry->row_count;
+    }
+
+    if (rollup->row_count > 0) {
+        rollup->rows = (SummaryRow*)safe_malloc(rollup->row_count * sizeof(SummaryRow));
+        if (!rollup->rows) {
+            fclose(file);
+            rollup_free(rollup);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        if (fread(rollup->rows, sizeof(SummaryRow), rollup->row_count, file) != (size_t)rollup->row_count) {
+            fclose(file);
+            rollup_free(rollup);
+            return ERROR_DATA_NOT_FOUND;
+        }
+    }
+
+    fclose(file);
+    return SUCCESS;
+}
+
+// Helper function to get the YYYYMM local month holding a timestamp
+static int month_of(time_t timestamp) {
+    struct tm local;
+    localtime_r(&timestamp, &local);
+    return (local.tm_year + 1900) * 100 + local.tm_mon + 1;
+}
+
+// Function to keep the hourly summary of a segment about to be dropped. The
+// rows are added to the rollup file of the segment's month; a segment already
+// rolled up is left as it is, so an interrupted retention pass can be repeated.
+ErrorCode log_aggregate_rollup_segment(const LogSegmentInfo* info) {
+    if (!info || !info->sealed) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    SummaryRow* rows = NULL;
+    int row_count = 0;
+    ErrorCode result = load_summary(info, &rows, &row_count);
+    if (result == ERROR_DATA_NOT_FOUND) {
+        result = log_aggregate_build_summary(info);
+        if (result == SUCCESS) {
+            result = load_summary(info, &rows, &row_count);
+        }
+    }
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    int month = month_of(info->partition_start);
+
+    pthread_mutex_lock(&rollup_lock);
+
+    Rollup rollup;
+    result = load_rollup(month, &rollup);
+    if (result == ERROR_DATA_NOT_FOUND) {
+        result = SUCCESS;  // First segment of the month
+    }
+
+    int present = 0;
+    for (int i = 0; result == SUCCESS && i < rollup.segment_count; i++) {
+        present |= rollup.directory[i].segment_id == info->segment_id;
+    }
+
+    if (result == SUCCESS && !present) {
+        RollupDirEntry* directory = (RollupDirEntry*)realloc(rollup.directory,
+                                                             (rollup.segment_count + 1) * sizeof(RollupDirEntry));
+        SummaryRow* all_rows = directory ? (SummaryRow*)realloc(rollup.rows,
+                                                                (rollup.row_count + row_count + 1) * sizeof(SummaryRow))
+                                         : NULL;
+        if (directory) {
+            rollup.directory = directory;
+        }
+        if (all_rows) {
+            rollup.rows = all_rows;
+        }
+
+        if (!directory || !all_rows) {
+            result = ERROR_MEMORY_ALLOCATION;
+        } else {
+            RollupDirEntry* entry = &rollup.directory[rollup.segment_count++];
+            memset(entry, 0, sizeof(RollupDirEntry));
+            entry->segment_id = info->segment_id;
+            entry->row_count = row_count;
+            entry->first_row = rollup.row_count;
+            entry->min_hour = row_count > 0 ? rows[0].hour : 0;
+            entry->max_hour = row_count > 0 ? rows[row_count - 1].hour : 0;
+
+            if (row_count > 0) {
+                memcpy(rollup.rows + rollup.row_count, rows, row_count * sizeof(SummaryRow));
+            }
+            rollup.row_count += row_count;
+
+            RollupHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, ROLLUP_MAGIC, sizeof(header.magic));
+            header.version = ROLLUP_VERSION;
+            header.segment_count = rollup.segment_count;
+
+            char path[128];
+            rollup_path(month, path, sizeof(path));
+            result = replace_file(path, &header, sizeof(header),
+                                  rollup.directory, rollup.segment_count * sizeof(RollupDirEntry),
+                                  rollup.rows, rollup.row_count * sizeof(SummaryRow));
+        }
+    }
+
+    // The month is listed once its file holds the segment
+    int* months = NULL;
+    int month_count = 0;
+    if (result == SUCCESS) {
+        result = load_rollup_manifest(&months, &month_count);
+    }
+    if (result == SUCCESS) {
+        int listed = 0;
+        for (int i = 0; i < month_count; i++) {
+            listed |= months[i] == month;
+        }
+        if (!listed) {
+            int* grown = (int*)realloc(months, (month_count + 1) * sizeof(int));
+            if (!grown) {
+                result = ERROR_MEMORY_ALLOCATION;
+            } else {
+                months = grown;
+                months[month_count++] = month;
+                result = write_rollup_manifest(months, month_count);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&rollup_lock);
+
+    free(months);
+    rollup_free(&rollup);
+    free(rows);
+    return result;
+}
+
+// Function to delete the rollup files whose every hour ends before cutoff
+ErrorCode log_aggregate_expire_rollups(time_t cutoff, int* removed) {
+    if (removed) {
+        *removed = 0;
+    }
+
+    pthread_mutex_lock(&rollup_lock);
+
+    int* months = NULL;
+    int month_count = 0;
+    ErrorCode result = load_rollup_manifest(&months, &month_count);
+
+    int kept = 0;
+    for (int i = 0; result == SUCCESS && i < month_count; i++) {
+        Rollup rollup;
+        ErrorCode loaded = load_rollup(months[i], &rollup);
+        if (loaded == ERROR_MEMORY_ALLOCATION) {
+            result = loaded;
+            months[kept++] = months[i];
+            break;
+        }
+
+        time_t last_hour = 0;
+        for (int j = 0; loaded == SUCCESS && j < rollup.segment_count; j++) {
+            if (rollup.directory[j].max_hour > last_hour) {
+                last_hour = rollup.directory[j].max_hour;
+            }
+        }
+        rollup_free(&rollup);
+
+        if (loaded == SUCCESS && last_hour + SECONDS_PER_HOUR > cutoff) {
+            months[kept++] = months[i];
+            continue;
+        }
+
+        char path[128];
+        rollup_path(months[i], path, sizeof(path));
+        remove(path);
+        if (removed) {
+            (*removed)++;
+        }
+    }
+
+    if (result == SUCCESS && kept != month_count) {
+        result = write_rollup_manifest(months, kept);
+    }
+
+    pthread_mutex_unlock(&rollup_lock);
+
+    free(months);
+    return result;
+}
+
+// Helper function to check whether a segment is still in the store
+static int segment_is_live(const LogSegmentInfo* segments, int segment_count, int segment_id) {
+    for (int i = 0; i < segment_count; i++) {
+        if (segments[i].segment_id == segment_id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Helper function to count the rollups of dropped segments. Rollups resolve to
+// whole hours: an hour overlapping the query's range counts in full.
+static ErrorCode aggregate_rollups(Aggregation* aggregation, const LogSegmentInfo* segments, int segment_count) {
+    const LogAggregateQuery* query = aggregation->query;
+
+    int* months = NULL;
+    int month_count = 0;
+    ErrorCode result = load_rollup_manifest(&months, &month_count);
+
+    for (int i = 0; result == SUCCESS && i < month_count; i++) {
+        Rollup rollup;
+        ErrorCode loaded = load_rollup(months[i], &rollup);
+        if (loaded != SUCCESS) {
+            if (loaded == ERROR_MEMORY_ALLOCATION) {
+                result = loaded;
+            }
+            continue;  // Expired meanwhile
+        }
+
+        for (int j = 0; result == SUCCESS && j < rollup.segment_count; j++) {
+            const RollupDirEntry* entry = &rollup.directory[j];
+
+            // A segment rolled up but not yet dropped is counted from the store
+            if (entry->row_count == 0 || segment_is_live(segments, segment_count, entry->segment_id) ||
+                (query->start != 0 && entry->max_hour + SECONDS_PER_HOUR <= query->start) ||
+                (query->end != 0 && entry->min_hour > query->end)) {
+                continue;
+            }
+
+            for (int k = 0; result == SUCCESS && k < entry->row_count; k++) {
+                const SummaryRow* row = &rollup.rows[entry->first_row + k];
+                if ((query->start != 0 && row->hour + SECONDS_PER_HOUR <= query->start) ||
+                    (query->end != 0 && row->hour > query->end)) {
+                    continue;
+                }
+                result = aggregate_summary_row(aggregation, row);
+            }
+        }
+
+        rollup_free(&rollup);
+    }
+
+    free(months);
+    return result;
+}
+
+// Helper function to check the segment filters that rule a segment out
+static int segment_may_match(const LogAggregateQuery* query, const LogSegmentInfo* info) {
+    int may_contain = 1;
+    if (query->user_id && query->user_id[0] &&
+        log_bloom_check(info, LOG_POSTING_USER, query->user_id, &may_contain) == SUCCESS && !may_contain) {
+        return 0;
+    }
+    if (query->module && query->module[0] &&
+        log_bloom_check(info, LOG_POSTING_MODULE, query->module, &may_contain) == SUCCESS && !may_contain) {
+        return 0;
+    }
+    return 1;
+}
+
+static int compare_rows(const void* a, const void* b) {
+    const LogAggregateRow* left = (const LogAggregateRow*)a;
+    const LogAggregateRow* right = (const LogAggregateRow*)b;
+    if (left->bucket != right->bucket) {
+        return left->bucket < right->bucket ? -1 : 1;
+    }
+    if (left->count != right->count) {
+        return left->count > right->count ? -1 : 1;
+    }
+    return strcmp(left->key, right->key);
+}
+
+// Function to count the records matching a query, grouped as requested
+ErrorCode log_aggregate(const LogAggregateQuery* query, LogAggregateResult* result) {
+    if (!query || !result || query->group_by < LOG_GROUP_MODULE || query->group_by > LOG_GROUP_CUSTOM ||
+        (query->group_by == LOG_GROUP_CUSTOM && !query->key_function) ||
+        (query->start != 0 && query->end != 0 && query->start > query->end)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(result, 0, sizeof(LogAggregateResult));
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode status = log_store_list_segments(0, 0, &segments, &segment_count);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    Aggregation aggregation;
+    memset(&aggregation, 0, sizeof(aggregation));
+    aggregation.query = query;
+    status = groups_init(&aggregation.groups, INITIAL_GROUP_CAPACITY);
+    if (status != SUCCESS) {
+        safe_free((void**)&segments);
+        return status;
+    }
+
+    // Summaries only know the indexed fields of each record
+    int summaries_usable = !query->predicate && query->group_by != LOG_GROUP_CUSTOM;
+
+    for (int i = 0; i < segment_count && status == SUCCESS; i++) {
+        const LogSegmentInfo* info = &segments[i];
+        if (info->record_count == 0 ||
+            (query->start != 0 && info->max_timestamp < query->start) ||
+            (query->end != 0 && info->min_timestamp > query->end) ||
+            !segment_may_match(query, info)) {
+            continue;
+        }
+
+        status = ERROR_DATA_NOT_FOUND;
+        if (summaries_usable && info->sealed) {
+            status = aggregate_segment_summary(&aggregation, info);
+        }
+        if (status == ERROR_DATA_NOT_FOUND) {
+            status = aggregate_segment_records(&aggregation, info);
+        }
+    }
+
+    // Dropped segments survive as hourly rollups
+    if (status == SUCCESS && summaries_usable) {
+        status = aggregate_rollups(&aggregation, segments, segment_count);
+    }
+    safe_free((void**)&segments);
+
+    if (status == SUCCESS && aggregation.groups.size > 0) {
+        result->rows = (LogAggregateRow*)safe_malloc(aggregation.groups.size * sizeof(LogAggregateRow));
+        if (!result->rows) {
+            status = ERROR_MEMORY_ALLOCATION;
+        }
+    }
+
+    if (status == SUCCESS) {
+        for (int i = 0; i < aggregation.groups.capacity && aggregation.groups.size > 0; i++) {
+            const GroupSlot* slot = &aggregation.groups.slots[i];
+            if (slot->used) {
+                LogAggregateRow* row = &result->rows[result->count++];
+                row->bucket = slot->bucket;
+                safe_strcpy(row->key, slot->key, sizeof(row->key));
+                row->count = slot->count;
+            }
+        }
+        if (result->count > 1) {
+            qsort(result->rows, result->count, sizeof(LogAggregateRow), compare_rows);
+        }
+        result->total = aggregation.total;
+    }
+
+    groups_free(&aggregation.groups);
+    return status;
+}
+
+// Function to release a result table
+void log_aggregate_free(LogAggregateResult* result) {
+    if (!result) {
+        return;
+    }
+    safe_free((void**)&result->rows);
+    result->count = 0;
+    result->total = 0;
+}
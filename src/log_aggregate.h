@@ -0,0 +1,72 @@
+#ifndef LOG_AGGREGATE_H
+#define LOG_AGGREGATE_H
+
+#include "data_structures.h"
+#include "log_store.h"
+#include "log_query.h"
+#include <time.h>
+
+// Aggregation queries over the audit log: record counts grouped by module,
+// action, user, local hour or local day, computed without materializing
+// entries. Sealed segments are answered from a per-segment summary
+// (seg-*.sum: counts per hour, module, action and user) written when the
+// segment is compacted, or built on first use; the active segment, and any
+// segment a summary cannot answer exactly, is counted in one streaming pass.
+// Memory grows with the number of groups, never with the number of records.
+//
+// When retention drops a segment its summary is kept in a monthly rollup file
+// (rollup-YYYYMM.rlp, listed in ROLLUPS). Queries without a predicate or
+// custom key include rollups, at hour resolution.
+#define LOG_AGGREGATE_KEY_LEN 64
+
+typedef enum {
+    LOG_GROUP_MODULE = 0,
+    LOG_GROUP_ACTION = 1,
+    LOG_GROUP_USER = 2,
+    LOG_GROUP_HOUR = 3,
+    LOG_GROUP_DAY = 4,
+    LOG_GROUP_CUSTOM = 5        // Key chosen by key_function
+} LogGroupBy;
+
+// Key function for LOG_GROUP_CUSTOM: writes the group of a record into key
+// and returns non-zero, or returns 0 to leave the record uncounted
+typedef int (*LogGroupKey)(const LogEntry* entry, char* key, size_t key_size, void* context);
+
+typedef struct {
+    LogGroupBy group_by;
+    time_t start;               // 0 leaves a bound open
+    time_t end;
+    const char* module;         // NULL or empty matches any
+    const char* action;
+    const char* user_id;
+    LogPredicate predicate;     // Extra filter; forces a streaming pass
+    LogGroupKey key_function;
+    void* context;              // Passed to predicate and key_function
+} LogAggregateQuery;
+
+typedef struct {
+    time_t bucket;                      // Start of the hour or day; 0 for other groupings
+    char key[LOG_AGGREGATE_KEY_LEN];    // Group value; empty for hour and day groupings
+    long long count;
+} LogAggregateRow;
+
+// Result table: time groupings in bucket order, others by descending count
+typedef struct {
+    LogAggregateRow* rows;
+    int count;
+    long long total;            // Records counted
+} LogAggregateResult;
+
+// Running a query; the result is freed with log_aggregate_free
+ErrorCode log_aggregate(const LogAggregateQuery* query, LogAggregateResult* result);
+void log_aggregate_free(LogAggregateResult* result);
+
+// Writing the summary of a sealed segment
+ErrorCode log_aggregate_build_summary(const LogSegmentInfo* info);
+
+// Rollups: keeping a segment's summary before it is dropped, and deleting
+// the rollup files whose every hour ends before cutoff
+ErrorCode log_aggregate_rollup_segment(const LogSegmentInfo* info);
+ErrorCode log_aggregate_expire_rollups(time_t cutoff, int* removed);
+
+#endif // LOG_AGGREGATE_H
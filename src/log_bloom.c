@@ -0,0 +1,290 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_bloom.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define BLOOM_MAGIC "LBLM"
+#define BLOOM_VERSION 1
+#define BLOOM_MIN_BITS 64
+#define BLOOM_MAX_BITS (1u << 30)
+
+// Filter file header, followed by bit_count / 64 words
+typedef struct {
+    char magic[4];
+    int version;
+    long long record_count;   // Records of the segment the filter describes
+    int key_count;
+    uint32_t bit_count;
+    int hash_count;
+    int reserved;
+} BloomHeader;
+
+// Cached filter of one sealed segment
+typedef struct {
+    int used;
+    int segment_id;
+    time_t partition_start;
+    long long record_count;
+    LogBloomFilter filter;
+} BloomCacheEntry;
+
+// Global variables for the filter cache
+static BloomCacheEntry bloom_cache[LOG_BLOOM_CACHE_SIZE];
+static int next_victim = 0;
+static pthread_rwlock_t cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+// Helper function to hash a (kind, key) pair: 64-bit FNV-1a with a final mix
+// so both halves are usable for double hashing
+static uint64_t hash_key(int kind, const char* key) {
+    uint64_t hash = 14695981039346656037ull ^ (uint64_t)(unsigned int)kind;
+    for (const char* p = key; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Function to allocate an empty filter sized for key_count keys
+ErrorCode log_bloom_init(LogBloomFilter* filter, int key_count) {
+    if (!filter || key_count < 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    uint64_t wanted = (uint64_t)key_count * LOG_BLOOM_BITS_PER_KEY;
+    uint32_t bit_count = BLOOM_MIN_BITS;
+    while (bit_count < wanted && bit_count < BLOOM_MAX_BITS) {
+        bit_count <<= 1;
+    }
+
+    filter->words = (uint64_t*)calloc(bit_count / 64, sizeof(uint64_t));
+    if (!filter->words) {
+        log_error(ERROR_MEMORY_ALLOCATION, "log_bloom_init", "Failed to allocate Bloom filter");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    filter->bit_count = bit_count;
+    filter->hash_count = LOG_BLOOM_HASH_COUNT;
+    filter->key_count = key_count;
+    return SUCCESS;
+}
+
+// Function to add a key to a filter
+void log_bloom_add(LogBloomFilter* filter, int kind, const char* key) {
+    uint64_t hash = hash_key(kind, key);
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+    uint32_t mask = filter->bit_count - 1;
+
+    for (int i = 0; i < filter->hash_count; i++) {
+        uint32_t bit = (h1 + (uint32_t)i * h2) & mask;
+        filter->words[bit / 64] |= 1ull << (bit % 64);
+    }
+}
+
+// Function to test a key: 0 means it was never added, 1 that it may have been
+int log_bloom_test(const LogBloomFilter* filter, int kind, const char* key) {
+    uint64_t hash = hash_key(kind, key);
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+    uint32_t mask = filter->bit_count - 1;
+
+    for (int i = 0; i < filter->hash_count; i++) {
+        uint32_t bit = (h1 + (uint32_t)i * h2) & mask;
+        if (!(filter->words[bit / 64] & (1ull << (bit % 64)))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void log_bloom_free(LogBloomFilter* filter) {
+    if (!filter) {
+        return;
+    }
+    free(filter->words);
+    memset(filter, 0, sizeof(LogBloomFilter));
+}
+
+// Helper function to build the filter path for a segment: seg-*.dat -> seg-*.blm
+static void bloom_path(const LogSegmentInfo* info, char* buffer, size_t buffer_size) {
+    log_store_segment_path(info, buffer, buffer_size);
+
+    char* extension = strrchr(buffer, '.');
+    if (extension && strlen(extension) == 4) {
+        strcpy(extension, ".blm");
+    } else {
+        safe_strcat(buffer, ".blm", buffer_size);
+    }
+}
+
+// Function to write a segment's filter file
+ErrorCode log_bloom_write(const LogSegmentInfo* info, const LogBloomFilter* filter, long long record_count) {
+    if (!info || !filter || !filter->words) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    char path[128];
+    char temp_path[140];
+    bloom_path(info, path, sizeof(path));
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    BloomHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BLOOM_MAGIC, sizeof(header.magic));
+    header.version = BLOOM_VERSION;
+    header.record_count = record_count;
+    header.key_count = filter->key_count;
+    header.bit_count = filter->bit_count;
+    header.hash_count = filter->hash_count;
+
+    size_t word_count = filter->bit_count / 64;
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(filter->words, sizeof(uint64_t), word_count, file) == word_count;
+    fclose(file);
+
+    if (!ok) {
+        remove(temp_path);
+        return ERROR_FILE_OPERATION;
+    }
+
+    remove(path);
+    if (rename(temp_path, path) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Helper function to load a segment's filter file.
+// Returns ERROR_DATA_NOT_FOUND when the file is missing or does not describe the segment.
+static ErrorCode load_filter(const LogSegmentInfo* info, LogBloomFilter* filter) {
+    char path[128];
+    bloom_path(info, path, sizeof(path));
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    BloomHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, BLOOM_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BLOOM_VERSION || header.record_count != info->record_count ||
+        header.bit_count < BLOOM_MIN_BITS || header.bit_count > BLOOM_MAX_BITS ||
+        (header.bit_count & (header.bit_count - 1)) != 0 ||
+        header.hash_count <= 0 || header.hash_count > 32) {
+        fclose(file);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    size_t word_count = header.bit_count / 64;
+    uint64_t* words = (uint64_t*)safe_malloc(word_count * sizeof(uint64_t));
+    if (!words) {
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int ok = fread(words, sizeof(uint64_t), word_count, file) == word_count;
+    fclose(file);
+
+    if (!ok) {
+        free(words);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    filter->words = words;
+    filter->bit_count = header.bit_count;
+    filter->hash_count = header.hash_count;
+    filter->key_count = header.key_count;
+    return SUCCESS;
+}
+
+// Helper function to find a segment's cached filter; caller holds cache_lock
+static BloomCacheEntry* find_cached_locked(const LogSegmentInfo* info) {
+    for (int i = 0; i < LOG_BLOOM_CACHE_SIZE; i++) {
+        BloomCacheEntry* entry = &bloom_cache[i];
+        if (entry->used && entry->segment_id == info->segment_id &&
+            entry->partition_start == info->partition_start && entry->record_count == info->record_count) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Function to check whether a sealed segment may hold a record whose field equals key
+ErrorCode log_bloom_check(const LogSegmentInfo* info, int kind, const char* key, int* may_contain) {
+    if (!info || !key || !may_contain) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    *may_contain = 1;
+    if (!info->sealed) {
+        return ERROR_DATA_NOT_FOUND;  // Only sealed segments have filters
+    }
+
+    pthread_rwlock_rdlock(&cache_lock);
+    BloomCacheEntry* cached = find_cached_locked(info);
+    if (cached) {
+        *may_contain = log_bloom_test(&cached->filter, kind, key);
+        pthread_rwlock_unlock(&cache_lock);
+        return SUCCESS;
+    }
+    pthread_rwlock_unlock(&cache_lock);
+
+    LogBloomFilter filter;
+    ErrorCode result = load_filter(info, &filter);
+    if (result != SUCCESS) {
+        return result;
+    }
+    *may_contain = log_bloom_test(&filter, kind, key);
+
+    pthread_rwlock_wrlock(&cache_lock);
+    if (find_cached_locked(info)) {
+        log_bloom_free(&filter);  // Another thread loaded it meanwhile
+    } else {
+        BloomCacheEntry* entry = NULL;
+        for (int i = 0; i < LOG_BLOOM_CACHE_SIZE && !entry; i++) {
+            if (!bloom_cache[i].used) {
+                entry = &bloom_cache[i];
+            }
+        }
+        if (!entry) {
+            entry = &bloom_cache[next_victim];
+            next_victim = (next_victim + 1) % LOG_BLOOM_CACHE_SIZE;
+            log_bloom_free(&entry->filter);
+        }
+
+        entry->used = 1;
+        entry->segment_id = info->segment_id;
+        entry->partition_start = info->partition_start;
+        entry->record_count = info->record_count;
+        entry->filter = filter;
+    }
+    pthread_rwlock_unlock(&cache_lock);
+
+    return SUCCESS;
+}
+
+// Function to drop every cached filter
+void log_bloom_cache_clear() {
+    pthread_rwlock_wrlock(&cache_lock);
+    for (int i = 0; i < LOG_BLOOM_CACHE_SIZE; i++) {
+        if (bloom_cache[i].used) {
+            log_bloom_free(&bloom_cache[i].filter);
+            bloom_cache[i].used = 0;
+        }
+    }
+    next_victim = 0;
+    pthread_rwlock_unlock(&cache_lock);
+}
@@ -0,0 +1,40 @@
+#ifndef LOG_BLOOM_H
+#define LOG_BLOOM_H
+
+#include "data_structures.h"
+#include "log_store.h"
+#include <stdint.h>
+
+// Bloom filter over the userIDs and modules of a sealed segment (seg-*.blm),
+// written alongside its postings index when the segment is sealed. Lookups
+// consult it before opening any other file of the segment: a negative answer
+// is exact, so a user who never touched a segment skips it entirely.
+// Filters are small and cached in memory once loaded.
+#define LOG_BLOOM_BITS_PER_KEY 10     // About 1% false positives
+#define LOG_BLOOM_HASH_COUNT 7
+#define LOG_BLOOM_CACHE_SIZE 256
+
+typedef struct {
+    uint64_t* words;
+    uint32_t bit_count;               // Power of two
+    int hash_count;
+    int key_count;
+} LogBloomFilter;
+
+// Building: sized for the number of distinct keys it will hold
+ErrorCode log_bloom_init(LogBloomFilter* filter, int key_count);
+void log_bloom_add(LogBloomFilter* filter, int kind, const char* key);
+int log_bloom_test(const LogBloomFilter* filter, int kind, const char* key);
+void log_bloom_free(LogBloomFilter* filter);
+
+// Filter files
+ErrorCode log_bloom_write(const LogSegmentInfo* info, const LogBloomFilter* filter, long long record_count);
+
+// Lookup: whether a sealed segment may hold a record whose field equals key.
+// Returns ERROR_DATA_NOT_FOUND when the segment has no usable filter.
+ErrorCode log_bloom_check(const LogSegmentInfo* info, int kind, const char* key, int* may_contain);
+
+// Dropping every cached filter
+void log_bloom_cache_clear();
+
+#endif // LOG_BLOOM_H
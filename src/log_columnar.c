@@ -0,0 +1,422 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_columnar.h"
+#include "lz_codec.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Upper bound of one record's share of a decompressed column chunk: the
+// field bytes plus a varint length or code per field
+#define RECORD_MAX_ENCODED_SIZE (sizeof(LogEntry) + 64)
+
+// Upper bound of one decompressed column chunk
+#define CHUNK_CAPACITY(block_records) ((size_t)(block_records) * RECORD_MAX_ENCODED_SIZE)
+
+// Function to derive the columnar file name from a raw segment name
+void log_columnar_file_name(const char* raw_name, char* buffer, size_t buffer_size) {
+    if (!raw_name || !buffer || buffer_size == 0) {
+        return;
+    }
+
+    safe_strcpy(buffer, raw_name, buffer_size);
+
+    char* extension = strrchr(buffer, '.');
+    if (extension && strlen(extension) == 4) {
+        strcpy(extension, ".col");
+    } else {
+        safe_strcat(buffer, ".col", buffer_size);
+    }
+}
+
+// Helper function to locate the string field of a column within a record
+static char* column_field(LogEntry* entry, LogColumn column, size_t* size) {
+    switch (column) {
+        case LOG_COLUMN_MODULE:
+            *size = sizeof(entry->module);
+            return entry->module;
+        case LOG_COLUMN_ACTION:
+            *size = sizeof(entry->action);
+            return entry->action;
+        case LOG_COLUMN_USER:
+            *size = sizeof(entry->userID);
+            return entry->userID;
+        case LOG_COLUMN_LOG_ID:
+            *size = sizeof(entry->logID);
+            return entry->logID;
+        case LOG_COLUMN_DETAILS:
+            *size = sizeof(entry->details);
+            return entry->details;
+        default:
+            *size = 0;
+            return NULL;
+    }
+}
+
+// Helper function to get the length of a fixed-size field, which may lack a terminator
+static size_t field_length(const char* field, size_t size) {
+    size_t length = 0;
+    while (length < size - 1 && field[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+// Helper function to encode one column of a block; returns the size or 0
+static size_t encode_column(LogSegmentReader* reader, const LogColumnarBlock* block, LogColumn column,
+                            LogDictionary* dictionary, unsigned char* out) {
+    unsigned char* p = out;
+    time_t previous = 0;
+    char value[MAX_DETAILS_LEN];
+
+    for (int i = 0; i < block->record_count; i++) {
+        const LogEntry* entry = log_segment_reader_read_at(reader, block->first_record + i);
+        if (!entry) {
+            return 0;
+        }
+
+        if (column == LOG_COLUMN_TIMESTAMP) {
+            long long delta = (long long)entry->timestamp - (long long)previous;
+            p = log_varint_put(p, ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63));
+            previous = entry->timestamp;
+            continue;
+        }
+
+        size_t size;
+        const char* field = column_field((LogEntry*)entry, column, &size);
+        size_t length = field_length(field, size);
+
+        if (column == LOG_COLUMN_LOG_ID || column == LOG_COLUMN_DETAILS) {
+            p = log_varint_put(p, length);
+            memcpy(p, field, length);
+            p += length;
+        } else {
+            memcpy(value, field, length);
+            value[length] = '\0';
+            int code = log_dictionary_intern(dictionary, value);
+            if (code < 0) {
+                return 0;
+            }
+            p = log_varint_put(p, (unsigned long long)code);
+        }
+    }
+
+    return (size_t)(p - out);
+}
+
+// Function to archive a sealed segment column by column. Each column is
+// encoded in its own pass over the segment, so columns are written whole
+// and in order without buffering the others.
+ErrorCode log_columnar_write(const LogSegmentInfo* info, const char* path) {
+    if (!info || !path || info->format == LOG_SEGMENT_COLUMNAR) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    LogSegmentReader reader;
+    ErrorCode result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    long long record_count = reader.record_count;
+    int block_count = (int)((record_count + LOG_COLUMNAR_BLOCK_RECORDS - 1) / LOG_COLUMNAR_BLOCK_RECORDS);
+
+    size_t encoded_capacity = CHUNK_CAPACITY(LOG_COLUMNAR_BLOCK_RECORDS);
+    size_t capacity = lz_compress_bound(encoded_capacity);
+    unsigned char* encoded = (unsigned char*)safe_malloc(encoded_capacity);
+    unsigned char* compressed = (unsigned char*)safe_malloc(capacity);
+    LogColumnarBlock* blocks = NULL;
+    if (block_count > 0) {
+        blocks = (LogColumnarBlock*)calloc(block_count, sizeof(LogColumnarBlock));
+    }
+
+    LogDictionary dictionary;
+    int have_dictionary = 0;
+    if (encoded && compressed && (block_count == 0 || blocks)) {
+        have_dictionary = log_dictionary_init(&dictionary) == SUCCESS;
+    }
+
+    FILE* file = have_dictionary ? fopen(path, "wb") : NULL;
+    if (!file) {
+        if (have_dictionary) {
+            log_dictionary_free(&dictionary);
+        }
+        safe_free((void**)&encoded);
+        safe_free((void**)&compressed);
+        free(blocks);
+        log_segment_reader_close(&reader);
+        return have_dictionary ? ERROR_FILE_OPERATION : ERROR_MEMORY_ALLOCATION;
+    }
+
+    LogColumnarHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_COLUMNAR_MAGIC, sizeof(header.magic));
+    header.version = LOG_COLUMNAR_VERSION;
+    header.block_records = LOG_COLUMNAR_BLOCK_RECORDS;
+    header.block_count = block_count;
+    header.record_count = record_count;
+
+    // Record ranges and timestamp bounds of the blocks
+    for (int i = 0; i < block_count; i++) {
+        long long first = (long long)i * LOG_COLUMNAR_BLOCK_RECORDS;
+        blocks[i].first_record = first;
+        blocks[i].record_count = record_count - first < LOG_COLUMNAR_BLOCK_RECORDS ? (int)(record_count - first)
+                                                                                    : LOG_COLUMNAR_BLOCK_RECORDS;
+        for (int j = 0; j < blocks[i].record_count; j++) {
+            const LogEntry* entry = log_segment_reader_read_at(&reader, first + j);
+            if (!entry) {
+                break;
+            }
+            if (j == 0 || entry->timestamp < blocks[i].min_timestamp) {
+                blocks[i].min_timestamp = entry->timestamp;
+            }
+            if (j == 0 || entry->timestamp > blocks[i].max_timestamp) {
+                blocks[i].max_timestamp = entry->timestamp;
+            }
+        }
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    long long offset = (long long)sizeof(header);
+
+    for (int column = 0; ok && column < LOG_COLUMN_COUNT; column++) {
+        for (int i = 0; ok && i < block_count; i++) {
+            size_t encoded_size = encode_column(&reader, &blocks[i], (LogColumn)column, &dictionary, encoded);
+            size_t size = encoded_size > 0 ? lz_compress(encoded, encoded_size, compressed, capacity) : 0;
+            ok = size > 0 && fwrite(compressed, 1, size, file) == size;
+
+            blocks[i].offset[column] = offset;
+            blocks[i].size[column] = (int)size;
+            header.column_bytes[column] += (long long)size;
+            offset += (long long)size;
+        }
+    }
+
+    // Keep the index aligned so it can be read in place from a mapping
+    static const char padding[8] = {0};
+    size_t pad = (size_t)((8 - offset % 8) % 8);
+    if (ok && pad > 0) {
+        ok = fwrite(padding, 1, pad, file) == pad;
+        offset += (long long)pad;
+    }
+
+    header.index_offset = offset;
+    if (ok && block_count > 0) {
+        ok = fwrite(blocks, sizeof(LogColumnarBlock), block_count, file) == (size_t)block_count;
+        offset += (long long)block_count * (long long)sizeof(LogColumnarBlock);
+    }
+
+    header.dictionary_offset = offset;
+    if (ok) {
+        ok = log_dictionary_write(&dictionary, file, &header.dictionary_count) == SUCCESS;
+    }
+    if (ok) {
+        long end = ftell(file);
+        ok = end >= 0;
+        header.dictionary_size = (int)(end - header.dictionary_offset);
+    }
+
+    if (ok) {
+        ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+    if (ok) {
+        ok = fflush(file) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fdatasync(fileno(file)) == 0;
+#endif
+    }
+
+    fclose(file);
+    log_dictionary_free(&dictionary);
+    safe_free((void**)&encoded);
+    safe_free((void**)&compressed);
+    free(blocks);
+    log_segment_reader_close(&reader);
+
+    if (!ok) {
+        remove(path);
+        log_error(ERROR_FILE_OPERATION, "log_columnar_write", "Could not write columnar segment");
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Function to validate a mapped columnar segment and load its dictionary
+ErrorCode log_columnar_open(const MappedFile* map, LogColumnarSegment* segment) {
+    if (!map || !segment) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(segment, 0, sizeof(LogColumnarSegment));
+
+    if (!map->data || map->size < sizeof(LogColumnarHeader)) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    const LogColumnarHeader* header = (const LogColumnarHeader*)map->data;
+    if (memcmp(header->magic, LOG_COLUMNAR_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != LOG_COLUMNAR_VERSION ||
+        header->block_records <= 0 || header->block_count < 0 ||
+        header->index_offset < (long long)sizeof(LogColumnarHeader) ||
+        header->index_offset % 8 != 0 ||
+        (unsigned long long)header->index_offset +
+            (unsigned long long)header->block_count * sizeof(LogColumnarBlock) > map->size ||
+        header->dictionary_offset < 0 || header->dictionary_size < 0 || header->dictionary_count < 0 ||
+        (unsigned long long)header->dictionary_offset + (unsigned long long)header->dictionary_size > map->size) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    segment->map = *map;
+    segment->block_records = header->block_records;
+    segment->block_count = header->block_count;
+    segment->record_count = header->record_count;
+    segment->blocks = (const LogColumnarBlock*)((const char*)map->data + header->index_offset);
+    segment->column_bytes = header->column_bytes;
+
+    ErrorCode result = log_dictionary_init(&segment->dictionary);
+    if (result == SUCCESS) {
+        result = log_dictionary_read(&segment->dictionary,
+                                     (const unsigned char*)map->data + header->dictionary_offset,
+                                     (size_t)header->dictionary_size, header->dictionary_count);
+        if (result != SUCCESS) {
+            log_dictionary_free(&segment->dictionary);
+        }
+    }
+    if (result == SUCCESS) {
+        segment->scratch = (unsigned char*)safe_malloc(CHUNK_CAPACITY(segment->block_records));
+        if (!segment->scratch) {
+            log_dictionary_free(&segment->dictionary);
+            result = ERROR_MEMORY_ALLOCATION;
+        }
+    }
+
+    if (result != SUCCESS) {
+        memset(segment, 0, sizeof(LogColumnarSegment));
+    }
+    return result;
+}
+
+// Helper function to decompress and decode one column chunk of a block
+static int decode_column(LogColumnarSegment* segment, const LogColumnarBlock* block, LogColumn column,
+                         LogEntry* records) {
+    const MappedFile* map = &segment->map;
+    if (block->offset[column] < 0 || block->size[column] <= 0 ||
+        (unsigned long long)block->offset[column] + (unsigned long long)block->size[column] > map->size) {
+        return 0;
+    }
+
+    const unsigned char* source = (const unsigned char*)map->data + block->offset[column];
+    size_t size = lz_decompress(source, (size_t)block->size[column], segment->scratch,
+                                CHUNK_CAPACITY(segment->block_records));
+    if (size == (size_t)-1) {
+        return 0;
+    }
+    segment->bytes_read += block->size[column];
+
+    const unsigned char* cursor = segment->scratch;
+    const unsigned char* end = segment->scratch + size;
+    time_t previous = 0;
+
+    for (int i = 0; i < block->record_count; i++) {
+        unsigned long long value;
+        if (!log_varint_get(&cursor, end, &value)) {
+            return 0;
+        }
+
+        if (column == LOG_COLUMN_TIMESTAMP) {
+            long long delta = (long long)(value >> 1) ^ -(long long)(value & 1);
+            records[i].timestamp = (time_t)((long long)previous + delta);
+            previous = records[i].timestamp;
+            continue;
+        }
+
+        size_t field_size;
+        char* field = column_field(&records[i], column, &field_size);
+
+        if (column == LOG_COLUMN_LOG_ID || column == LOG_COLUMN_DETAILS) {
+            if (value >= field_size || value > (unsigned long long)(end - cursor)) {
+                return 0;
+            }
+            memcpy(field, cursor, (size_t)value);
+            memset(field + value, 0, field_size - (size_t)value);
+            cursor += value;
+        } else {
+            if (value >= (unsigned long long)segment->dictionary.count) {
+                return 0;
+            }
+            const char* string = segment->dictionary.strings[value];
+            size_t length = strlen(string);
+            if (length >= field_size) {
+                return 0;
+            }
+            memcpy(field, string, length);
+            memset(field + length, 0, field_size - length);
+        }
+    }
+
+    return cursor == end;
+}
+
+// Function to decode the requested columns of one block
+ErrorCode log_columnar_read_block(LogColumnarSegment* segment, int block_index, unsigned int columns,
+                                  LogEntry* records) {
+    if (!segment || !segment->map.data || !records || block_index < 0 || block_index >= segment->block_count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    const LogColumnarBlock* block = &segment->blocks[block_index];
+    if (block->record_count <= 0 || block->record_count > segment->block_records) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    int ok = 1;
+    for (int column = 0; ok && column < LOG_COLUMN_COUNT; column++) {
+        if (columns & LOG_COLUMN_BIT(column)) {
+            ok = decode_column(segment, block, (LogColumn)column, records);
+            continue;
+        }
+
+        // Columns not read are left empty rather than holding another block's values
+        for (int i = 0; i < block->record_count; i++) {
+            size_t field_size;
+            char* field = column_field(&records[i], (LogColumn)column, &field_size);
+            if (field) {
+                field[0] = '\0';
+            } else {
+                records[i].timestamp = 0;
+            }
+        }
+    }
+
+    if (!ok) {
+        log_error(ERROR_FILE_OPERATION, "log_columnar_read_block", "Corrupt columnar log block");
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Function to release a columnar segment's dictionary and scratch space
+void log_columnar_close(LogColumnarSegment* segment) {
+    if (!segment) {
+        return;
+    }
+
+    if (segment->scratch) {
+        log_dictionary_free(&segment->dictionary);
+    }
+    safe_free((void**)&segment->scratch);
+    memset(&segment->map, 0, sizeof(segment->map));
+    segment->blocks = NULL;
+    segment->column_bytes = NULL;
+}
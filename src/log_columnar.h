@@ -0,0 +1,100 @@
+#ifndef LOG_COLUMNAR_H
+#define LOG_COLUMNAR_H
+
+#include "data_structures.h"
+#include "log_store.h"
+#include "mapped_file.h"
+#include "log_dictionary.h"
+#include <stddef.h>
+
+// Columnar archive format for sealed log segments (seg-*.col). Each field of
+// LogEntry is stored as its own column, so a query reads only the columns
+// it touches:
+//
+//   timestamp  zigzag varint deltas, restarting at each block
+//   module     varint codes into the segment dictionary
+//   action     varint codes
+//   user       varint codes
+//   log_id     length-prefixed strings
+//   details    length-prefixed strings
+//
+// A column is cut into blocks of LOG_COLUMNAR_BLOCK_RECORDS records, each
+// compressed on its own with lz_codec. All blocks of a column are stored
+// together, so the unread columns of a scan are never paged in. The block
+// index gives every block's record range, timestamp bounds and the offset
+// and size of each of its column chunks. The dictionary (log_dictionary.h)
+// follows the index.
+//
+// Layout: header | timestamp chunks | module chunks | ... | details chunks | block index | dictionary
+
+#define LOG_COLUMNAR_MAGIC "LGCL"
+#define LOG_COLUMNAR_VERSION 1
+#define LOG_COLUMNAR_BLOCK_RECORDS 1024
+
+typedef enum {
+    LOG_COLUMN_TIMESTAMP = 0,
+    LOG_COLUMN_MODULE = 1,
+    LOG_COLUMN_ACTION = 2,
+    LOG_COLUMN_USER = 3,
+    LOG_COLUMN_LOG_ID = 4,
+    LOG_COLUMN_DETAILS = 5,
+    LOG_COLUMN_COUNT = 6
+} LogColumn;
+
+// Column sets are bit masks of LogColumn values
+#define LOG_COLUMN_BIT(column) (1u << (column))
+#define LOG_COLUMNS_ALL ((1u << LOG_COLUMN_COUNT) - 1)
+
+typedef struct {
+    char magic[4];
+    int version;
+    int block_records;       // Records per block; only the last block may hold fewer
+    int block_count;
+    long long record_count;
+    long long index_offset;  // File offset of the block index
+    long long dictionary_offset;
+    int dictionary_count;    // Strings after the dictionary seeds
+    int dictionary_size;     // Bytes
+    long long column_bytes[LOG_COLUMN_COUNT];  // Compressed size of each whole column
+} LogColumnarHeader;
+
+typedef struct {
+    long long first_record;  // Record index of the block's first record
+    int record_count;
+    int reserved;
+    time_t min_timestamp;
+    time_t max_timestamp;
+    long long offset[LOG_COLUMN_COUNT];  // File offset of each column chunk
+    int size[LOG_COLUMN_COUNT];          // Compressed size of each column chunk
+} LogColumnarBlock;
+
+// Path of a segment's columnar file: seg-*.dat -> seg-*.col
+void log_columnar_file_name(const char* raw_name, char* buffer, size_t buffer_size);
+
+// Archive a sealed segment of any other format into a new file at path
+ErrorCode log_columnar_write(const LogSegmentInfo* info, const char* path);
+
+// Open columnar segment: header and block index are read in place from the mapping
+typedef struct LogColumnarSegment {
+    MappedFile map;             // Borrowed copy of the caller's mapping
+    int block_records;
+    int block_count;
+    long long record_count;
+    const LogColumnarBlock* blocks;
+    const long long* column_bytes;
+    LogDictionary dictionary;
+    unsigned char* scratch;     // One decompressed column chunk
+    long long bytes_read;       // Compressed bytes decoded so far
+} LogColumnarSegment;
+
+// Validate a mapped columnar file and load its dictionary
+ErrorCode log_columnar_open(const MappedFile* map, LogColumnarSegment* segment);
+
+// Decode the given columns of one block into records, which holds at least
+// block_records entries. Fields of other columns are left empty.
+ErrorCode log_columnar_read_block(LogColumnarSegment* segment, int block_index, unsigned int columns,
+                                  LogEntry* records);
+
+void log_columnar_close(LogColumnarSegment* segment);
+
+#endif // LOG_COLUMNAR_H
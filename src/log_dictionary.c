@@ -0,0 +1,215 @@
+#include "log_dictionary.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Well-known values with fixed codes. Append only: codes are stored on disk.
+static const char* const dictionary_seeds[] = {
+    "", "SYSTEM",
+    "Auth", "Student", "Officer", "Payment", "Main",
+    "Create", "Retrieve", "Update", "Delete", "List", "Search",
+    "Login", "Login Failed", "Logout", "Password Change", "Create User",
+    "Calculate Total", "Initialize", "Shutdown"
+};
+
+#define DICTIONARY_SEED_COUNT ((int)(sizeof(dictionary_seeds) / sizeof(dictionary_seeds[0])))
+
+// Helper function to hash a string with FNV-1a
+static unsigned int hash_string(const char* value) {
+    unsigned int hash = 2166136261u;
+    for (const char* p = value; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Helper function to find the slot holding value, or the empty slot for it
+static int* dictionary_slot(const LogDictionary* dictionary, const char* value) {
+    unsigned int mask = (unsigned int)dictionary->slot_capacity - 1;
+    unsigned int index = hash_string(value) & mask;
+    while (dictionary->slots[index] != 0 &&
+           strcmp(dictionary->strings[dictionary->slots[index] - 1], value) != 0) {
+        index = (index + 1) & mask;
+    }
+    return &dictionary->slots[index];
+}
+
+static ErrorCode dictionary_grow_slots(LogDictionary* dictionary) {
+    int new_capacity = dictionary->slot_capacity > 0 ? dictionary->slot_capacity * 2 : 64;
+    int* slots = (int*)calloc(new_capacity, sizeof(int));
+    if (!slots) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    free(dictionary->slots);
+    dictionary->slots = slots;
+    dictionary->slot_capacity = new_capacity;
+
+    for (int code = 0; code < dictionary->count; code++) {
+        *dictionary_slot(dictionary, dictionary->strings[code]) = code + 1;
+    }
+    return SUCCESS;
+}
+
+// Function to create a dictionary holding the seed values
+ErrorCode log_dictionary_init(LogDictionary* dictionary) {
+    if (!dictionary) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(dictionary, 0, sizeof(LogDictionary));
+    for (int i = 0; i < DICTIONARY_SEED_COUNT; i++) {
+        if (log_dictionary_intern(dictionary, dictionary_seeds[i]) != i) {
+            log_dictionary_free(dictionary);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    return SUCCESS;
+}
+
+void log_dictionary_free(LogDictionary* dictionary) {
+    if (!dictionary) {
+        return;
+    }
+
+    for (int i = 0; i < dictionary->count; i++) {
+        free(dictionary->strings[i]);
+    }
+    free(dictionary->strings);
+    free(dictionary->slots);
+    memset(dictionary, 0, sizeof(LogDictionary));
+}
+
+// Function to get the code of a value, adding it when new; returns -1 on failure
+int log_dictionary_intern(LogDictionary* dictionary, const char* value) {
+    if (!dictionary || !value) {
+        return -1;
+    }
+
+    if ((dictionary->count + 1) * 2 > dictionary->slot_capacity &&
+        dictionary_grow_slots(dictionary) != SUCCESS) {
+        return -1;
+    }
+
+    int* slot = dictionary_slot(dictionary, value);
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    if (dictionary->count == dictionary->capacity) {
+        int new_capacity = dictionary->capacity > 0 ? dictionary->capacity * 2 : 32;
+        char** strings = (char**)realloc(dictionary->strings, new_capacity * sizeof(char*));
+        if (!strings) {
+            return -1;
+        }
+        dictionary->strings = strings;
+        dictionary->capacity = new_capacity;
+    }
+
+    size_t length = strlen(value);
+    char* copy = (char*)malloc(length + 1);
+    if (!copy) {
+        return -1;
+    }
+    memcpy(copy, value, length + 1);
+
+    dictionary->strings[dictionary->count] = copy;
+    *slot = ++dictionary->count;
+    return dictionary->count - 1;
+}
+
+const char* log_dictionary_lookup(const LogDictionary* dictionary, int code) {
+    if (!dictionary || code < 0 || code >= dictionary->count) {
+        return NULL;
+    }
+    return dictionary->strings[code];
+}
+
+int log_dictionary_seed_count() {
+    return DICTIONARY_SEED_COUNT;
+}
+
+// Function to append an unsigned LEB128 varint
+unsigned char* log_varint_put(unsigned char* out, unsigned long long value) {
+    while (value >= 0x80) {
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    return out;
+}
+
+// Function to read a varint; returns 0 on truncated or overlong input
+int log_varint_get(const unsigned char** cursor, const unsigned char* end, unsigned long long* value) {
+    unsigned long long result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*cursor >= end) {
+            return 0;
+        }
+        unsigned char byte = *(*cursor)++;
+        result |= (unsigned long long)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Helper function to read a length-prefixed string into a fixed-size field
+static int get_string(const unsigned char** cursor, const unsigned char* end, char* field, size_t size) {
+    unsigned long long length;
+    if (!log_varint_get(cursor, end, &length) || length >= size || length > (unsigned long long)(end - *cursor)) {
+        return 0;
+    }
+    memcpy(field, *cursor, (size_t)length);
+    field[length] = '\0';
+    *cursor += length;
+    return 1;
+}
+
+// Function to write the non-seed strings of a dictionary
+ErrorCode log_dictionary_write(const LogDictionary* dictionary, FILE* file, int* written) {
+    if (!dictionary || !file) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    unsigned char prefix[10];
+    for (int code = DICTIONARY_SEED_COUNT; code < dictionary->count; code++) {
+        size_t length = strlen(dictionary->strings[code]);
+        size_t prefix_size = (size_t)(log_varint_put(prefix, length) - prefix);
+        if (fwrite(prefix, 1, prefix_size, file) != prefix_size ||
+            fwrite(dictionary->strings[code], 1, length, file) != length) {
+            return ERROR_FILE_OPERATION;
+        }
+    }
+
+    if (written) {
+        *written = dictionary->count - DICTIONARY_SEED_COUNT;
+    }
+    return SUCCESS;
+}
+
+// Function to append count serialized strings to a seeded dictionary
+ErrorCode log_dictionary_read(LogDictionary* dictionary, const unsigned char* data, size_t size, int count) {
+    if (!dictionary || (!data && count > 0)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    const unsigned char* cursor = data;
+    const unsigned char* end = data + size;
+    char value[MAX_DETAILS_LEN];
+
+    for (int i = 0; i < count; i++) {
+        if (!get_string(&cursor, end, value, sizeof(value))) {
+            return ERROR_FILE_OPERATION;
+        }
+        // Codes are positional, so every string must be new
+        int expected = dictionary->count;
+        if (log_dictionary_intern(dictionary, value) != expected) {
+            return ERROR_FILE_OPERATION;
+        }
+    }
+    return SUCCESS;
+}
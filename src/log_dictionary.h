@@ -0,0 +1,36 @@
+#ifndef LOG_DICTIONARY_H
+#define LOG_DICTIONARY_H
+
+#include "data_structures.h"
+#include <stdio.h>
+
+// String dictionary and varints used by the columnar segment format
+// (log_columnar.h). The dictionary is seeded with well-known module and
+// action names so their codes are fixed; values first seen in a file are
+// appended after the seeds.
+
+// Interned strings addressed by code
+typedef struct {
+    char** strings;
+    int count;
+    int capacity;
+    int* slots;          // Open-addressing table of code + 1; 0 is empty
+    int slot_capacity;
+} LogDictionary;
+
+// Dictionary
+ErrorCode log_dictionary_init(LogDictionary* dictionary);
+void log_dictionary_free(LogDictionary* dictionary);
+int log_dictionary_intern(LogDictionary* dictionary, const char* value);
+const char* log_dictionary_lookup(const LogDictionary* dictionary, int code);
+int log_dictionary_seed_count();
+
+// Serialized dictionary: the strings appended after the seeds
+ErrorCode log_dictionary_write(const LogDictionary* dictionary, FILE* file, int* written);
+ErrorCode log_dictionary_read(LogDictionary* dictionary, const unsigned char* data, size_t size, int count);
+
+// Unsigned LEB128 varints; get returns 0 on truncated or overlong input
+unsigned char* log_varint_put(unsigned char* out, unsigned long long value);
+int log_varint_get(const unsigned char** cursor, const unsigned char* end, unsigned long long* value);
+
+#endif // LOG_DICTIONARY_H
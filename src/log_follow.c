@@ -0,0 +1,246 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_follow.h"
+#include "log_store.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+#define FOLLOW_WATCH_TIMEOUT_MS 100   // Safety net between inotify events, and stop flag latency
+#define FOLLOW_POLL_INTERVAL_MS 5     // Without inotify
+
+// Wakeup source for new records
+typedef struct {
+    int fd;   // inotify descriptor, or -1 to poll
+} FollowWatch;
+
+// Helper function to start watching the store directory
+static void watch_open(FollowWatch* watch) {
+    watch->fd = -1;
+#ifdef __linux__
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    if (inotify_add_watch(fd, LOG_STORE_DIR, IN_MODIFY | IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE) < 0) {
+        close(fd);
+        return;
+    }
+    watch->fd = fd;
+#endif
+}
+
+// Helper function to sleep for milliseconds
+static void sleep_ms(long ms) {
+    struct timespec delay = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&delay, NULL);
+}
+
+// Helper function to wait until the store directory changes or the timeout passes
+static void watch_wait(FollowWatch* watch) {
+#ifdef __linux__
+    if (watch->fd >= 0) {
+        struct pollfd descriptor = { watch->fd, POLLIN, 0 };
+        if (poll(&descriptor, 1, FOLLOW_WATCH_TIMEOUT_MS) > 0) {
+            // The events only mean "look again"; drain them all
+            char events[4096];
+            while (read(watch->fd, events, sizeof(events)) > 0) {
+            }
+        }
+        return;
+    }
+#endif
+    sleep_ms(FOLLOW_POLL_INTERVAL_MS);
+}
+
+// Helper function to stop watching
+static void watch_close(FollowWatch* watch) {
+#ifdef __linux__
+    if (watch->fd >= 0) {
+        close(watch->fd);
+    }
+#endif
+    watch->fd = -1;
+}
+
+// Function to read a saved offset
+ErrorCode log_follow_load_offset(const char* path, long long* offset) {
+    if (!path || !offset) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    long long value;
+    int parsed = fscanf(file, "%lld", &value);
+    fclose(file);
+
+    if (parsed != 1 || value < 0) {
+        return ERROR_FILE_OPERATION;
+    }
+    *offset = value;
+    return SUCCESS;
+}
+
+// Function to save an offset; the file is replaced atomically
+ErrorCode log_follow_save_offset(const char* path, long long offset) {
+    if (!path || offset < 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    char temp_path[256];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    FILE* file = fopen(temp_path, "w");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    int written = fprintf(file, "%lld\n", offset);
+    if (fclose(file) != 0 || written <= 0 || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return ERROR_FILE_OPERATION;
+    }
+    return SUCCESS;
+}
+
+// Function to get the offset one past the newest record
+long long log_follow_end_offset() {
+    LogSegmentInfo* segments = NULL;
+    int count = 0;
+    if (log_store_read_manifest(&segments, &count) != SUCCESS || count == 0) {
+        return 0;
+    }
+
+    long long end = 0;
+    for (int i = 0; i < count; i++) {
+        long long segment_end = segments[i].base_sequence + segments[i].record_count;
+        if (segment_end > end) {
+            end = segment_end;
+        }
+    }
+    safe_free((void**)&segments);
+    return end;
+}
+
+// Helper function to check a record against the follower's filters
+static int follow_matches(const LogEntry* entry, const LogFollowOptions* options) {
+    if (!options) {
+        return 1;
+    }
+    if (options->user_id && options->user_id[0] != '\0' && strcmp(entry->userID, options->user_id) != 0) {
+        return 0;
+    }
+    if (options->module && options->module[0] != '\0' && strcmp(entry->module, options->module) != 0) {
+        return 0;
+    }
+    return 1;
+}
+
+// Helper function to hand every flushed record at or past *offset to the
+// callback, advancing *offset; returns 1 when the callback asked to stop.
+// The manifest is re-read on every wakeup, so rotation and compaction by a
+// writer in another process are picked up.
+static int deliver_new_records(long long* offset, LogFollowCallback callback, void* context,
+                               const LogFollowOptions* options) {
+    LogSegmentInfo* segments = NULL;
+    int count = 0;
+    if (log_store_read_manifest(&segments, &count) != SUCCESS) {
+        return 0;
+    }
+
+    int stopped = 0;
+    for (int i = 0; i < count && !stopped; i++) {
+        const LogSegmentInfo* info = &segments[i];
+        if (info->base_sequence + info->record_count <= *offset) {
+            continue;  // Already delivered; never reopened
+        }
+
+        // Records before the oldest remaining segment are gone
+        if (*offset < info->base_sequence) {
+            *offset = info->base_sequence;
+        }
+
+        LogSegmentReader reader;
+        if (log_segment_reader_open(info, &reader) != SUCCESS) {
+            break;  // Retried on the next wakeup
+        }
+        log_segment_reader_seek(&reader, *offset - info->base_sequence);
+
+        const LogEntry* entry;
+        while (!stopped && (entry = log_segment_reader_next(&reader)) != NULL) {
+            long long record_offset = (*offset)++;
+            if (follow_matches(entry, options) && callback(entry, record_offset, context) != 0) {
+                stopped = 1;
+            }
+        }
+
+        // A segment the writer has not fully flushed ends the round
+        long long reached = reader.next_index;
+        log_segment_reader_close(&reader);
+        if (!stopped && reached < info->record_count) {
+            break;
+        }
+    }
+
+    safe_free((void**)&segments);
+    return stopped;
+}
+
+// Function to follow the audit log
+ErrorCode log_follow(long long from_offset, LogFollowCallback callback, void* context,
+                     const LogFollowOptions* options) {
+    if (!callback || from_offset < LOG_FOLLOW_RESUME) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    const char* offset_path = options ? options->offset_path : NULL;
+    atomic_int* stop = options ? options->stop : NULL;
+
+    long long offset = from_offset;
+    if (offset == LOG_FOLLOW_RESUME) {
+        if (!offset_path || log_follow_load_offset(offset_path, &offset) != SUCCESS) {
+            offset = LOG_FOLLOW_FROM_END;
+        }
+    }
+    if (offset == LOG_FOLLOW_FROM_END) {
+        offset = log_follow_end_offset();
+    }
+
+    FollowWatch watch;
+    watch_open(&watch);
+
+    long long saved = -1;
+    for (;;) {
+        int stopped = deliver_new_records(&offset, callback, context, options);
+
+        if (offset_path && offset != saved) {
+            if (log_follow_save_offset(offset_path, offset) != SUCCESS) {
+                log_error(ERROR_FILE_OPERATION, "log_follow", "Could not save follow offset");
+            }
+            saved = offset;
+        }
+
+        if (stopped || (stop && atomic_load(stop))) {
+            break;
+        }
+        watch_wait(&watch);
+        if (stop && atomic_load(stop)) {
+            break;
+        }
+    }
+
+    watch_close(&watch);
+    return SUCCESS;
+}
@@ -0,0 +1,44 @@
+#ifndef LOG_FOLLOW_H
+#define LOG_FOLLOW_H
+
+#include "data_structures.h"
+#include <stdatomic.h>
+
+// Live tail of the binary audit log. Offsets are global record sequences
+// (LogSegmentInfo.base_sequence plus the index within the segment), so a
+// follower can stop, persist its offset and later resume exactly where it
+// left off, across segment rotation and compaction. Wakeups come from
+// inotify on the store directory, with a short polling interval where
+// inotify is unavailable; each wakeup reads only records past the offset.
+//
+// The follower never opens the store: it reads data/logs/MANIFEST and the
+// segment files, so it works inside the logging process (the log menu) or in
+// a separate one. It sees records once the writer flushes them to the file.
+
+#define LOG_FOLLOW_FROM_END (-1LL)   // Only records appended after the call
+#define LOG_FOLLOW_RESUME (-2LL)     // The offset saved in offset_path, else the end
+#define LOG_FOLLOW_DEFAULT_OFFSET_FILE "data/follow.offset"
+
+typedef struct {
+    const char* offset_path;  // Optional: the offset is saved here after each delivery
+    const char* user_id;      // Optional filters, matching get_logs_by_user/get_logs_by_module
+    const char* module;
+    atomic_int* stop;         // Optional: log_follow returns once this is set
+} LogFollowOptions;
+
+// Called for every matching record with its offset; return non-zero to stop following
+typedef int (*LogFollowCallback)(const LogEntry* entry, long long offset, void* context);
+
+// Function to stream records from from_offset on, waiting for new ones until
+// the callback or the stop flag ends it. options may be NULL.
+ErrorCode log_follow(long long from_offset, LogFollowCallback callback, void* context,
+                     const LogFollowOptions* options);
+
+// Offset persistence
+ErrorCode log_follow_load_offset(const char* path, long long* offset);
+ErrorCode log_follow_save_offset(const char* path, long long offset);
+
+// Offset one past the newest record in the store
+long long log_follow_end_offset();
+
+#endif // LOG_FOLLOW_H
@@ -0,0 +1,254 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_mpsc.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+
+#define CONSUMER_IDLE_WAIT_MS 100
+#define WAIT_SPIN_ROUNDS 64
+
+// Helper function to wait on a condition variable for at most ms milliseconds
+static void timed_wait(pthread_cond_t* condition, pthread_mutex_t* lock, long ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += ms / 1000;
+    deadline.tv_nsec += (ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(condition, lock, &deadline);
+}
+
+// Function to open the queue for producers
+ErrorCode log_mpsc_open(LogMpscQueue* queue, long long capacity, LogBackpressure backpressure) {
+    if (!queue || capacity <= 0 || backpressure == LOG_BACKPRESSURE_DROP_OLDEST) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (!queue->primitives_ready) {
+        if (pthread_mutex_init(&queue->wait_lock, NULL) != 0 ||
+            pthread_cond_init(&queue->wake_consumer, NULL) != 0 ||
+            pthread_cond_init(&queue->progress, NULL) != 0) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        atomic_store(&queue->stub.next, NULL);
+        atomic_store(&queue->head, &queue->stub);
+        queue->tail = &queue->stub;
+        queue->primitives_ready = 1;
+    }
+
+    queue->capacity = capacity;
+    queue->backpressure = backpressure;
+    atomic_store(&queue->published, 0);
+    atomic_store(&queue->dropped, 0);
+    atomic_store(&queue->closed, 0);
+    return SUCCESS;
+}
+
+// Function to stop accepting batches; returns once no producer is mid-publish
+void log_mpsc_close(LogMpscQueue* queue) {
+    if (!queue || !queue->primitives_ready) {
+        return;
+    }
+
+    atomic_store(&queue->closed, 1);
+    while (atomic_load(&queue->producers) > 0) {
+        sched_yield();
+    }
+
+    // Wake everyone so they observe the close
+    pthread_mutex_lock(&queue->wait_lock);
+    pthread_cond_broadcast(&queue->wake_consumer);
+    pthread_cond_broadcast(&queue->progress);
+    pthread_mutex_unlock(&queue->wait_lock);
+}
+
+// Function to allocate an empty batch
+LogMpscBatch* log_mpsc_batch_new() {
+    LogMpscBatch* batch = (LogMpscBatch*)safe_malloc(sizeof(LogMpscBatch));
+    if (batch) {
+        atomic_store(&batch->next, NULL);
+        batch->count = 0;
+        batch->done = NULL;
+    }
+    return batch;
+}
+
+// Helper function to link a batch at the head of the queue (Vyukov MPSC push)
+static void push_batch(LogMpscQueue* queue, LogMpscBatch* batch) {
+    atomic_store_explicit(&batch->next, NULL, memory_order_relaxed);
+    LogMpscBatch* previous = atomic_exchange_explicit(&queue->head, batch, memory_order_acq_rel);
+    atomic_store_explicit(&previous->next, batch, memory_order_release);
+}
+
+// Helper function to get the backlog at which blocked producers resume
+static long long low_watermark(const LogMpscQueue* queue) {
+    return queue->capacity / 2;
+}
+
+// Helper function to let a sleeping thread know about progress
+static void wake(LogMpscQueue* queue, pthread_cond_t* condition) {
+    pthread_mutex_lock(&queue->wait_lock);
+    pthread_cond_broadcast(condition);
+    pthread_mutex_unlock(&queue->wait_lock);
+}
+
+// Function to publish a batch; the queue takes ownership of it.
+// Returns ERROR_FILE_OPERATION without taking ownership when the queue is closed.
+ErrorCode log_mpsc_publish(LogMpscQueue* queue, LogMpscBatch* batch) {
+    if (!queue || !batch) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    atomic_fetch_add(&queue->producers, 1);
+    if (atomic_load(&queue->closed)) {
+        atomic_fetch_sub(&queue->producers, 1);
+        return ERROR_FILE_OPERATION;
+    }
+
+    // Backpressure; the check and the reservation are separate, so concurrent
+    // producers may overshoot the capacity by a few batches
+    if (batch->count > 0 && atomic_load(&queue->pending) + batch->count > queue->capacity) {
+        if (queue->backpressure != LOG_BACKPRESSURE_BLOCK) {
+            atomic_fetch_add(&queue->dropped, (unsigned long long)batch->count);
+            atomic_fetch_sub(&queue->producers, 1);
+            if (batch->done) {
+                atomic_store(batch->done, 1);
+            }
+            free(batch);
+            return SUCCESS;
+        }
+
+        // Resume once the consumer has drained to the low watermark, so a
+        // full queue wakes blocked producers once instead of per batch
+        pthread_mutex_lock(&queue->wait_lock);
+        atomic_fetch_add(&queue->blocked, 1);
+        while (atomic_load(&queue->pending) + batch->count > low_watermark(queue) &&
+               atomic_load(&queue->pending) > 0 && !atomic_load(&queue->closed)) {
+            timed_wait(&queue->progress, &queue->wait_lock, CONSUMER_IDLE_WAIT_MS);
+        }
+        atomic_fetch_sub(&queue->blocked, 1);
+        pthread_mutex_unlock(&queue->wait_lock);
+    }
+
+    atomic_fetch_add(&queue->pending, batch->count);
+    atomic_fetch_add(&queue->published, (unsigned long long)batch->count);
+    push_batch(queue, batch);
+
+    if (atomic_load(&queue->consumer_sleeping)) {
+        wake(queue, &queue->wake_consumer);
+    }
+
+    atomic_fetch_sub(&queue->producers, 1);
+    return SUCCESS;
+}
+
+// Function to wait until the consumer sets a batch's done flag
+void log_mpsc_wait_done(LogMpscQueue* queue, atomic_int* done) {
+    if (!queue || !done) {
+        return;
+    }
+
+    for (int i = 0; i < WAIT_SPIN_ROUNDS; i++) {
+        if (atomic_load(done)) {
+            return;
+        }
+        sched_yield();
+    }
+
+    pthread_mutex_lock(&queue->wait_lock);
+    atomic_fetch_add(&queue->waiters, 1);
+    while (!atomic_load(done)) {
+        timed_wait(&queue->progress, &queue->wait_lock, CONSUMER_IDLE_WAIT_MS);
+    }
+    atomic_fetch_sub(&queue->waiters, 1);
+    pthread_mutex_unlock(&queue->wait_lock);
+}
+
+// Helper function to check for published batches the consumer has not taken
+static int queue_empty(LogMpscQueue* queue) {
+    return queue->tail == &queue->stub &&
+           atomic_load(&queue->stub.next) == NULL &&
+           atomic_load(&queue->head) == &queue->stub;
+}
+
+// Function to take the oldest published batch (Vyukov MPSC pop); returns NULL
+// when the queue is empty or the next batch is still being linked
+LogMpscBatch* log_mpsc_pop(LogMpscQueue* queue) {
+    LogMpscBatch* tail = queue->tail;
+    LogMpscBatch* next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    if (tail == &queue->stub) {
+        if (!next) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != atomic_load_explicit(&queue->head, memory_order_acquire)) {
+        return NULL;  // A producer is between its exchange and its link
+    }
+
+    // tail is the only batch: put the stub behind it so it can be taken
+    push_batch(queue, &queue->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+// Function to sleep until batches are published; returns 0 once the queue
+// is closed and fully drained
+int log_mpsc_wait(LogMpscQueue* queue) {
+    atomic_store(&queue->consumer_sleeping, 1);
+
+    int result = 1;
+    if (queue_empty(queue)) {
+        if (atomic_load(&queue->closed) && atomic_load(&queue->producers) == 0) {
+            result = 0;
+        } else {
+            pthread_mutex_lock(&queue->wait_lock);
+            if (queue_empty(queue) && !atomic_load(&queue->closed)) {
+                timed_wait(&queue->wake_consumer, &queue->wait_lock, CONSUMER_IDLE_WAIT_MS);
+            }
+            pthread_mutex_unlock(&queue->wait_lock);
+        }
+    } else {
+        sched_yield();  // A producer is mid-publish; let it finish linking
+    }
+
+    atomic_store(&queue->consumer_sleeping, 0);
+    return result;
+}
+
+// Function to retire a written batch, releasing anyone waiting on it
+void log_mpsc_complete(LogMpscQueue* queue, LogMpscBatch* batch) {
+    if (!queue || !batch) {
+        return;
+    }
+
+    long long pending = atomic_fetch_sub(&queue->pending, batch->count) - batch->count;
+    int waited_on = batch->done != NULL;
+    if (batch->done) {
+        atomic_store(batch->done, 1);
+    }
+    free(batch);
+
+    if ((waited_on && atomic_load(&queue->waiters) > 0) ||
+        (atomic_load(&queue->blocked) > 0 && pending <= low_watermark(queue))) {
+        wake(queue, &queue->progress);
+    }
+}
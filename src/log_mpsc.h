@@ -0,0 +1,64 @@
+#ifndef LOG_MPSC_H
+#define LOG_MPSC_H
+
+#include "data_structures.h"
+#include "log_queue.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Lock-free multi-producer, single-consumer ingestion queue. Producers fill
+// a batch privately (a per-thread staging buffer) and publish it with one
+// atomic exchange onto an intrusive linked queue; the single consumer takes
+// batches off the other end without locking. The mutex and condition
+// variables below are only touched on slow paths: an idle consumer going to
+// sleep, producers blocked by backpressure, and callers waiting for a batch
+// to be written.
+
+#define LOG_MPSC_BATCH_RECORDS 32
+
+typedef struct LogMpscBatch {
+    struct LogMpscBatch* _Atomic next;
+    int count;
+    atomic_int* done;     // Set to 1 once the batch is written, when not NULL
+    QueuedLog records[LOG_MPSC_BATCH_RECORDS];
+} LogMpscBatch;
+
+typedef struct {
+    LogMpscBatch* _Atomic head;   // Most recently published batch
+    LogMpscBatch* tail;           // Consumer position
+    LogMpscBatch stub;
+
+    LogBackpressure backpressure; // BLOCK or DROP_NEWEST; published batches are immutable
+    long long capacity;           // Soft bound on records published but not yet written
+    atomic_llong pending;
+    atomic_ullong published;      // Records accepted
+    atomic_ullong dropped;        // Records lost to backpressure
+
+    atomic_int closed;
+    atomic_int producers;         // Producers inside log_mpsc_publish
+    atomic_int consumer_sleeping;
+    atomic_int waiters;           // Threads sleeping until a batch is written
+    atomic_int blocked;           // Producers sleeping on backpressure
+
+    pthread_mutex_t wait_lock;
+    pthread_cond_t wake_consumer;
+    pthread_cond_t progress;
+    int primitives_ready;
+} LogMpscQueue;
+
+// Lifecycle; a closed queue can be opened again, but is never reinitialized
+// while producers may still reach it. DROP_OLDEST is rejected.
+ErrorCode log_mpsc_open(LogMpscQueue* queue, long long capacity, LogBackpressure backpressure);
+void log_mpsc_close(LogMpscQueue* queue);
+
+// Producers
+LogMpscBatch* log_mpsc_batch_new();
+ErrorCode log_mpsc_publish(LogMpscQueue* queue, LogMpscBatch* batch);
+void log_mpsc_wait_done(LogMpscQueue* queue, atomic_int* done);
+
+// Consumer
+LogMpscBatch* log_mpsc_pop(LogMpscQueue* queue);
+int log_mpsc_wait(LogMpscQueue* queue);
+void log_mpsc_complete(LogMpscQueue* queue, LogMpscBatch* batch);
+
+#endif // LOG_MPSC_H
@@ -0,0 +1,965 @@
+#include "log_postings.h"
+#include "log_bloom.h"
+#include "field_match.h"
+#include "log_columnar.h"
+#include "file_io.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define INV_MAGIC "LINV"
+#define INV_VERSION 2
+#define INITIAL_TABLE_CAPACITY 64
+
+// Sealed index file header
+typedef struct {
+    char magic[4];
+    int version;
+    long long record_count;   // Records of the segment the index describes
+    int key_count;
+    int reserved;
+} InvHeader;
+
+// Sealed index directory entry; postings are stored as int64_t record indexes
+typedef struct {
+    int kind;
+    char key[MAX_ID_LEN];
+    int count;
+    long long offset;         // Position of the first posting in the postings area
+} InvDirEntry;
+
+// In-memory posting list for one key
+typedef struct {
+    int used;
+    int kind;
+    char key[MAX_ID_LEN];
+    long long* records;
+    int count;
+    int capacity;
+} PostingList;
+
+// Open-addressing hash table of posting lists
+typedef struct {
+    PostingList* slots;
+    int capacity;
+    int size;
+} PostingTable;
+
+// Global variables for the active segment's postings
+static PostingTable active_table;
+static FILE* active_log = NULL;
+static int active_segment_id = -1;
+static long long active_records = 0;
+static pthread_mutex_t postings_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Postings of a segment sealed by the store whose index files are not written
+// yet. has_table is 0 when the active postings did not cover the segment and
+// the index must be rebuilt from its records.
+typedef struct PendingSeal {
+    LogSegmentInfo info;
+    PostingTable table;
+    int has_table;
+    struct PendingSeal* next;
+} PendingSeal;
+
+// Oldest first; linked under postings_lock, unlinked only under build_lock
+static PendingSeal* pending_seals = NULL;
+
+// Serializes writes and on-demand rebuilds of sealed indexes. Rebuilds read a
+// whole segment and never hold postings_lock, which the append path takes.
+static pthread_mutex_t build_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Helper function to hash a (kind, key) pair with FNV-1a
+static unsigned int hash_key(int kind, const char* key) {
+    unsigned int hash = 2166136261u ^ (unsigned int)kind;
+    for (const char* p = key; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ErrorCode table_init(PostingTable* table, int capacity) {
+    table->slots = (PostingList*)calloc(capacity, sizeof(PostingList));
+    if (!table->slots) {
+        log_error(ERROR_MEMORY_ALLOCATION, "table_init", "Failed to allocate posting table");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    table->capacity = capacity;
+    table->size = 0;
+    return SUCCESS;
+}
+
+static void table_free(PostingTable* table) {
+    if (!table->slots) {
+        return;
+    }
+    for (int i = 0; i < table->capacity; i++) {
+        free(table->slots[i].records);
+    }
+    free(table->slots);
+    table->slots = NULL;
+    table->capacity = 0;
+    table->size = 0;
+}
+
+// Helper function to find the slot for a key, or the empty slot where it belongs
+static PostingList* table_slot(PostingTable* table, int kind, const char* key) {
+    unsigned int mask = (unsigned int)table->capacity - 1;
+    unsigned int index = hash_key(kind, key) & mask;
+    while (table->slots[index].used &&
+           (table->slots[index].kind != kind || strcmp(table->slots[index].key, key) != 0)) {
+        index = (index + 1) & mask;
+    }
+    return &table->slots[index];
+}
+
+static ErrorCode table_grow(PostingTable* table) {
+    PostingTable grown;
+    ErrorCode result = table_init(&grown, table->capacity * 2);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    for (int i = 0; i < table->capacity; i++) {
+        if (table->slots[i].used) {
+            *table_slot(&grown, table->slots[i].kind, table->slots[i].key) = table->slots[i];
+            grown.size++;
+        }
+    }
+
+    free(table->slots);
+    *table = grown;
+    return SUCCESS;
+}
+
+static ErrorCode table_add(PostingTable* table, int kind, const char* key, long long record_index) {
+    if (table->size * 2 >= table->capacity) {
+        ErrorCode result = table_grow(table);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+
+    PostingList* list = table_slot(table, kind, key);
+    if (!list->used) {
+        list->used = 1;
+        list->kind = kind;
+        safe_strcpy(list->key, key, sizeof(list->key));
+        table->size++;
+    }
+
+    if (list->count == list->capacity) {
+        int new_capacity = list->capacity > 0 ? list->capacity * 2 : 8;
+        long long* grown = (long long*)realloc(list->records, new_capacity * sizeof(long long));
+        if (!grown) {
+            log_error(ERROR_MEMORY_ALLOCATION, "table_add", "Failed to grow posting list");
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        list->records = grown;
+        list->capacity = new_capacity;
+    }
+
+    list->records[list->count++] = record_index;
+    return SUCCESS;
+}
+
+// Helper function to index both keys of one record
+static ErrorCode table_add_record(PostingTable* table, long long record_index,
+                                  const char* user_id, const char* module) {
+    ErrorCode result = table_add(table, LOG_POSTING_USER, user_id, record_index);
+    if (result == SUCCESS) {
+        result = table_add(table, LOG_POSTING_MODULE, module, record_index);
+    }
+    return result;
+}
+
+// Helper function to build an index file path for a segment with the given extension
+static void postings_path(const LogSegmentInfo* info, const char* extension, char* buffer, size_t buffer_size) {
+    log_store_segment_path(info, buffer, buffer_size);
+
+    char* dot = strrchr(buffer, '.');
+    if (dot && strlen(dot) == 4) {
+        strcpy(dot, extension);
+    } else {
+        safe_strcat(buffer, extension, buffer_size);
+    }
+}
+
+static int compare_dir_entries(const void* a, const void* b) {
+    const InvDirEntry* left = (const InvDirEntry*)a;
+    const InvDirEntry* right = (const InvDirEntry*)b;
+    if (left->kind != right->kind) {
+        return left->kind - right->kind;
+    }
+    return strcmp(left->key, right->key);
+}
+
+// Helper function to write a sealed index from a posting table
+static ErrorCode write_inv_file(const LogSegmentInfo* info, const PostingTable* table, long long record_count) {
+    char path[128];
+    char temp_path[140];
+    postings_path(info, ".inv", path, sizeof(path));
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    InvDirEntry* directory = NULL;
+    if (table->size > 0) {
+        directory = (InvDirEntry*)calloc(table->size, sizeof(InvDirEntry));
+        if (!directory) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    }
+
+    int key_count = 0;
+    for (int i = 0; i < table->capacity; i++) {
+        const PostingList* list = &table->slots[i];
+        if (list->used) {
+            directory[key_count].kind = list->kind;
+            safe_strcpy(directory[key_count].key, list->key, sizeof(directory[key_count].key));
+            directory[key_count].count = list->count;
+            key_count++;
+        }
+    }
+    if (key_count > 0) {
+        qsort(directory, key_count, sizeof(InvDirEntry), compare_dir_entries);
+    }
+
+    long long offset = 0;
+    for (int i = 0; i < key_count; i++) {
+        directory[i].offset = offset;
+        offset += directory[i].count;
+    }
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        free(directory);
+        return ERROR_FILE_OPERATION;
+    }
+
+    InvHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INV_MAGIC, sizeof(header.magic));
+    header.version = INV_VERSION;
+    header.record_count = record_count;
+    header.key_count = key_count;
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && key_count > 0) {
+        ok = fwrite(directory, sizeof(InvDirEntry), key_count, file) == (size_t)key_count;
+    }
+
+    for (int i = 0; ok && i < key_count; i++) {
+        const PostingList* list = table_slot((PostingTable*)table, directory[i].kind, directory[i].key);
+        for (int j = 0; ok && j < list->count; j++) {
+            int64_t record_index = (int64_t)list->records[j];
+            ok = fwrite(&record_index, sizeof(record_index), 1, file) == 1;
+        }
+    }
+
+    fclose(file);
+    free(directory);
+
+    if (!ok) {
+        remove(temp_path);
+        return ERROR_FILE_OPERATION;
+    }
+
+    remove(path);
+    if (rename(temp_path, path) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Helper function to write the Bloom filter of a segment from a posting table
+static ErrorCode write_bloom_file(const LogSegmentInfo* info, const PostingTable* table, long long record_count) {
+    LogBloomFilter filter;
+    ErrorCode result = log_bloom_init(&filter, table->size);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    for (int i = 0; i < table->capacity; i++) {
+        const PostingList* list = &table->slots[i];
+        if (list->used) {
+            log_bloom_add(&filter, list->kind, list->key);
+        }
+    }
+
+    result = log_bloom_write(info, &filter, record_count);
+    log_bloom_free(&filter);
+    return result;
+}
+
+// Helper function to write every sealed index of a segment from a posting table
+static ErrorCode write_sealed_indexes(const LogSegmentInfo* info, const PostingTable* table, long long record_count) {
+    ErrorCode result = write_inv_file(info, table, record_count);
+    if (result == SUCCESS) {
+        result = write_bloom_file(info, table, record_count);
+    }
+    return result;
+}
+
+// Helper function to index a segment's records from a starting index into a table
+static ErrorCode index_segment_records(const LogSegmentInfo* info, PostingTable* table, FILE* posting_log) {
+    LogSegmentReader reader;
+    ErrorCode result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        return result;
+    }
+    log_segment_reader_set_columns(&reader, LOG_COLUMN_BIT(LOG_COLUMN_USER) | LOG_COLUMN_BIT(LOG_COLUMN_MODULE));
+
+    const LogEntry* entry;
+    long long record_index = 0;
+    while (result == SUCCESS && (entry = log_segment_reader_next(&reader)) != NULL) {
+        result = table_add_record(table, record_index, entry->userID, entry->module);
+
+        if (result == SUCCESS && posting_log) {
+            LogPostingRecord record;
+            memset(&record, 0, sizeof(record));
+            record.record_index = record_index;
+            safe_strcpy(record.user_id, entry->userID, sizeof(record.user_id));
+            safe_strcpy(record.module, entry->module, sizeof(record.module));
+            if (fwrite(&record, sizeof(record), 1, posting_log) != 1) {
+                result = ERROR_FILE_OPERATION;
+            }
+        }
+        record_index++;
+    }
+
+    log_segment_reader_close(&reader);
+    return result;
+}
+
+// Function to build the sealed index and Bloom filter of a segment from its records
+ErrorCode log_postings_build(const LogSegmentInfo* info) {
+    if (!info) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    PostingTable table;
+    ErrorCode result = table_init(&table, INITIAL_TABLE_CAPACITY);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    result = index_segment_records(info, &table, NULL);
+    if (result == SUCCESS) {
+        result = write_sealed_indexes(info, &table, info->record_count);
+    }
+
+    table_free(&table);
+    return result;
+}
+
+// Helper function to load the active posting log into the in-memory table
+static ErrorCode load_posting_log(const char* path, long long expected_records) {
+    long size = get_file_size(path);
+    if (size < 0 || size % (long)sizeof(LogPostingRecord) != 0 ||
+        size / (long)sizeof(LogPostingRecord) != expected_records) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    ErrorCode result = SUCCESS;
+    LogPostingRecord record;
+    while (result == SUCCESS && fread(&record, sizeof(record), 1, file) == 1) {
+        result = table_add_record(&active_table, record.record_index, record.user_id, record.module);
+    }
+
+    fclose(file);
+    return result;
+}
+
+// Function to load or rebuild the postings of the active segment
+ErrorCode log_postings_active_open(const LogSegmentInfo* info) {
+    if (!info) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&postings_lock);
+
+    table_free(&active_table);
+    if (active_log) {
+        fclose(active_log);
+        active_log = NULL;
+    }
+
+    ErrorCode result = table_init(&active_table, INITIAL_TABLE_CAPACITY);
+    if (result != SUCCESS) {
+        pthread_mutex_unlock(&postings_lock);
+        return result;
+    }
+
+    char path[128];
+    postings_path(info, ".pst", path, sizeof(path));
+
+    // A missing or stale posting log is rebuilt from the segment itself
+    if (load_posting_log(path, info->record_count) != SUCCESS) {
+        table_free(&active_table);
+        table_init(&active_table, INITIAL_TABLE_CAPACITY);
+
+        FILE* rebuilt = fopen(path, "wb");
+        if (!rebuilt) {
+            pthread_mutex_unlock(&postings_lock);
+            return ERROR_FILE_OPERATION;
+        }
+        result = index_segment_records(info, &active_table, rebuilt);
+        fclose(rebuilt);
+    }
+
+    if (result == SUCCESS) {
+        active_log = fopen(path, "ab");
+        if (!active_log) {
+            result = ERROR_FILE_OPERATION;
+        }
+    }
+
+    if (result == SUCCESS) {
+        active_segment_id = info->segment_id;
+        active_records = info->record_count;
+    } else {
+        table_free(&active_table);
+        active_segment_id = -1;
+    }
+
+    pthread_mutex_unlock(&postings_lock);
+    return result;
+}
+
+// Function to index a record appended to the active segment
+ErrorCode log_postings_active_add(long long record_index, const LogEntry* entry) {
+    if (!entry) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&postings_lock);
+
+    if (active_segment_id < 0 || !active_log) {
+        pthread_mutex_unlock(&postings_lock);
+        return ERROR_FILE_OPERATION;
+    }
+
+    LogPostingRecord record;
+    memset(&record, 0, sizeof(record));
+    record.record_index = record_index;
+    safe_strcpy(record.user_id, entry->userID, sizeof(record.user_id));
+    safe_strcpy(record.module, entry->module, sizeof(record.module));
+
+    ErrorCode result = SUCCESS;
+    if (fwrite(&record, sizeof(record), 1, active_log) != 1) {
+        result = ERROR_FILE_OPERATION;
+    }
+    if (result == SUCCESS) {
+        result = table_add_record(&active_table, record_index, record.user_id, record.module);
+    }
+    if (result == SUCCESS) {
+        active_records = record_index + 1;
+    }
+
+    pthread_mutex_unlock(&postings_lock);
+    return result;
+}
+
+// Function to push the buffered posting log to the operating system
+void log_postings_active_flush() {
+    pthread_mutex_lock(&postings_lock);
+    if (active_log) {
+        fflush(active_log);
+    }
+    pthread_mutex_unlock(&postings_lock);
+}
+
+// Helper function to drop the active postings; caller holds postings_lock
+static void release_active_locked() {
+    if (active_log) {
+        fclose(active_log);
+        active_log = NULL;
+    }
+    table_free(&active_table);
+    active_segment_id = -1;
+    active_records = 0;
+}
+
+// Function to hand the active postings of a segment being sealed over to
+// log_postings_write_sealed. Only moves the table, so it is cheap enough for
+// the store to call under its lock.
+ErrorCode log_postings_active_seal(const LogSegmentInfo* info) {
+    if (!info) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&postings_lock);
+
+    PendingSeal* pending = (PendingSeal*)calloc(1, sizeof(PendingSeal));
+    if (pending) {
+        pending->info = *info;
+        if (active_segment_id == info->segment_id && active_records == info->record_count) {
+            pending->table = active_table;
+            pending->has_table = 1;
+            memset(&active_table, 0, sizeof(active_table));
+        }
+
+        PendingSeal** link = &pending_seals;
+        while (*link) {
+            link = &(*link)->next;
+        }
+        *link = pending;
+    }
+    release_active_locked();
+
+    // The sealed index supersedes the posting log
+    char path[128];
+    postings_path(info, ".pst", path, sizeof(path));
+    remove(path);
+
+    pthread_mutex_unlock(&postings_lock);
+
+    // Without a pending entry the index is rebuilt on first lookup
+    return pending ? SUCCESS : ERROR_MEMORY_ALLOCATION;
+}
+
+// Function to write the index files of the segments sealed so far, from their
+// postings or, when those did not cover the segment, from its records
+ErrorCode log_postings_write_sealed() {
+    ErrorCode result = SUCCESS;
+
+    pthread_mutex_lock(&build_lock);
+
+    for (;;) {
+        pthread_mutex_lock(&postings_lock);
+        PendingSeal* pending = pending_seals;
+        pthread_mutex_unlock(&postings_lock);
+        if (!pending) {
+            break;
+        }
+
+        // Lookups keep reading the table from memory until it is unlinked
+        ErrorCode written = ERROR_DATA_NOT_FOUND;
+        if (pending->has_table) {
+            written = write_sealed_indexes(&pending->info, &pending->table, pending->info.record_count);
+        }
+        if (written != SUCCESS) {
+            written = log_postings_build(&pending->info);
+        }
+        if (written != SUCCESS) {
+            result = written;
+        }
+
+        pthread_mutex_lock(&postings_lock);
+        pending_seals = pending->next;
+        pthread_mutex_unlock(&postings_lock);
+
+        table_free(&pending->table);
+        free(pending);
+    }
+
+    pthread_mutex_unlock(&build_lock);
+    return result;
+}
+
+// Function to forget the pending index of a dropped segment; waits for a
+// write of it in progress, so none of its files appear after the drop
+void log_postings_discard(int segment_id) {
+    pthread_mutex_lock(&build_lock);
+    pthread_mutex_lock(&postings_lock);
+
+    for (PendingSeal** link = &pending_seals; *link; link = &(*link)->next) {
+        if ((*link)->info.segment_id == segment_id) {
+            PendingSeal* pending = *link;
+            *link = pending->next;
+            table_free(&pending->table);
+            free(pending);
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&postings_lock);
+    pthread_mutex_unlock(&build_lock);
+}
+
+// Function to release the active postings without sealing
+void log_postings_active_close() {
+    pthread_mutex_lock(&postings_lock);
+    release_active_locked();
+    pthread_mutex_unlock(&postings_lock);
+}
+
+// Helper function to copy record indexes below limit into a new array
+static ErrorCode copy_records(const long long* source, int source_count, long long limit,
+                              long long** records, int* count) {
+    *records = NULL;
+    *count = 0;
+
+    int kept = 0;
+    while (kept < source_count && source[kept] < limit) {
+        kept++;
+    }
+    if (kept == 0) {
+        return SUCCESS;
+    }
+
+    long long* copy = (long long*)safe_malloc(kept * sizeof(long long));
+    if (!copy) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memcpy(copy, source, kept * sizeof(long long));
+
+    *records = copy;
+    *count = kept;
+    return SUCCESS;
+}
+
+// Helper function to open a sealed index file and read its header.
+// Returns NULL when the file is missing or older than the segment.
+static FILE* open_inv_file(const LogSegmentInfo* info, InvHeader* header) {
+    char path[128];
+    postings_path(info, ".inv", path, sizeof(path));
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    if (fread(header, sizeof(InvHeader), 1, file) != 1 ||
+        memcmp(header->magic, INV_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != INV_VERSION || header->key_count < 0 ||
+        header->record_count < info->record_count) {
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+// Helper function to look a key up in a sealed index file.
+// Returns ERROR_DATA_NOT_FOUND when the file is missing or older than the segment.
+static ErrorCode lookup_inv_file(const LogSegmentInfo* info, int kind, const char* key,
+                                 long long** records, int* count) {
+    InvHeader header;
+    FILE* file = open_inv_file(info, &header);
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    // Binary search the sorted directory without loading it all
+    InvDirEntry target;
+    memset(&target, 0, sizeof(target));
+    target.kind = kind;
+    safe_strcpy(target.key, key, sizeof(target.key));
+
+    long directory_start = (long)sizeof(InvHeader);
+    long postings_start = directory_start + (long)header.key_count * (long)sizeof(InvDirEntry);
+
+    int low = 0;
+    int high = header.key_count;
+    InvDirEntry found;
+    int matched = 0;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        InvDirEntry probe;
+        if (fseek(file, directory_start + (long)mid * (long)sizeof(InvDirEntry), SEEK_SET) != 0 ||
+            fread(&probe, sizeof(probe), 1, file) != 1) {
+            fclose(file);
+            return ERROR_DATA_NOT_FOUND;
+        }
+
+        int order = compare_dir_entries(&probe, &target);
+        if (order == 0) {
+            found = probe;
+            matched = 1;
+            break;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    *records = NULL;
+    *count = 0;
+    if (!matched || found.count == 0) {
+        fclose(file);
+        return SUCCESS;
+    }
+
+    int64_t* stored = (int64_t*)safe_malloc(found.count * sizeof(int64_t));
+    long long* loaded = (long long*)safe_malloc(found.count * sizeof(long long));
+    if (!stored || !loaded) {
+        free(stored);
+        free(loaded);
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int ok = fseek(file, postings_start + (long)found.offset * (long)sizeof(int64_t), SEEK_SET) == 0 &&
+             fread(stored, sizeof(int64_t), found.count, file) == (size_t)found.count;
+    fclose(file);
+
+    if (!ok) {
+        free(stored);
+        free(loaded);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    // The index may describe more records than the caller's snapshot of the segment
+    int kept = 0;
+    for (int i = 0; i < found.count; i++) {
+        if (stored[i] < info->record_count) {
+            loaded[kept++] = (long long)stored[i];
+        }
+    }
+    free(stored);
+
+    if (kept == 0) {
+        free(loaded);
+        return SUCCESS;
+    }
+
+    *records = loaded;
+    *count = kept;
+    return SUCCESS;
+}
+
+// Helper function to write a sealed segment's missing filter from the keys in
+// the directory of its index, without reading the segment's records
+static ErrorCode write_bloom_from_inv(const LogSegmentInfo* info) {
+    InvHeader header;
+    FILE* file = open_inv_file(info, &header);
+    if (!file) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    LogBloomFilter filter;
+    ErrorCode result = log_bloom_init(&filter, header.key_count);
+    for (int i = 0; result == SUCCESS && i < header.key_count; i++) {
+        InvDirEntry entry;
+        if (fread(&entry, sizeof(entry), 1, file) != 1) {
+            result = ERROR_DATA_NOT_FOUND;
+        } else {
+            log_bloom_add(&filter, entry.kind, entry.key);
+        }
+    }
+    fclose(file);
+
+    if (result == SUCCESS) {
+        result = log_bloom_write(info, &filter, info->record_count);
+    }
+    log_bloom_free(&filter);
+    return result;
+}
+
+// Helper function to repair the indexes of a sealed segment for a query:
+// a missing or stale index is rebuilt from the records, a missing filter
+// from the index. Queries racing on the same segment repair it once.
+static ErrorCode repair_sealed_indexes(const LogSegmentInfo* info, int have_index) {
+    pthread_mutex_lock(&build_lock);
+
+    ErrorCode result;
+    if (have_index) {
+        result = write_bloom_from_inv(info);
+    } else {
+        InvHeader header;
+        FILE* file = open_inv_file(info, &header);
+        if (file) {
+            fclose(file);  // Rebuilt by another query meanwhile
+            result = SUCCESS;
+        } else {
+            result = log_postings_build(info);
+        }
+    }
+
+    pthread_mutex_unlock(&build_lock);
+    return result;
+}
+
+// Function to look up the records of a segment whose field equals key
+ErrorCode log_postings_lookup(const LogSegmentInfo* info, LogPostingKind kind, const char* key,
+                              long long** records, int* count, long long* covered) {
+    if (!info || !key || !records || !count || !covered) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    *records = NULL;
+    *count = 0;
+    *covered = 0;
+
+    // A sealed segment whose filter rules the key out is skipped before any of
+    // its files is opened; the filter cache does its own locking
+    int may_contain = 1;
+    int have_filter = info->sealed && log_bloom_check(info, kind, key, &may_contain) == SUCCESS;
+    if (have_filter && !may_contain) {
+        *covered = info->record_count;
+        return SUCCESS;
+    }
+
+    // The active segment is served from memory
+    if (!info->sealed) {
+        pthread_mutex_lock(&postings_lock);
+        if (info->segment_id == active_segment_id) {
+            ErrorCode result = SUCCESS;
+            long long limit = active_records < info->record_count ? active_records : info->record_count;
+
+            PostingList* list = table_slot(&active_table, kind, key);
+            if (list->used) {
+                result = copy_records(list->records, list->count, limit, records, count);
+            }
+            if (result == SUCCESS) {
+                *covered = limit;
+            }
+
+            pthread_mutex_unlock(&postings_lock);
+            return result;
+        }
+        pthread_mutex_unlock(&postings_lock);
+    }
+
+    // So is a sealed segment whose index files are still being written
+    if (info->sealed) {
+        pthread_mutex_lock(&postings_lock);
+        const PendingSeal* pending = pending_seals;
+        while (pending && pending->info.segment_id != info->segment_id) {
+            pending = pending->next;
+        }
+        if (pending && pending->has_table) {
+            ErrorCode result = SUCCESS;
+            PostingList* list = table_slot((PostingTable*)&pending->table, kind, key);
+            if (list->used) {
+                result = copy_records(list->records, list->count, info->record_count, records, count);
+            }
+            if (result == SUCCESS) {
+                *covered = info->record_count;
+            }
+
+            pthread_mutex_unlock(&postings_lock);
+            return result;
+        }
+        pthread_mutex_unlock(&postings_lock);
+    }
+
+    // Sealed index files are replaced by rename and read without postings_lock
+    ErrorCode result = lookup_inv_file(info, kind, key, records, count);
+
+    // Sealed segments get a missing or stale index rebuilt on demand, and a
+    // missing filter written from the index
+    if (info->sealed && result == ERROR_DATA_NOT_FOUND) {
+        result = repair_sealed_indexes(info, 0);
+        if (result == SUCCESS) {
+            result = lookup_inv_file(info, kind, key, records, count);
+        }
+    } else if (info->sealed && result == SUCCESS && !have_filter) {
+        repair_sealed_indexes(info, 1);
+    }
+
+    if (result == SUCCESS) {
+        *covered = info->record_count;
+    } else if (result == ERROR_DATA_NOT_FOUND) {
+        result = SUCCESS;  // Nothing indexed: the caller scans the whole segment
+    }
+    return result;
+}
+
+// Helper function to compile a posting key for comparing record fields;
+// returns the offset of the field within LogEntry
+static size_t compile_posting_key(FieldPattern* pattern, LogPostingKind kind, const char* key) {
+    if (kind == LOG_POSTING_USER) {
+        field_pattern_init(pattern, key, MAX_ID_LEN, FIELD_MATCH_EQUAL);
+        return offsetof(LogEntry, userID);
+    }
+    field_pattern_init(pattern, key, MAX_MODULE_LEN, FIELD_MATCH_EQUAL);
+    return offsetof(LogEntry, module);
+}
+
+// Helper function to check a record against a compiled posting key
+static int record_matches(const LogEntry* entry, const FieldPattern* pattern, size_t field_offset) {
+    return field_match_record(pattern, entry, sizeof(LogEntry), field_offset);
+}
+
+// Function to visit the records of one segment whose field equals key;
+// stopped is set when the visitor asked to stop
+ErrorCode log_postings_scan_segment(const LogSegmentInfo* info, LogPostingKind kind, const char* key,
+                                    LogRecordVisitor visitor, void* context, int* stopped) {
+    if (!info || !key || !visitor || !stopped) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    long long* records = NULL;
+    int record_count = 0;
+    long long covered = 0;
+
+    ErrorCode result = log_postings_lookup(info, kind, key, &records, &record_count, &covered);
+    if (result != SUCCESS) {
+        return result;
+    }
+    if (record_count == 0 && covered == info->record_count) {
+        return SUCCESS;  // The index proves the segment holds no match
+    }
+
+    LogSegmentReader reader;
+    result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        safe_free((void**)&records);
+        return result;
+    }
+
+    FieldPattern pattern;
+    size_t field_offset = compile_posting_key(&pattern, kind, key);
+
+    // Postings are usually sparse, so skip read-ahead while following them
+    if (record_count > 0) {
+        mapped_file_advise(&reader.map, MAPPED_ACCESS_RANDOM);
+    }
+
+    const LogEntry* entry;
+    for (int j = 0; j < record_count && !*stopped; j++) {
+        entry = log_segment_reader_read_at(&reader, records[j]);
+        if (entry && record_matches(entry, &pattern, field_offset)) {
+            *stopped = visitor(entry, context);
+        }
+    }
+
+    // Records appended after the index was last updated are scanned directly
+    if (!*stopped && covered < info->record_count &&
+        log_segment_reader_seek(&reader, covered) == SUCCESS) {
+        while (!*stopped && (entry = log_segment_reader_next(&reader)) != NULL) {
+            if (record_matches(entry, &pattern, field_offset)) {
+                *stopped = visitor(entry, context);
+            }
+        }
+    }
+
+    log_segment_reader_close(&reader);
+    safe_free((void**)&records);
+    return SUCCESS;
+}
+
+// Function to visit every record whose field equals key, reading only indexed
+// records plus any unindexed tail of each segment
+ErrorCode log_postings_scan(LogPostingKind kind, const char* key, LogRecordVisitor visitor, void* context) {
+    if (!key || !visitor) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode result = log_store_list_segments(0, 0, &segments, &segment_count);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    int stopped = 0;
+    for (int i = 0; i < segment_count && !stopped && result == SUCCESS; i++) {
+        result = log_postings_scan_segment(&segments[i], kind, key, visitor, context, &stopped);
+    }
+
+    safe_free((void**)&segments);
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef LOG_POSTINGS_H
+#define LOG_POSTINGS_H
+
+#include "data_structures.h"
+#include "log_store.h"
+
+// Inverted indexes from userID and module to record indexes within a segment.
+// The active segment keeps its postings in memory, backed by an append-only
+// seg-*.pst log written alongside each record. Sealed segments get a compact
+// seg-*.inv file and a Bloom filter (log_bloom.h), written from the postings
+// by the store's compaction worker after the seal, or built on demand when
+// missing or stale; the filter is checked before the index.
+
+typedef enum {
+    LOG_POSTING_USER = 0,
+    LOG_POSTING_MODULE = 1
+} LogPostingKind;
+
+// Record of the active segment's posting log
+typedef struct {
+    long long record_index;
+    char user_id[MAX_ID_LEN];
+    char module[MAX_MODULE_LEN];
+} LogPostingRecord;
+
+// Active segment maintenance, called by the log store under its lock
+ErrorCode log_postings_active_open(const LogSegmentInfo* info);
+ErrorCode log_postings_active_add(long long record_index, const LogEntry* entry);
+void log_postings_active_flush();
+ErrorCode log_postings_active_seal(const LogSegmentInfo* info);
+void log_postings_active_close();
+
+// Sealed segment index and filter files
+ErrorCode log_postings_write_sealed();
+void log_postings_discard(int segment_id);
+ErrorCode log_postings_build(const LogSegmentInfo* info);
+
+// Lookup: the sorted record indexes of a segment whose field equals key.
+// covered receives how many leading records the postings describe; records
+// past it have not been indexed yet and must be scanned by the caller.
+ErrorCode log_postings_lookup(const LogSegmentInfo* info, LogPostingKind kind, const char* key,
+                              long long** records, int* count, long long* covered);
+
+// Visiting every record in the store, or in one segment, whose field equals key
+ErrorCode log_postings_scan_segment(const LogSegmentInfo* info, LogPostingKind kind, const char* key,
+                                    LogRecordVisitor visitor, void* context, int* stopped);
+ErrorCode log_postings_scan(LogPostingKind kind, const char* key, LogRecordVisitor visitor, void* context);
+
+#endif // LOG_POSTINGS_H
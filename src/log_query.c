@@ -0,0 +1,678 @@
+#include "log_query.h"
+#include "log_postings.h"
+#include "log_time_index.h"
+#include "field_match.h"
+#include "crc32c.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+// A scattered read through postings costs about as much as this many
+// records of a sequential scan
+#define RANDOM_READ_COST 4
+
+// Predicate and callback pair threaded through a store scan
+typedef struct {
+    LogPredicate predicate;
+    LogRecordVisitor callback;
+    void* context;
+} FilteredVisitor;
+
+// Helper function to apply the predicate before handing a record to the callback
+static int visit_filtered(const LogEntry* entry, void* context) {
+    FilteredVisitor* visitor = (FilteredVisitor*)context;
+    if (visitor->predicate && !visitor->predicate(entry, visitor->context)) {
+        return 0;
+    }
+    return visitor->callback(entry, visitor->context);
+}
+
+// Function to stream every record accepted by predicate to callback
+ErrorCode log_query_foreach(LogPredicate predicate, LogRecordVisitor callback, void* context) {
+    return log_query_foreach_range(0, 0, predicate, callback, context);
+}
+
+// Function to stream records with start <= timestamp <= end accepted by predicate
+ErrorCode log_query_foreach_range(time_t start, time_t end, LogPredicate predicate,
+                                  LogRecordVisitor callback, void* context) {
+    if (!callback || (start != 0 && end != 0 && end < start)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    FilteredVisitor visitor = { predicate, callback, context };
+    return log_store_scan_time_range(start, end, visit_filtered, &visitor);
+}
+
+// Function to stream the records of one local day
+ErrorCode log_query_foreach_date(const char* date, LogRecordVisitor callback, void* context) {
+    if (!date || !callback) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    time_t start;
+    time_t end;
+    if (!log_query_date_range(date, &start, &end)) {
+        return SUCCESS;  // An invalid date matches nothing
+    }
+
+    return log_query_foreach_range(start, end, NULL, callback, context);
+}
+
+// Function to stream the records of one user through the postings index
+ErrorCode log_query_foreach_user(const char* user_id, LogRecordVisitor callback, void* context) {
+    if (!user_id || !callback) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    return log_postings_scan(LOG_POSTING_USER, user_id, callback, context);
+}
+
+// Function to stream the records of one module through the postings index
+ErrorCode log_query_foreach_module(const char* module, LogRecordVisitor callback, void* context) {
+    if (!module || !callback) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    return log_postings_scan(LOG_POSTING_MODULE, module, callback, context);
+}
+
+// Field predicates of a query, compiled once for the field-match kernels
+typedef struct {
+    const LogQuery* query;
+    FieldPattern user;
+    FieldPattern module;
+    FieldPattern action;
+    int has_user;
+    int has_module;
+    int has_action;
+} CompiledQuery;
+
+// Helper function to check whether an optional key is set
+static int key_set(const char* key) {
+    return key && key[0] != '\0';
+}
+
+// Helper function to compile the field predicates of a query
+static void compile_query(const LogQuery* query, CompiledQuery* compiled) {
+    memset(compiled, 0, sizeof(CompiledQuery));
+    compiled->query = query;
+
+    compiled->has_user = key_set(query->user_id);
+    if (compiled->has_user) {
+        field_pattern_init(&compiled->user, query->user_id, MAX_ID_LEN, FIELD_MATCH_EQUAL);
+    }
+    compiled->has_module = key_set(query->module);
+    if (compiled->has_module) {
+        field_pattern_init(&compiled->module, query->module, MAX_MODULE_LEN, FIELD_MATCH_EQUAL);
+    }
+    compiled->has_action = key_set(query->action);
+    if (compiled->has_action) {
+        field_pattern_init(&compiled->action, query->action, MAX_ACTION_LEN, FIELD_MATCH_EQUAL);
+    }
+}
+
+// Helper function to check a record against every predicate of a query
+static int query_matches(const CompiledQuery* compiled, const LogEntry* entry) {
+    const LogQuery* query = compiled->query;
+    if ((query->start != 0 && entry->timestamp < query->start) ||
+        (query->end != 0 && entry->timestamp > query->end)) {
+        return 0;
+    }
+    if ((compiled->has_user &&
+         !field_match_record(&compiled->user, entry, sizeof(LogEntry), offsetof(LogEntry, userID))) ||
+        (compiled->has_module &&
+         !field_match_record(&compiled->module, entry, sizeof(LogEntry), offsetof(LogEntry, module))) ||
+        (compiled->has_action &&
+         !field_match_record(&compiled->action, entry, sizeof(LogEntry), offsetof(LogEntry, action)))) {
+        return 0;
+    }
+    return !query->predicate || query->predicate(entry, query->context);
+}
+
+// Helper function to find the records [first, last) of a segment that may
+// fall in the query's time range, through the time index
+static void time_window(const LogQuery* query, const LogSegmentInfo* info, long long* first, long long* last) {
+    *first = 0;
+    *last = info->record_count;
+
+    int cuts_start = query->start != 0 && info->min_timestamp < query->start;
+    int cuts_end = query->end != 0 && info->max_timestamp > query->end;
+    if (!cuts_start && !cuts_end) {
+        return;
+    }
+
+    LogTimeIndexEntry* entries = NULL;
+    int entry_count = 0;
+    if (log_time_index_load(info, &entries, &entry_count) != SUCCESS || entry_count == 0) {
+        safe_free((void**)&entries);
+        return;
+    }
+
+    if (cuts_start) {
+        *first = log_time_index_find_start(entries, entry_count, query->start);
+    }
+
+    // No record after one with timestamp - max_skew > end can be in range
+    if (cuts_end) {
+        for (int i = 0; i < entry_count; i++) {
+            if (entries[i].min_timestamp - info->max_skew > query->end) {
+                *last = entries[i].record_index;
+                break;
+            }
+        }
+    }
+
+    safe_free((void**)&entries);
+}
+
+// Helper function to intersect two sorted record lists into the first; returns its new count
+static int intersect_records(long long* records, int count, const long long* other, int other_count) {
+    int kept = 0;
+    int j = 0;
+    for (int i = 0; i < count && j < other_count; i++) {
+        while (j < other_count && other[j] < records[i]) {
+            j++;
+        }
+        if (j < other_count && other[j] == records[i]) {
+            records[kept++] = records[i];
+        }
+    }
+    return kept;
+}
+
+// Helper function to read records [first, last) of a segment in order
+static ErrorCode scan_records(const CompiledQuery* compiled, LogSegmentReader* reader, long long first,
+                              long long last, LogRecordVisitor callback, void* callback_context,
+                              LogQueryStats* stats, int* stopped) {
+    log_segment_reader_seek(reader, first);
+    for (long long index = first; index < last && !*stopped; index++) {
+        const LogEntry* entry = log_segment_reader_next(reader);
+        if (!entry) {
+            break;
+        }
+        if (stats) {
+            stats->records_read++;
+        }
+        if (query_matches(compiled, entry)) {
+            if (stats) {
+                stats->records_matched++;
+            }
+            *stopped = callback(entry, callback_context);
+        }
+    }
+    return SUCCESS;
+}
+
+// Access path chosen for one segment
+typedef struct {
+    long long first;            // Time window [first, last) of record indexes; empty when skipped
+    long long last;
+    long long* candidates;      // Postings candidates in [first, tail_start), sorted
+    int candidate_count;
+    long long tail_start;       // Records from here to last are past the postings and scanned
+    int use_postings;
+} SegmentPlan;
+
+// Helper function to plan how a segment is read: its time window, and whether
+// the intersected postings are cheaper than scanning that window
+static ErrorCode plan_segment(const CompiledQuery* compiled, const LogSegmentInfo* info, SegmentPlan* plan) {
+    const LogQuery* query = compiled->query;
+    memset(plan, 0, sizeof(SegmentPlan));
+    time_window(query, info, &plan->first, &plan->last);
+
+    // Candidate records from the postings of each key, intersected. covered
+    // is how far every list used is complete; records past it are scanned.
+    const char* keys[2] = { compiled->has_user ? query->user_id : NULL, compiled->has_module ? query->module : NULL };
+    const LogPostingKind kinds[2] = { LOG_POSTING_USER, LOG_POSTING_MODULE };
+    int indexed = 0;
+    long long covered = info->record_count;
+
+    for (int k = 0; k < 2 && plan->first < plan->last; k++) {
+        if (!keys[k]) {
+            continue;
+        }
+
+        long long* records = NULL;
+        int count = 0;
+        long long key_covered = 0;
+        ErrorCode result = log_postings_lookup(info, kinds[k], keys[k], &records, &count, &key_covered);
+        if (result != SUCCESS) {
+            safe_free((void**)&plan->candidates);
+            return result;
+        }
+
+        if (count == 0 && key_covered == info->record_count) {
+            plan->last = plan->first;  // The filter or index proves the key absent
+        } else if (!indexed) {
+            plan->candidates = records;
+            plan->candidate_count = count;
+            records = NULL;
+            indexed = 1;
+        } else {
+            plan->candidate_count = intersect_records(plan->candidates, plan->candidate_count, records, count);
+        }
+        if (key_covered < covered) {
+            covered = key_covered;
+        }
+        safe_free((void**)&records);
+    }
+
+    if (plan->first >= plan->last) {
+        safe_free((void**)&plan->candidates);
+        plan->candidate_count = 0;
+        return SUCCESS;
+    }
+
+    // Keep the candidates inside the time window and the part every list covers
+    long long indexed_end = covered < plan->last ? covered : plan->last;
+    int kept = 0;
+    for (int j = 0; j < plan->candidate_count; j++) {
+        if (plan->candidates[j] >= plan->first && plan->candidates[j] < indexed_end) {
+            plan->candidates[kept++] = plan->candidates[j];
+        }
+    }
+    plan->candidate_count = kept;
+
+    plan->tail_start = covered > plan->first ? covered : plan->first;
+    long long tail = plan->last > plan->tail_start ? plan->last - plan->tail_start : 0;
+    plan->use_postings = indexed &&
+                         (long long)plan->candidate_count * RANDOM_READ_COST + tail < plan->last - plan->first;
+    if (!plan->use_postings) {
+        safe_free((void**)&plan->candidates);
+        plan->candidate_count = 0;
+        plan->tail_start = plan->first;
+    }
+    return SUCCESS;
+}
+
+// Function to run a query's plan for one segment
+ErrorCode log_query_segment(const LogQuery* query, const LogSegmentInfo* info, LogRecordVisitor callback,
+                            void* callback_context, LogQueryStats* stats, int* stopped) {
+    if (!query || !info || !callback || !stopped) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    *stopped = 0;
+    if (stats) {
+        stats->segments++;
+    }
+
+    CompiledQuery compiled;
+    compile_query(query, &compiled);
+
+    SegmentPlan plan;
+    ErrorCode result = plan_segment(&compiled, info, &plan);
+    if (result != SUCCESS) {
+        return result;
+    }
+    if (plan.first >= plan.last) {
+        if (stats) {
+            stats->segments_skipped++;
+        }
+        return SUCCESS;
+    }
+
+    LogSegmentReader reader;
+    result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        safe_free((void**)&plan.candidates);
+        return result;
+    }
+
+    if (plan.use_postings) {
+        if (stats) {
+            stats->segments_by_postings++;
+        }
+        if (plan.candidate_count > 0) {
+            mapped_file_advise(&reader.map, MAPPED_ACCESS_RANDOM);
+        }
+
+        for (int j = 0; j < plan.candidate_count && !*stopped; j++) {
+            const LogEntry* entry = log_segment_reader_read_at(&reader, plan.candidates[j]);
+            if (!entry) {
+                continue;
+            }
+            if (stats) {
+                stats->records_read++;
+            }
+            if (query_matches(&compiled, entry)) {
+                if (stats) {
+                    stats->records_matched++;
+                }
+                *stopped = callback(entry, callback_context);
+            }
+        }
+
+        // Records appended after the postings were last updated
+        if (!*stopped && plan.tail_start < plan.last) {
+            result = scan_records(&compiled, &reader, plan.tail_start, plan.last, callback, callback_context,
+                                  stats, stopped);
+        }
+    } else {
+        if (stats) {
+            stats->segments_by_scan++;
+        }
+        result = scan_records(&compiled, &reader, plan.first, plan.last, callback, callback_context, stats, stopped);
+    }
+
+    log_segment_reader_close(&reader);
+    safe_free((void**)&plan.candidates);
+    return result;
+}
+
+// Function to stream the records matching every predicate of a query
+ErrorCode log_query(const LogQuery* query, LogRecordVisitor callback, LogQueryStats* stats) {
+    if (!query || !callback || (query->start != 0 && query->end != 0 && query->end < query->start)) {
+        return ERROR_INVALID_INPUT;
+    }
+    if (stats) {
+        memset(stats, 0, sizeof(LogQueryStats));
+    }
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode result = log_store_list_segments(query->start, query->end, &segments, &segment_count);
+
+    int stopped = 0;
+    for (int i = 0; result == SUCCESS && i < segment_count && !stopped; i++) {
+        result = log_query_segment(query, &segments[i], callback, query->context, stats, &stopped);
+    }
+
+    safe_free((void**)&segments);
+    return result;
+}
+
+// Position of a paged listing: where the next page starts (oldest first),
+// or the exclusive end of the records it reads back from (newest first)
+typedef struct {
+    int segment_id;
+    long long record_index;
+} PagePosition;
+
+// Helper function to encode a position as a token: order, segment and
+// record in hex, then a CRC-32C of that text so damaged tokens are refused
+static void encode_page_token(LogPageOrder order, const PagePosition* position, char* token) {
+    char body[32];
+    int length = snprintf(body, sizeof(body), "%c%x.%llx", order == LOG_PAGE_NEWEST_FIRST ? 'n' : 'o',
+                          (unsigned int)position->segment_id, (unsigned long long)position->record_index);
+    snprintf(token, LOG_PAGE_TOKEN_LEN, "%s.%08x", body, (unsigned int)crc32c(0, body, (size_t)length));
+}
+
+// Helper function to decode a token issued for the same order; returns 0 if it is not valid
+static int decode_page_token(const char* token, LogPageOrder order, PagePosition* position) {
+    const char* check = strrchr(token, '.');
+    if (!check || check - token >= LOG_PAGE_TOKEN_LEN || token[0] != (order == LOG_PAGE_NEWEST_FIRST ? 'n' : 'o')) {
+        return 0;
+    }
+
+    char* end = NULL;
+    unsigned long crc = strtoul(check + 1, &end, 16);
+    if (*end != '\0' || (uint32_t)crc != crc32c(0, token, (size_t)(check - token))) {
+        return 0;
+    }
+
+    unsigned int segment_id = 0;
+    unsigned long long record_index = 0;
+    if (sscanf(token + 1, "%x.%llx", &segment_id, &record_index) != 2) {
+        return 0;
+    }
+    position->segment_id = (int)segment_id;
+    position->record_index = (long long)record_index;
+    return 1;
+}
+
+// Helper function to add a record to a page if it matches; returns 1 once the page is full
+static int page_add(const CompiledQuery* compiled, const LogEntry* entry, LogPage* page) {
+    if (entry && query_matches(compiled, entry)) {
+        page->records[page->count++] = *entry;
+    }
+    return page->count >= page->limit;
+}
+
+// Helper function to fill a page from records [from, to) of a segment, in
+// page order, along the segment's planned access path. Sets *full and
+// *resume, the position the next page continues from, once the page fills.
+// Reading newest first walks the window backwards; an archived segment
+// still decodes each of its blocks only once, as the reader keeps the
+// current block while the index moves down through it.
+static ErrorCode page_segment(const CompiledQuery* compiled, const LogSegmentInfo* info, int newest,
+                              long long from, long long to, LogPage* page, int* full, long long* resume) {
+    SegmentPlan plan;
+    ErrorCode result = plan_segment(compiled, info, &plan);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    if (from < plan.first) {
+        from = plan.first;
+    }
+    if (to > plan.last) {
+        to = plan.last;
+    }
+    if (from >= to) {
+        safe_free((void**)&plan.candidates);
+        return SUCCESS;
+    }
+
+    LogSegmentReader reader;
+    result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        safe_free((void**)&plan.candidates);
+        return result;
+    }
+
+    // Postings candidates lie below tail_start and scanned records from it on
+    long long scan_from = plan.tail_start > from ? plan.tail_start : from;
+    *full = 0;
+
+    if (!newest) {
+        for (int j = 0; j < plan.candidate_count && !*full; j++) {
+            long long index = plan.candidates[j];
+            if (index >= from && index < to) {
+                *full = page_add(compiled, log_segment_reader_read_at(&reader, index), page);
+                *resume = index + 1;
+            }
+        }
+
+        log_segment_reader_seek(&reader, scan_from);
+        for (long long index = scan_from; index < to && !*full; index++) {
+            *full = page_add(compiled, log_segment_reader_next(&reader), page);
+            *resume = index + 1;
+        }
+    } else {
+        for (long long index = to - 1; index >= scan_from && !*full; index--) {
+            *full = page_add(compiled, log_segment_reader_read_at(&reader, index), page);
+            *resume = index;
+        }
+
+        for (int j = plan.candidate_count - 1; j >= 0 && !*full; j--) {
+            long long index = plan.candidates[j];
+            if (index >= from && index < to) {
+                *full = page_add(compiled, log_segment_reader_read_at(&reader, index), page);
+                *resume = index;
+            }
+        }
+    }
+
+    log_segment_reader_close(&reader);
+    safe_free((void**)&plan.candidates);
+    return SUCCESS;
+}
+
+// Function to read one page of a query's matches, continuing from token
+ErrorCode log_query_page(const LogQuery* query, LogPageOrder order, const char* token, LogPage* page) {
+    if (!query || !page || !page->records || page->limit <= 0 ||
+        (query->start != 0 && query->end != 0 && query->end < query->start)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    page->count = 0;
+    page->next_token[0] = '\0';
+
+    PagePosition position;
+    int resuming = token && token[0] != '\0';
+    if (resuming && !decode_page_token(token, order, &position)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode result = log_store_list_segments(query->start, query->end, &segments, &segment_count);
+
+    CompiledQuery compiled;
+    compile_query(query, &compiled);
+
+    int newest = order == LOG_PAGE_NEWEST_FIRST;
+    int full = 0;
+    for (int n = 0; result == SUCCESS && n < segment_count && !full; n++) {
+        const LogSegmentInfo* info = &segments[newest ? segment_count - 1 - n : n];
+
+        // The first newest-first page pins the listing to the records present now
+        long long from = 0;
+        long long to = info->record_count;
+        if (resuming && newest) {
+            if (info->segment_id > position.segment_id) {
+                continue;
+            }
+            if (info->segment_id == position.segment_id && position.record_index < to) {
+                to = position.record_index;
+            }
+        } else if (resuming) {
+            if (info->segment_id < position.segment_id) {
+                continue;
+            }
+            if (info->segment_id == position.segment_id) {
+                from = position.record_index;
+            }
+        }
+        if (from >= to) {
+            continue;
+        }
+
+        long long resume = 0;
+        result = page_segment(&compiled, info, newest, from, to, page, &full, &resume);
+        if (result == SUCCESS && full) {
+            PagePosition next = { info->segment_id, resume };
+            encode_page_token(order, &next, page->next_token);
+        }
+    }
+
+    safe_free((void**)&segments);
+    return result;
+}
+
+// Function to open a cursor over records with start <= timestamp <= end
+ErrorCode log_cursor_open(LogCursor* cursor, time_t start, time_t end, LogPredicate predicate, void* context) {
+    if (!cursor || (start != 0 && end != 0 && end < start)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(cursor, 0, sizeof(LogCursor));
+    cursor->start = start;
+    cursor->end = end;
+    cursor->predicate = predicate;
+    cursor->context = context;
+
+    // The snapshot pins each segment's record count, so appends made while
+    // the cursor is open are not returned
+    return log_store_list_segments(start, end, &cursor->segments, &cursor->segment_count);
+}
+
+// Helper function to open the reader on the cursor's current segment,
+// entering it at the first index block that can reach the start of the range
+static ErrorCode open_segment_reader(LogCursor* cursor) {
+    const LogSegmentInfo* info = &cursor->segments[cursor->segment_pos];
+
+    ErrorCode result = log_segment_reader_open(info, &cursor->reader);
+    if (result != SUCCESS) {
+        return result;
+    }
+    cursor->reader_open = 1;
+
+    if (cursor->start != 0 && info->min_timestamp < cursor->start) {
+        LogTimeIndexEntry* entries = NULL;
+        int entry_count = 0;
+        if (log_time_index_load(info, &entries, &entry_count) == SUCCESS && entry_count > 0) {
+            long long first = log_time_index_find_start(entries, entry_count, cursor->start);
+            log_segment_reader_seek(&cursor->reader, first);
+        }
+        safe_free((void**)&entries);
+    }
+
+    return SUCCESS;
+}
+
+// Function to fetch the next matching record; returns 1 when one was read, 0 at the end
+int log_cursor_next(LogCursor* cursor, LogEntry* entry) {
+    if (!cursor || !entry) {
+        return 0;
+    }
+
+    while (cursor->segment_pos < cursor->segment_count) {
+        if (!cursor->reader_open && open_segment_reader(cursor) != SUCCESS) {
+            cursor->segment_pos++;
+            continue;
+        }
+
+        time_t max_skew = cursor->segments[cursor->segment_pos].max_skew;
+        const LogEntry* record;
+        while ((record = log_segment_reader_next(&cursor->reader)) != NULL) {
+            // No later record of the segment trails this one by more than max_skew
+            if (cursor->end != 0 && record->timestamp - max_skew > cursor->end) {
+                break;
+            }
+            if ((cursor->start != 0 && record->timestamp < cursor->start) ||
+                (cursor->end != 0 && record->timestamp > cursor->end)) {
+                continue;
+            }
+            if (cursor->predicate && !cursor->predicate(record, cursor->context)) {
+                continue;
+            }
+            *entry = *record;
+            return 1;
+        }
+
+        log_segment_reader_close(&cursor->reader);
+        cursor->reader_open = 0;
+        cursor->segment_pos++;
+    }
+
+    return 0;
+}
+
+// Function to close a cursor
+void log_cursor_close(LogCursor* cursor) {
+    if (!cursor) {
+        return;
+    }
+
+    if (cursor->reader_open) {
+        log_segment_reader_close(&cursor->reader);
+        cursor->reader_open = 0;
+    }
+    safe_free((void**)&cursor->segments);
+    cursor->segment_count = 0;
+    cursor->segment_pos = 0;
+}
+
+// Function to get the local time range covered by a YYYY-MM-DD date
+int log_query_date_range(const char* date, time_t* start, time_t* end) {
+    if (!date || !start || !end || !is_valid_date(date)) {
+        return 0;
+    }
+
+    *start = parse_date_string(date);
+    if (*start == (time_t)-1) {
+        return 0;
+    }
+
+    struct tm timeinfo = {0};
+    timeinfo.tm_year = atoi(date) - 1900;
+    timeinfo.tm_mon = atoi(date + 5) - 1;
+    timeinfo.tm_mday = atoi(date + 8) + 1;
+    timeinfo.tm_isdst = -1;
+    *end = mktime(&timeinfo) - 1;
+    return 1;
+}
@@ -0,0 +1,99 @@
+#ifndef LOG_QUERY_H
+#define LOG_QUERY_H
+
+#include "data_structures.h"
+#include "log_store.h"
+#include <time.h>
+
+// Streaming queries over the audit log. Records are read once, in large
+// blocks, and handed to the consumer one at a time, so memory use does not
+// grow with the number of matches.
+
+// Predicate deciding whether a record is delivered; NULL accepts every record
+typedef int (*LogPredicate)(const LogEntry* entry, void* context);
+
+// Conjunctive query: a record is delivered when it matches every set field.
+// The planner picks an access path per segment: segments are skipped when a
+// Bloom filter or the postings rule a user or module out, read through the
+// intersection of the user and module postings when that is the smaller
+// candidate set, and otherwise scanned over the records the time index
+// places in [start, end]. Each qualifying record is read once.
+typedef struct {
+    time_t start;               // 0 leaves a bound open
+    time_t end;
+    const char* user_id;        // NULL or empty matches any
+    const char* module;
+    const char* action;
+    LogPredicate predicate;     // Extra filter, applied last
+    void* context;              // Passed to predicate and callback
+} LogQuery;
+
+// Planner decisions and work of a query
+typedef struct {
+    int segments;               // Overlapping the time range
+    int segments_skipped;       // Ruled out without reading a record
+    int segments_by_postings;   // Read through intersected postings
+    int segments_by_scan;       // Read as a time-bounded scan
+    long long records_read;
+    long long records_matched;
+} LogQueryStats;
+
+// Paged queries return at most limit matches per call, oldest or newest
+// first. A page that fills up carries a continuation token; passing it back
+// with the same query and order returns the following page. Tokens are
+// opaque text. A newest-first listing stays pinned to the records present
+// when its first page was read, so appends do not shift later pages.
+#define LOG_PAGE_TOKEN_LEN 48
+
+typedef enum {
+    LOG_PAGE_OLDEST_FIRST = 0,
+    LOG_PAGE_NEWEST_FIRST = 1
+} LogPageOrder;
+
+typedef struct {
+    LogEntry* records;                      // Caller's buffer of limit entries
+    int limit;
+    int count;                              // Records returned
+    char next_token[LOG_PAGE_TOKEN_LEN];    // Empty when no page follows
+} LogPage;
+
+// Pull-style cursor over the records of the store
+typedef struct {
+    LogSegmentInfo* segments;     // Snapshot of the segments overlapping the range
+    int segment_count;
+    int segment_pos;              // Segment the reader is positioned in
+    LogSegmentReader reader;
+    int reader_open;
+    time_t start;                 // 0 leaves a bound open
+    time_t end;
+    LogPredicate predicate;
+    void* context;
+} LogCursor;
+
+// Callback queries: callback returns non-zero to stop early.
+// The predicate and callback receive the same context.
+ErrorCode log_query_foreach(LogPredicate predicate, LogRecordVisitor callback, void* context);
+ErrorCode log_query_foreach_range(time_t start, time_t end, LogPredicate predicate,
+                                  LogRecordVisitor callback, void* context);
+ErrorCode log_query_foreach_date(const char* date, LogRecordVisitor callback, void* context);
+ErrorCode log_query_foreach_user(const char* user_id, LogRecordVisitor callback, void* context);
+ErrorCode log_query_foreach_module(const char* module, LogRecordVisitor callback, void* context);
+
+// Multi-predicate queries; stats may be NULL. log_query_segment runs the
+// plan for one segment, handing matches to callback with callback_context.
+ErrorCode log_query(const LogQuery* query, LogRecordVisitor callback, LogQueryStats* stats);
+ErrorCode log_query_segment(const LogQuery* query, const LogSegmentInfo* info, LogRecordVisitor callback,
+                            void* callback_context, LogQueryStats* stats, int* stopped);
+
+// Paged queries; a NULL or empty token starts at the first page
+ErrorCode log_query_page(const LogQuery* query, LogPageOrder order, const char* token, LogPage* page);
+
+// Cursor queries
+ErrorCode log_cursor_open(LogCursor* cursor, time_t start, time_t end, LogPredicate predicate, void* context);
+int log_cursor_next(LogCursor* cursor, LogEntry* entry);
+void log_cursor_close(LogCursor* cursor);
+
+// Local time range [start, end] covered by a YYYY-MM-DD date; returns 0 if invalid
+int log_query_date_range(const char* date, time_t* start, time_t* end);
+
+#endif // LOG_QUERY_H
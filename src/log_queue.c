@@ -0,0 +1,175 @@
+#include "log_queue.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Function to initialize a ring buffer
+ErrorCode log_queue_init(LogQueue* queue, int capacity, LogBackpressure backpressure) {
+    if (!queue || capacity <= 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (backpressure < LOG_BACKPRESSURE_BLOCK || backpressure > LOG_BACKPRESSURE_DROP_NEWEST) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(queue, 0, sizeof(LogQueue));
+    queue->slots = (QueuedLog*)safe_malloc(capacity * sizeof(QueuedLog));
+    if (!queue->slots) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    queue->capacity = capacity;
+    queue->backpressure = backpressure;
+
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    pthread_cond_init(&queue->drained, NULL);
+
+    return SUCCESS;
+}
+
+// Function to copy a record into the ring buffer; ticket receives its position in the stream
+ErrorCode log_queue_push(LogQueue* queue, const QueuedLog* record, unsigned long long* ticket) {
+    if (!queue || !record) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->count == queue->capacity && !queue->closed) {
+        switch (queue->backpressure) {
+            case LOG_BACKPRESSURE_BLOCK:
+                while (queue->count == queue->capacity && !queue->closed) {
+                    pthread_cond_wait(&queue->not_full, &queue->lock);
+                }
+                break;
+            case LOG_BACKPRESSURE_DROP_OLDEST:
+                // Overwrite the oldest entry; it counts as completed for flush barriers
+                queue->head = (queue->head + 1) % queue->capacity;
+                queue->count--;
+                queue->dropped++;
+                queue->completed++;
+                break;
+            case LOG_BACKPRESSURE_DROP_NEWEST:
+                queue->dropped++;
+                if (ticket) {
+                    *ticket = 0;
+                }
+                pthread_mutex_unlock(&queue->lock);
+                return SUCCESS;
+        }
+    }
+
+    if (queue->closed) {
+        pthread_mutex_unlock(&queue->lock);
+        return ERROR_FILE_OPERATION;
+    }
+
+    int tail = (queue->head + queue->count) % queue->capacity;
+    queue->slots[tail] = *record;
+    queue->count++;
+    queue->enqueued++;
+    if (ticket) {
+        *ticket = queue->enqueued;
+    }
+
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return SUCCESS;
+}
+
+// Function to take up to max_batch records; blocks until records arrive or the queue closes
+int log_queue_pop_batch(LogQueue* queue, QueuedLog* batch, int max_batch) {
+    if (!queue || !batch || max_batch <= 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (queue->count == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+    }
+
+    int taken = 0;
+    while (taken < max_batch && queue->count > 0) {
+        batch[taken++] = queue->slots[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+    }
+    queue->in_flight += taken;
+
+    if (taken > 0) {
+        pthread_cond_broadcast(&queue->not_full);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+    return taken;
+}
+
+// Function to acknowledge records handed out by log_queue_pop_batch
+void log_queue_complete(LogQueue* queue, int written) {
+    if (!queue || written <= 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    queue->in_flight -= written;
+    queue->completed += written;
+    pthread_cond_broadcast(&queue->drained);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Function to wait until the record with the given ticket, and all before it, are written
+void log_queue_wait_completed(LogQueue* queue, unsigned long long ticket) {
+    if (!queue) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->completed < ticket) {
+        pthread_cond_wait(&queue->drained, &queue->lock);
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Function to wait until every record enqueued before the call has been written
+void log_queue_wait_drained(LogQueue* queue) {
+    if (!queue) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    unsigned long long target = queue->enqueued;
+    pthread_mutex_unlock(&queue->lock);
+
+    log_queue_wait_completed(queue, target);
+}
+
+// Function to stop accepting records and wake every waiter
+void log_queue_close(LogQueue* queue) {
+    if (!queue) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Function to release ring buffer resources
+void log_queue_destroy(LogQueue* queue) {
+    if (!queue) {
+        return;
+    }
+
+    safe_free((void**)&queue->slots);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->drained);
+}
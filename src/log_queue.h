@@ -0,0 +1,51 @@
+#ifndef LOG_QUEUE_H
+#define LOG_QUEUE_H
+
+#include "data_structures.h"
+#include <pthread.h>
+#include <stdbool.h>
+
+// Backpressure policy applied when the ring buffer is full
+typedef enum {
+    LOG_BACKPRESSURE_BLOCK = 0,        // Producer waits for a free slot
+    LOG_BACKPRESSURE_DROP_OLDEST = 1,  // Oldest queued entry is overwritten
+    LOG_BACKPRESSURE_DROP_NEWEST = 2   // New entry is discarded
+} LogBackpressure;
+
+// A queued log record and the sink it is destined for
+typedef struct {
+    LogEntry entry;
+    int is_error;
+} QueuedLog;
+
+// Bounded ring buffer shared between log producers and the writer thread
+typedef struct {
+    QueuedLog* slots;
+    int capacity;
+    int head;               // Index of the oldest queued record
+    int count;              // Number of queued records
+    LogBackpressure backpressure;
+    bool closed;
+
+    unsigned long long enqueued;  // Records accepted into the buffer
+    unsigned long long completed; // Records written or dropped
+    unsigned long long dropped;   // Records lost to backpressure
+    int in_flight;                // Records popped but not yet written
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    pthread_cond_t drained;
+} LogQueue;
+
+// Ring buffer functions
+ErrorCode log_queue_init(LogQueue* queue, int capacity, LogBackpressure backpressure);
+ErrorCode log_queue_push(LogQueue* queue, const QueuedLog* record, unsigned long long* ticket);
+int log_queue_pop_batch(LogQueue* queue, QueuedLog* batch, int max_batch);
+void log_queue_complete(LogQueue* queue, int written);
+void log_queue_wait_completed(LogQueue* queue, unsigned long long ticket);
+void log_queue_wait_drained(LogQueue* queue);
+void log_queue_close(LogQueue* queue);
+void log_queue_destroy(LogQueue* queue);
+
+#endif // LOG_QUEUE_H
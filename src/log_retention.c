@@ -0,0 +1,315 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_retention.h"
+#include "log_store.h"
+#include "log_aggregate.h"
+#include "file_io.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define SECONDS_PER_DAY 86400
+
+// Files kept next to a segment, by extension: the segment itself in any
+// format, its time index, postings, Bloom filter and summary
+static const char* const segment_extensions[] = { ".dat", ".col", ".idx", ".inv", ".blm", ".sum", ".pst" };
+
+// Global variables for the background thread
+static pthread_t retention_thread;
+static int retention_running = 0;
+static int retention_stopping = 0;
+static LogRetentionPolicy retention_policy;
+static pthread_mutex_t retention_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t retention_wake = PTHREAD_COND_INITIALIZER;
+
+// Serializes passes, which share the pending list
+static pthread_mutex_t pass_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Function to fill in the default policy
+void log_retention_default_policy(LogRetentionPolicy* policy) {
+    if (!policy) {
+        return;
+    }
+    policy->raw_days = LOG_RETENTION_DEFAULT_RAW_DAYS;
+    policy->rollup_days = LOG_RETENTION_DEFAULT_ROLLUP_DAYS;
+    policy->interval_seconds = LOG_RETENTION_DEFAULT_INTERVAL;
+    policy->segments_per_pass = LOG_RETENTION_DEFAULT_SEGMENTS_PER_PASS;
+}
+
+// Helper function to unlink every file of a dropped segment
+static void remove_segment_files(const LogSegmentInfo* info) {
+    char path[128];
+    log_store_segment_path(info, path, sizeof(path));
+
+    char* extension = strrchr(path, '.');
+    if (!extension || strlen(extension) != 4) {
+        remove(path);
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(segment_extensions) / sizeof(segment_extensions[0]); i++) {
+        strcpy(extension, segment_extensions[i]);
+        remove(path);
+    }
+}
+
+// Helper function to load the segments dropped but not yet unlinked
+static ErrorCode load_pending(LogSegmentInfo** pending, int* count) {
+    *pending = NULL;
+    *count = 0;
+
+    long size = get_file_size(LOG_RETENTION_PENDING);
+    if (size <= 0) {
+        return SUCCESS;
+    }
+
+    int pending_count = (int)(size / (long)sizeof(LogSegmentInfo));
+    if (pending_count == 0) {
+        return SUCCESS;
+    }
+
+    FILE* file = fopen(LOG_RETENTION_PENDING, "rb");
+    if (!file) {
+        return SUCCESS;
+    }
+
+    LogSegmentInfo* loaded = (LogSegmentInfo*)safe_malloc(pending_count * sizeof(LogSegmentInfo));
+    if (!loaded) {
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    *count = (int)fread(loaded, sizeof(LogSegmentInfo), pending_count, file);
+    fclose(file);
+
+    if (*count == 0) {
+        safe_free((void**)&loaded);
+    }
+    *pending = loaded;
+    return SUCCESS;
+}
+
+// Helper function to record the segments awaiting removal
+static ErrorCode write_pending(const LogSegmentInfo* pending, int count) {
+    if (count == 0) {
+        remove(LOG_RETENTION_PENDING);
+        return SUCCESS;
+    }
+
+    char temp_path[128];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", LOG_RETENTION_PENDING);
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    int ok = fwrite(pending, sizeof(LogSegmentInfo), count, file) == (size_t)count;
+    fclose(file);
+
+    if (!ok) {
+        remove(temp_path);
+        return ERROR_FILE_OPERATION;
+    }
+
+    remove(LOG_RETENTION_PENDING);
+    if (rename(temp_path, LOG_RETENTION_PENDING) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+    return SUCCESS;
+}
+
+// Helper function to unlink the files of the segments dropped by an earlier
+// pass. A segment still in the manifest was recorded just before a drop that
+// did not happen, so its files are kept.
+static ErrorCode unlink_pending(const LogSegmentInfo* pending, int pending_count, LogRetentionStats* stats) {
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode result = log_store_list_segments(0, 0, &segments, &segment_count);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    for (int i = 0; i < pending_count; i++) {
+        int live = 0;
+        for (int j = 0; j < segment_count && !live; j++) {
+            live = segments[j].segment_id == pending[i].segment_id;
+        }
+        if (!live) {
+            remove_segment_files(&pending[i]);
+            stats->segments_unlinked++;
+        }
+    }
+
+    safe_free((void**)&segments);
+    return write_pending(NULL, 0);
+}
+
+// Helper function to roll up and drop the expired raw segments, oldest first
+static ErrorCode drop_expired_segments(const LogRetentionPolicy* policy, time_t cutoff, LogRetentionStats* stats) {
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode result = log_store_list_segments(0, 0, &segments, &segment_count);
+    if (result != SUCCESS || segment_count == 0) {
+        return result;
+    }
+
+    LogSegmentInfo* dropped = (LogSegmentInfo*)safe_malloc(segment_count * sizeof(LogSegmentInfo));
+    if (!dropped) {
+        safe_free((void**)&segments);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int dropped_count = 0;
+    for (int i = 0; i < segment_count && result == SUCCESS; i++) {
+        const LogSegmentInfo* info = &segments[i];
+        if (policy->segments_per_pass > 0 && dropped_count >= policy->segments_per_pass) {
+            break;
+        }
+        if (!info->sealed || info->max_timestamp >= cutoff) {
+            continue;
+        }
+
+        // The hourly rollup is durable before any raw record is given up, and
+        // the segment is recorded as pending before the manifest lets go of
+        // it, so a crash at any step leaves no file behind unaccounted for
+        result = log_aggregate_rollup_segment(info);
+        if (result == SUCCESS) {
+            dropped[dropped_count] = *info;
+            result = write_pending(dropped, dropped_count + 1);
+        }
+        if (result == SUCCESS) {
+            result = log_store_drop_segment(info->segment_id);
+            if (result == SUCCESS) {
+                dropped_count++;
+            } else {
+                write_pending(dropped, dropped_count);  // The next pass would skip it anyway
+            }
+        }
+    }
+
+    stats->segments_dropped = dropped_count;
+    safe_free((void**)&dropped);
+    safe_free((void**)&segments);
+    return result;
+}
+
+// Function to enforce a policy once: unlink the segments dropped by the
+// previous pass, drop the expired raw segments and delete expired rollups
+ErrorCode log_retention_run(const LogRetentionPolicy* policy, time_t now, LogRetentionStats* stats) {
+    if (!policy || policy->raw_days < 0 || policy->rollup_days < 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    LogRetentionStats local_stats;
+    if (!stats) {
+        stats = &local_stats;
+    }
+    memset(stats, 0, sizeof(LogRetentionStats));
+
+    pthread_mutex_lock(&pass_lock);
+
+    LogSegmentInfo* pending = NULL;
+    int pending_count = 0;
+    ErrorCode result = load_pending(&pending, &pending_count);
+    if (result == SUCCESS && pending_count > 0) {
+        result = unlink_pending(pending, pending_count, stats);
+    }
+    safe_free((void**)&pending);
+
+    if (result == SUCCESS && policy->raw_days > 0) {
+        result = drop_expired_segments(policy, now - (time_t)policy->raw_days * SECONDS_PER_DAY, stats);
+    }
+
+    if (result == SUCCESS && policy->rollup_days > 0) {
+        result = log_aggregate_expire_rollups(now - (time_t)policy->rollup_days * SECONDS_PER_DAY,
+                                              &stats->rollups_removed);
+    }
+
+    pthread_mutex_unlock(&pass_lock);
+
+    if (result != SUCCESS) {
+        log_error(result, "log_retention_run", "Retention pass failed");
+    }
+    return result;
+}
+
+// Background thread: one pass at start, then one per interval
+static void* retention_main(void* arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&retention_lock);
+    while (!retention_stopping) {
+        LogRetentionPolicy policy = retention_policy;
+        pthread_mutex_unlock(&retention_lock);
+
+        log_retention_run(&policy, time(NULL), NULL);
+
+        pthread_mutex_lock(&retention_lock);
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += policy.interval_seconds > 0 ? policy.interval_seconds : LOG_RETENTION_DEFAULT_INTERVAL;
+        while (!retention_stopping) {
+            if (pthread_cond_timedwait(&retention_wake, &retention_lock, &deadline) != 0) {
+                break;  // Timed out: time for the next pass
+            }
+        }
+    }
+    pthread_mutex_unlock(&retention_lock);
+
+    return NULL;
+}
+
+// Function to start enforcing a policy in the background
+ErrorCode log_retention_start(const LogRetentionPolicy* policy) {
+    LogRetentionPolicy chosen;
+    if (policy) {
+        chosen = *policy;
+    } else {
+        log_retention_default_policy(&chosen);
+    }
+    if (chosen.raw_days < 0 || chosen.rollup_days < 0 || chosen.interval_seconds < 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&retention_lock);
+
+    if (retention_running) {
+        retention_policy = chosen;  // The running thread picks it up on its next pass
+        pthread_mutex_unlock(&retention_lock);
+        return SUCCESS;
+    }
+
+    retention_policy = chosen;
+    retention_stopping = 0;
+    if (pthread_create(&retention_thread, NULL, retention_main, NULL) != 0) {
+        pthread_mutex_unlock(&retention_lock);
+        log_error(ERROR_FILE_OPERATION, "log_retention_start", "Could not start retention thread");
+        return ERROR_FILE_OPERATION;
+    }
+    retention_running = 1;
+
+    pthread_mutex_unlock(&retention_lock);
+    return SUCCESS;
+}
+
+// Function to stop background enforcement, waiting for a pass in progress
+void log_retention_stop() {
+    pthread_mutex_lock(&retention_lock);
+    if (!retention_running) {
+        pthread_mutex_unlock(&retention_lock);
+        return;
+    }
+    retention_stopping = 1;
+    pthread_cond_broadcast(&retention_wake);
+    pthread_mutex_unlock(&retention_lock);
+
+    pthread_join(retention_thread, NULL);
+
+    pthread_mutex_lock(&retention_lock);
+    retention_running = 0;
+    retention_stopping = 0;
+    pthread_mutex_unlock(&retention_lock);
+}
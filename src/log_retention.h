@@ -0,0 +1,46 @@
+#ifndef LOG_RETENTION_H
+#define LOG_RETENTION_H
+
+#include "data_structures.h"
+#include <time.h>
+
+// Retention of the audit log. Raw records are kept for raw_days: a sealed
+// segment whose newest record is older than that has its hourly summary
+// added to the rollups (log_aggregate.h) and is then dropped whole, by
+// removing it from the manifest and unlinking its files; nothing is
+// rewritten. Rollups are kept for rollup_days.
+//
+// Files of a dropped segment are unlinked on the following pass, so queries
+// that listed the segment before it was dropped can finish reading it. The
+// segments awaiting removal are recorded in LOG_RETENTION_PENDING before they
+// leave the manifest; an entry still in the manifest is never unlinked.
+#define LOG_RETENTION_PENDING "data/logs/RETENTION"
+#define LOG_RETENTION_DEFAULT_RAW_DAYS 90
+#define LOG_RETENTION_DEFAULT_ROLLUP_DAYS 730
+#define LOG_RETENTION_DEFAULT_INTERVAL 3600
+#define LOG_RETENTION_DEFAULT_SEGMENTS_PER_PASS 8
+
+typedef struct {
+    int raw_days;               // 0 keeps raw segments forever
+    int rollup_days;            // 0 keeps rollups forever
+    int interval_seconds;       // Time between background passes
+    int segments_per_pass;      // Segments dropped per pass, keeping passes short
+} LogRetentionPolicy;
+
+typedef struct {
+    int segments_dropped;       // Removed from the manifest by this pass
+    int segments_unlinked;      // Dropped earlier, files removed by this pass
+    int rollups_removed;        // Monthly rollup files deleted
+} LogRetentionStats;
+
+// Default policy: raw records 90 days, hourly rollups 2 years, hourly passes
+void log_retention_default_policy(LogRetentionPolicy* policy);
+
+// Running one pass as of now; stats may be NULL
+ErrorCode log_retention_run(const LogRetentionPolicy* policy, time_t now, LogRetentionStats* stats);
+
+// Background enforcement; a NULL policy uses the default
+ErrorCode log_retention_start(const LogRetentionPolicy* policy);
+void log_retention_stop();
+
+#endif // LOG_RETENTION_H
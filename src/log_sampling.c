@@ -0,0 +1,246 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_sampling.h"
+#include "utils.h"
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Policy with its sampling state and the counts of the current summary window
+typedef struct {
+    char module[MAX_MODULE_LEN];
+    char action[MAX_ACTION_LEN];
+    LogSamplePolicy policy;
+    long long sequence;           // Events seen under the policy, for 1-in-N
+    double tokens;
+    double last_refill;           // Monotonic seconds
+    long long window_seen;
+    long long window_suppressed;
+    int configured;               // Set by log_sampling_set_policy until cleared
+} SamplingSlot;
+
+// Global variables for the policy table; events skip the lock while it is empty
+static SamplingSlot slots[LOG_SAMPLING_MAX_POLICIES];
+static atomic_int slot_count = 0;
+static pthread_mutex_t sampling_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Global variables for the summary window
+static int summary_seconds = LOG_SAMPLING_DEFAULT_SUMMARY_SECONDS;
+static time_t window_start = 0;
+static atomic_llong pending_suppressed = 0;
+
+// Helper function to read a monotonic clock in seconds
+static double monotonic_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// Helper function to find the slot of a (module, action); caller holds sampling_lock
+static int find_slot(const char* module, const char* action) {
+    int count = atomic_load(&slot_count);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(slots[i].module, module) == 0 && strcmp(slots[i].action, action) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to set the policy of a (module, action)
+ErrorCode log_sampling_set_policy(const char* module, const char* action, const LogSamplePolicy* policy) {
+    if (!module || !action || !policy) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (policy->mode < LOG_SAMPLE_ALWAYS || policy->mode > LOG_SAMPLE_RATE_LIMIT ||
+        (policy->mode == LOG_SAMPLE_ONE_IN_N && policy->one_in <= 0) ||
+        (policy->mode == LOG_SAMPLE_RATE_LIMIT && (policy->rate_per_second <= 0 || policy->burst < 1))) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&sampling_lock);
+
+    int index = find_slot(module, action);
+    if (index < 0) {
+        index = atomic_load(&slot_count);
+        if (index >= LOG_SAMPLING_MAX_POLICIES) {
+            pthread_mutex_unlock(&sampling_lock);
+            return ERROR_INVALID_INPUT;
+        }
+        memset(&slots[index], 0, sizeof(SamplingSlot));
+        safe_strcpy(slots[index].module, module, sizeof(slots[index].module));
+        safe_strcpy(slots[index].action, action, sizeof(slots[index].action));
+        atomic_store(&slot_count, index + 1);
+    }
+
+    SamplingSlot* slot = &slots[index];
+    slot->policy = *policy;
+    slot->configured = 1;
+    slot->sequence = 0;
+    slot->tokens = policy->burst;
+    slot->last_refill = monotonic_seconds();
+    if (window_start == 0) {
+        window_start = time(NULL);
+    }
+
+    pthread_mutex_unlock(&sampling_lock);
+    return SUCCESS;
+}
+
+// Function to remove the policy of a (module, action); its events are always logged again.
+// Counts not yet collected are kept until the next summary.
+ErrorCode log_sampling_clear_policy(const char* module, const char* action) {
+    if (!module || !action) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&sampling_lock);
+
+    int index = find_slot(module, action);
+    if (index < 0) {
+        pthread_mutex_unlock(&sampling_lock);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    SamplingSlot* slot = &slots[index];
+    slot->policy.mode = LOG_SAMPLE_ALWAYS;
+    slot->configured = 0;
+    if (slot->window_suppressed == 0) {
+        int count = atomic_load(&slot_count);
+        *slot = slots[count - 1];
+        atomic_store(&slot_count, count - 1);
+    }
+
+    pthread_mutex_unlock(&sampling_lock);
+    return SUCCESS;
+}
+
+// Function to drop every policy and pending count
+void log_sampling_reset() {
+    pthread_mutex_lock(&sampling_lock);
+    atomic_store(&slot_count, 0);
+    atomic_store(&pending_suppressed, 0);
+    window_start = 0;
+    pthread_mutex_unlock(&sampling_lock);
+}
+
+// Function to set how often summaries of suppressed events are due
+ErrorCode log_sampling_set_summary_interval(int seconds) {
+    if (seconds <= 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&sampling_lock);
+    summary_seconds = seconds;
+    pthread_mutex_unlock(&sampling_lock);
+    return SUCCESS;
+}
+
+// Function to decide whether an event is logged
+int log_sampling_admit(const char* module, const char* action) {
+    if (atomic_load_explicit(&slot_count, memory_order_relaxed) == 0 || !module || !action) {
+        return 1;
+    }
+
+    pthread_mutex_lock(&sampling_lock);
+
+    int index = find_slot(module, action);
+    if (index < 0) {
+        pthread_mutex_unlock(&sampling_lock);
+        return 1;
+    }
+
+    SamplingSlot* slot = &slots[index];
+    int admit = 1;
+    switch (slot->policy.mode) {
+        case LOG_SAMPLE_ONE_IN_N:
+            admit = slot->sequence % slot->policy.one_in == 0;
+            slot->sequence++;
+            break;
+
+        case LOG_SAMPLE_RATE_LIMIT: {
+            double now = monotonic_seconds();
+            slot->tokens += (now - slot->last_refill) * slot->policy.rate_per_second;
+            if (slot->tokens > slot->policy.burst) {
+                slot->tokens = slot->policy.burst;
+            }
+            slot->last_refill = now;
+
+            admit = slot->tokens >= 1.0;
+            if (admit) {
+                slot->tokens -= 1.0;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    slot->window_seen++;
+    if (!admit) {
+        slot->window_suppressed++;
+        atomic_fetch_add(&pending_suppressed, 1);
+    }
+
+    pthread_mutex_unlock(&sampling_lock);
+    return admit;
+}
+
+// Function to check whether a summary window with suppressed events has ended
+int log_sampling_summary_due(time_t now) {
+    if (atomic_load_explicit(&pending_suppressed, memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&sampling_lock);
+    int due = window_start != 0 && now - window_start >= summary_seconds;
+    pthread_mutex_unlock(&sampling_lock);
+    return due;
+}
+
+// Function to take the suppressed counts of the current window
+int log_sampling_collect(time_t now, int force, LogSamplingSummary* out, int capacity) {
+    if (!out || capacity <= 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&sampling_lock);
+
+    if (!force && (window_start == 0 || now - window_start < summary_seconds)) {
+        pthread_mutex_unlock(&sampling_lock);
+        return 0;
+    }
+
+    int written = 0;
+    int count = atomic_load(&slot_count);
+    for (int i = 0; i < count && written < capacity; i++) {
+        SamplingSlot* slot = &slots[i];
+        if (slot->window_suppressed > 0) {
+            LogSamplingSummary* summary = &out[written++];
+            safe_strcpy(summary->module, slot->module, sizeof(summary->module));
+            safe_strcpy(summary->action, slot->action, sizeof(summary->action));
+            summary->seen = slot->window_seen;
+            summary->suppressed = slot->window_suppressed;
+            summary->window_start = window_start;
+            summary->window_end = now;
+            atomic_fetch_sub(&pending_suppressed, slot->window_suppressed);
+        }
+        slot->window_seen = 0;
+        slot->window_suppressed = 0;
+    }
+
+    // Cleared policies were only kept for their counts
+    for (int i = count - 1; i >= 0; i--) {
+        if (!slots[i].configured && slots[i].window_suppressed == 0) {
+            slots[i] = slots[count - 1];
+            count--;
+        }
+    }
+    atomic_store(&slot_count, count);
+
+    window_start = now;
+    pthread_mutex_unlock(&sampling_lock);
+    return written;
+}
@@ -0,0 +1,54 @@
+#ifndef LOG_SAMPLING_H
+#define LOG_SAMPLING_H
+
+#include "data_structures.h"
+#include <time.h>
+
+// Sampling and rate limiting of high-volume audit events, configured per
+// (module, action). Events without a policy are always logged, and write
+// actions go through log_write_action, which bypasses sampling. Suppressed
+// events are counted and handed back as summaries, so the log can record how
+// many of each event were left out and the trail stays statistically complete.
+
+#define LOG_SAMPLING_MAX_POLICIES 32
+#define LOG_SAMPLING_DEFAULT_SUMMARY_SECONDS 60
+
+typedef enum {
+    LOG_SAMPLE_ALWAYS = 0,      // Log every event
+    LOG_SAMPLE_ONE_IN_N = 1,    // Log the first of every one_in events
+    LOG_SAMPLE_RATE_LIMIT = 2   // Token bucket: rate_per_second, up to burst at once
+} LogSampleMode;
+
+typedef struct {
+    LogSampleMode mode;
+    int one_in;
+    double rate_per_second;
+    double burst;
+} LogSamplePolicy;
+
+// Suppressed events of one (module, action) over a summary window
+typedef struct {
+    char module[MAX_MODULE_LEN];
+    char action[MAX_ACTION_LEN];
+    long long seen;
+    long long suppressed;
+    time_t window_start;
+    time_t window_end;
+} LogSamplingSummary;
+
+// Policies
+ErrorCode log_sampling_set_policy(const char* module, const char* action, const LogSamplePolicy* policy);
+ErrorCode log_sampling_clear_policy(const char* module, const char* action);
+void log_sampling_reset();
+ErrorCode log_sampling_set_summary_interval(int seconds);
+
+// Decision for one event; returns 1 to log it, 0 when it is suppressed
+int log_sampling_admit(const char* module, const char* action);
+
+// Summaries: due reports whether a window has elapsed, collect takes the
+// pending counts (all of them when force is set) and starts a new window.
+// collect returns the number of summaries written to out.
+int log_sampling_summary_due(time_t now);
+int log_sampling_collect(time_t now, int force, LogSamplingSummary* out, int capacity);
+
+#endif // LOG_SAMPLING_H
@@ -0,0 +1,521 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_scan.h"
+#include "log_time_index.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// One unit of work: records [first, last) of a segment, and its matches
+typedef struct {
+    const LogSegmentInfo* segment;
+    long long first;
+    long long last;
+    LogEntry* results;
+    int count;
+    int capacity;
+    ErrorCode error;
+} ScanTask;
+
+// A query's tasks; workers claim them through next_task
+typedef struct {
+    const LogScanQuery* query;
+    ScanTask* tasks;
+    int task_count;
+    atomic_int next_task;
+} ScanJob;
+
+// Task and query threaded through a postings scan
+typedef struct {
+    ScanTask* task;
+    const LogScanQuery* query;
+} TaskVisit;
+
+// Global variables for the worker pool. query_lock gives one query at a time
+// the pool; a concurrent query runs its tasks on its own thread instead.
+static pthread_mutex_t query_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_idle = PTHREAD_COND_INITIALIZER;
+static pthread_t pool_threads[LOG_SCAN_MAX_WORKERS];
+static int pool_thread_count = 0;
+static int pool_stopping = 0;
+static ScanJob* current_job = NULL;
+static unsigned long job_generation = 0;
+static int busy_workers = 0;
+static int configured_workers = 0;
+
+// Function to set the worker count
+ErrorCode log_scan_set_workers(int workers) {
+    if (workers < 0 || workers > LOG_SCAN_MAX_WORKERS) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&query_lock);
+    configured_workers = workers;
+    pthread_mutex_unlock(&query_lock);
+
+    // The pool is resized by the next query
+    return SUCCESS;
+}
+
+// Function to get the worker count in effect
+int log_scan_get_workers() {
+    int workers = configured_workers;
+    if (workers == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (int)online : 1;
+    }
+    return workers > LOG_SCAN_MAX_WORKERS ? LOG_SCAN_MAX_WORKERS : workers;
+}
+
+// Helper function to add a record to a task's results
+static int task_append(ScanTask* task, const LogEntry* entry) {
+    if (task->count == task->capacity) {
+        int new_capacity = task->capacity > 0 ? task->capacity * 2 : 64;
+        LogEntry* grown = (LogEntry*)realloc(task->results, new_capacity * sizeof(LogEntry));
+        if (!grown) {
+            task->error = ERROR_MEMORY_ALLOCATION;
+            return 1;
+        }
+        task->results = grown;
+        task->capacity = new_capacity;
+    }
+
+    task->results[task->count++] = *entry;
+    return 0;
+}
+
+// Helper function to check a record against the query's time range and predicate
+static int query_accepts(const LogScanQuery* query, const LogEntry* entry) {
+    if ((query->start != 0 && entry->timestamp < query->start) ||
+        (query->end != 0 && entry->timestamp > query->end)) {
+        return 0;
+    }
+    return !query->predicate || query->predicate(entry, query->context);
+}
+
+// Helper function collecting the records a planned segment query hands over;
+// the filter has already checked them
+static int visit_planned_record(const LogEntry* entry, void* context) {
+    return task_append((ScanTask*)context, entry);
+}
+
+// Helper function collecting the records a postings scan hands over
+static int visit_posted_record(const LogEntry* entry, void* context) {
+    TaskVisit* visit = (TaskVisit*)context;
+    if (!query_accepts(visit->query, entry)) {
+        return 0;
+    }
+    return task_append(visit->task, entry);
+}
+
+// Helper function to stable-sort order[] by the timestamps of records
+static void merge_sort_order(const LogEntry* records, int* order, int* scratch, int count) {
+    if (count < 2) {
+        return;
+    }
+
+    int half = count / 2;
+    merge_sort_order(records, order, scratch, half);
+    merge_sort_order(records, order + half, scratch, count - half);
+
+    int left = 0;
+    int right = half;
+    int out = 0;
+    while (left < half && right < count) {
+        // Taking from the left on ties keeps append order
+        if (records[order[right]].timestamp < records[order[left]].timestamp) {
+            scratch[out++] = order[right++];
+        } else {
+            scratch[out++] = order[left++];
+        }
+    }
+    while (left < half) {
+        scratch[out++] = order[left++];
+    }
+    while (right < count) {
+        scratch[out++] = order[right++];
+    }
+    memcpy(order, scratch, count * sizeof(int));
+}
+
+// Helper function to put a task's results in timestamp order; records are
+// appended nearly in order, so the common case is only the check
+static void sort_task_results(ScanTask* task) {
+    int sorted = 1;
+    for (int i = 1; i < task->count && sorted; i++) {
+        sorted = task->results[i - 1].timestamp <= task->results[i].timestamp;
+    }
+    if (sorted) {
+        return;
+    }
+
+    int* order = (int*)safe_malloc(task->count * sizeof(int));
+    int* scratch = (int*)safe_malloc(task->count * sizeof(int));
+    LogEntry* ordered = (LogEntry*)safe_malloc(task->count * sizeof(LogEntry));
+    if (!order || !scratch || !ordered) {
+        task->error = ERROR_MEMORY_ALLOCATION;
+    } else {
+        for (int i = 0; i < task->count; i++) {
+            order[i] = i;
+        }
+        merge_sort_order(task->results, order, scratch, task->count);
+        for (int i = 0; i < task->count; i++) {
+            ordered[i] = task->results[order[i]];
+        }
+        free(task->results);
+        task->results = ordered;
+        task->capacity = task->count;
+        ordered = NULL;
+    }
+
+    safe_free((void**)&order);
+    safe_free((void**)&scratch);
+    safe_free((void**)&ordered);
+}
+
+// Helper function to run one task
+static void run_task(const LogScanQuery* query, ScanTask* task) {
+    if (query->filter) {
+        int stopped = 0;
+        ErrorCode result = log_query_segment(query->filter, task->segment, visit_planned_record, task, NULL,
+                                             &stopped);
+        if (result != SUCCESS && task->error == SUCCESS) {
+            task->error = result;
+        }
+    } else if (query->posting_key) {
+        TaskVisit visit = { task, query };
+        int stopped = 0;
+        ErrorCode result = log_postings_scan_segment(task->segment, query->posting_kind, query->posting_key,
+                                                     visit_posted_record, &visit, &stopped);
+        if (result != SUCCESS && task->error == SUCCESS) {
+            task->error = result;
+        }
+    } else {
+        LogSegmentReader reader;
+        ErrorCode result = log_segment_reader_open(task->segment, &reader);
+        if (result != SUCCESS) {
+            task->error = result;
+            return;
+        }
+
+        time_t max_skew = task->segment->max_skew;
+        log_segment_reader_seek(&reader, task->first);
+        for (long long index = task->first; index < task->last; index++) {
+            const LogEntry* entry = log_segment_reader_next(&reader);
+            if (!entry) {
+                break;
+            }
+            // No later record of the segment trails this one by more than max_skew
+            if (query->end != 0 && entry->timestamp - max_skew > query->end) {
+                break;
+            }
+            if (query_accepts(query, entry) && task_append(task, entry) != 0) {
+                break;
+            }
+        }
+        log_segment_reader_close(&reader);
+    }
+
+    if (task->error == SUCCESS) {
+        sort_task_results(task);
+    }
+}
+
+// Helper function to claim and run tasks until none are left
+static void run_job_tasks(ScanJob* job) {
+    int index;
+    while ((index = atomic_fetch_add(&job->next_task, 1)) < job->task_count) {
+        run_task(job->query, &job->tasks[index]);
+    }
+}
+
+// Worker thread: runs tasks of each job it is woken for
+static void* scan_worker_main(void* arg) {
+    (void)arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        while (!pool_stopping && job_generation == seen) {
+            pthread_cond_wait(&pool_wake, &pool_lock);
+        }
+        if (pool_stopping) {
+            break;
+        }
+
+        seen = job_generation;
+        ScanJob* job = current_job;
+        if (!job) {
+            continue;  // The job finished before this worker woke
+        }
+
+        busy_workers++;
+        pthread_mutex_unlock(&pool_lock);
+        run_job_tasks(job);
+        pthread_mutex_lock(&pool_lock);
+        if (--busy_workers == 0) {
+            pthread_cond_broadcast(&pool_idle);
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    return NULL;
+}
+
+// Helper function to stop the workers; caller holds query_lock
+static void stop_pool_locked() {
+    pthread_mutex_lock(&pool_lock);
+    pool_stopping = 1;
+    pthread_cond_broadcast(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (int i = 0; i < pool_thread_count; i++) {
+        pthread_join(pool_threads[i], NULL);
+    }
+
+    pool_thread_count = 0;
+    pool_stopping = 0;
+}
+
+// Helper function to size the pool for the worker count; caller holds query_lock.
+// The calling thread is one of the workers, so the pool holds one thread fewer.
+static void resize_pool_locked() {
+    int wanted = log_scan_get_workers() - 1;
+    if (pool_thread_count == wanted) {
+        return;
+    }
+
+    stop_pool_locked();
+    for (int i = 0; i < wanted; i++) {
+        if (pthread_create(&pool_threads[i], NULL, scan_worker_main, NULL) != 0) {
+            log_error(ERROR_FILE_OPERATION, "resize_pool_locked", "Could not start scan worker");
+            break;
+        }
+        pool_thread_count++;
+    }
+}
+
+// Function to stop the worker threads
+void log_scan_shutdown() {
+    pthread_mutex_lock(&query_lock);
+    stop_pool_locked();
+    pthread_mutex_unlock(&query_lock);
+}
+
+// Helper function to run a job on the pool, or on this thread alone when the
+// pool is busy with another query or there is nothing to share
+static void run_job(ScanJob* job) {
+    if (job->task_count < 2 || pthread_mutex_trylock(&query_lock) != 0) {
+        run_job_tasks(job);
+        return;
+    }
+
+    resize_pool_locked();
+
+    pthread_mutex_lock(&pool_lock);
+    current_job = job;
+    job_generation++;
+    pthread_cond_broadcast(&pool_wake);
+    pthread_mutex_unlock(&pool_lock);
+
+    run_job_tasks(job);
+
+    pthread_mutex_lock(&pool_lock);
+    while (busy_workers > 0) {
+        pthread_cond_wait(&pool_idle, &pool_lock);
+    }
+    current_job = NULL;
+    pthread_mutex_unlock(&pool_lock);
+
+    pthread_mutex_unlock(&query_lock);
+}
+
+// Helper function to split the query's segments into tasks
+static ErrorCode plan_tasks(const LogScanQuery* query, const LogSegmentInfo* segments, int segment_count,
+                            ScanTask** tasks, int* task_count) {
+    int capacity = 0;
+    for (int i = 0; i < segment_count; i++) {
+        int whole_segment = query->posting_key || query->filter;
+        capacity += whole_segment ? 1 : (int)(segments[i].record_count / LOG_SCAN_TASK_RECORDS) + 1;
+    }
+
+    *tasks = (ScanTask*)safe_malloc(capacity * sizeof(ScanTask));
+    if (!*tasks) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(*tasks, 0, capacity * sizeof(ScanTask));
+
+    int count = 0;
+    for (int i = 0; i < segment_count; i++) {
+        const LogSegmentInfo* info = &segments[i];
+
+        if (query->posting_key || query->filter) {
+            ScanTask* task = &(*tasks)[count++];
+            task->segment = info;
+            task->first = 0;
+            task->last = info->record_count;
+            continue;
+        }
+
+        // Enter the segment at the first index block that can reach start
+        long long first = 0;
+        if (query->start != 0 && info->min_timestamp < query->start) {
+            LogTimeIndexEntry* entries = NULL;
+            int entry_count = 0;
+            if (log_time_index_load(info, &entries, &entry_count) == SUCCESS && entry_count > 0) {
+                first = log_time_index_find_start(entries, entry_count, query->start);
+            }
+            safe_free((void**)&entries);
+        }
+
+        // Ranges end on multiples of the task size, which keeps them aligned
+        // with columnar blocks
+        while (first < info->record_count) {
+            long long last = (first / LOG_SCAN_TASK_RECORDS + 1) * LOG_SCAN_TASK_RECORDS;
+            if (last > info->record_count) {
+                last = info->record_count;
+            }
+
+            ScanTask* task = &(*tasks)[count++];
+            task->segment = info;
+            task->first = first;
+            task->last = last;
+            first = last;
+        }
+    }
+
+    *task_count = count;
+    return SUCCESS;
+}
+
+// Helper function to merge the sorted task results in timestamp order.
+// A binary heap of task positions orders by timestamp, then task, so equal
+// timestamps keep append order.
+static ErrorCode merge_task_results(ScanTask* tasks, int task_count, LogEntry** results, int* count) {
+    long long total = 0;
+    for (int i = 0; i < task_count; i++) {
+        total += tasks[i].count;
+    }
+    if (total == 0) {
+        return SUCCESS;
+    }
+    if (total > 0x7fffffff) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    LogEntry* merged = (LogEntry*)safe_malloc(total * sizeof(LogEntry));
+    int* heap = (int*)safe_malloc(task_count * sizeof(int));
+    int* position = (int*)safe_malloc(task_count * sizeof(int));
+    if (!merged || !heap || !position) {
+        safe_free((void**)&merged);
+        safe_free((void**)&heap);
+        safe_free((void**)&position);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+#define HEAD_TIME(t) (tasks[(t)].results[position[(t)]].timestamp)
+#define HEAP_LESS(a, b) (HEAD_TIME(a) < HEAD_TIME(b) || (HEAD_TIME(a) == HEAD_TIME(b) && (a) < (b)))
+
+    int heap_size = 0;
+    for (int i = 0; i < task_count; i++) {
+        position[i] = 0;
+        if (tasks[i].count == 0) {
+            continue;
+        }
+        int child = heap_size++;
+        heap[child] = i;
+        while (child > 0 && HEAP_LESS(heap[child], heap[(child - 1) / 2])) {
+            int parent = (child - 1) / 2;
+            int swap = heap[child];
+            heap[child] = heap[parent];
+            heap[parent] = swap;
+            child = parent;
+        }
+    }
+
+    int out = 0;
+    while (heap_size > 0) {
+        int task = heap[0];
+        merged[out++] = tasks[task].results[position[task]++];
+
+        if (position[task] == tasks[task].count) {
+            heap[0] = heap[--heap_size];
+        }
+
+        int parent = 0;
+        for (;;) {
+            int smallest = parent;
+            int left = 2 * parent + 1;
+            int right = left + 1;
+            if (left < heap_size && HEAP_LESS(heap[left], heap[smallest])) {
+                smallest = left;
+            }
+            if (right < heap_size && HEAP_LESS(heap[right], heap[smallest])) {
+                smallest = right;
+            }
+            if (smallest == parent) {
+                break;
+            }
+            int swap = heap[parent];
+            heap[parent] = heap[smallest];
+            heap[smallest] = swap;
+            parent = smallest;
+        }
+    }
+
+#undef HEAP_LESS
+#undef HEAD_TIME
+
+    safe_free((void**)&heap);
+    safe_free((void**)&position);
+    *results = merged;
+    *count = out;
+    return SUCCESS;
+}
+
+// Function to run a query on the scan engine
+ErrorCode log_scan_collect(const LogScanQuery* query, LogEntry** results, int* count) {
+    if (!query || !results || !count || (query->start != 0 && query->end != 0 && query->end < query->start)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    *results = NULL;
+    *count = 0;
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    ErrorCode result = log_store_list_segments(query->start, query->end, &segments, &segment_count);
+    if (result != SUCCESS || segment_count == 0) {
+        return result;
+    }
+
+    ScanJob job;
+    job.query = query;
+    job.tasks = NULL;
+    job.task_count = 0;
+    atomic_init(&job.next_task, 0);
+
+    result = plan_tasks(query, segments, segment_count, &job.tasks, &job.task_count);
+    if (result == SUCCESS) {
+        run_job(&job);
+
+        for (int i = 0; i < job.task_count && result == SUCCESS; i++) {
+            result = job.tasks[i].error;
+        }
+        if (result == SUCCESS) {
+            result = merge_task_results(job.tasks, job.task_count, results, count);
+        }
+    }
+
+    for (int i = 0; i < job.task_count; i++) {
+        safe_free((void**)&job.tasks[i].results);
+    }
+    safe_free((void**)&job.tasks);
+    safe_free((void**)&segments);
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef LOG_SCAN_H
+#define LOG_SCAN_H
+
+#include "data_structures.h"
+#include "log_query.h"
+#include "log_postings.h"
+#include <time.h>
+
+// Parallel scan engine. A query is split into tasks (ranges of up to
+// LOG_SCAN_TASK_RECORDS records of a segment, or one segment when it is read
+// through the postings index or planned by log_query_segment) that a pool of worker threads runs alongside
+// the calling thread. Each task collects its matches and orders them by
+// timestamp; the caller merges the task results, so the final result set is
+// in timestamp order, ties kept in append order.
+//
+// The predicate is called from several threads at once and must be thread-safe.
+
+#define LOG_SCAN_TASK_RECORDS 16384
+#define LOG_SCAN_MAX_WORKERS 64
+
+typedef struct {
+    time_t start;                 // 0 leaves a bound open
+    time_t end;
+    LogPredicate predicate;       // NULL accepts every record
+    void* context;
+    const char* posting_key;      // When set, only records whose field equals it,
+    LogPostingKind posting_kind;  // read through the postings index
+    const LogQuery* filter;       // When set, records matching it, each segment planned by log_query_segment
+} LogScanQuery;
+
+// Worker count, including the calling thread; 0 means one per online CPU
+ErrorCode log_scan_set_workers(int workers);
+int log_scan_get_workers();
+
+// Running a query into a newly allocated array (NULL when nothing matched)
+ErrorCode log_scan_collect(const LogScanQuery* query, LogEntry** results, int* count);
+
+// Stopping the worker threads; they are started again by the next query
+void log_scan_shutdown();
+
+#endif // LOG_SCAN_H
@@ -0,0 +1,1429 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_store.h"
+#include "log_time_index.h"
+#include "log_postings.h"
+#include "log_bloom.h"
+#include "log_aggregate.h"
+#include "log_columnar.h"
+#include "crc32c.h"
+#include "file_io.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define close _close
+#define fileno _fileno
+#define ftruncate _chsize
+#else
+#include <unistd.h>
+#endif
+
+#define MANIFEST_MAGIC "LGMF"
+#define MANIFEST_VERSION 2
+#define STORE_BUFFER_SIZE (256 * 1024)
+#define CHECKPOINT_MAGIC "LCKP"
+#define RECOVERY_BATCH_FRAMES 256
+
+// Manifest file header
+typedef struct {
+    char magic[4];
+    int version;
+    int segment_count;
+    int next_segment_id;
+    int entry_size;     // sizeof(LogSegmentInfo) when written; fields are only ever appended
+} ManifestHeader;
+
+// Checkpoint file: records of a segment known to be durable
+typedef struct {
+    char magic[4];
+    int segment_id;
+    long long record_count;
+    uint32_t crc;       // Of the fields above
+    uint32_t reserved;
+} CheckpointRecord;
+
+// Manifest version 1 predates the entry_size header field and max_skew
+#define MANIFEST_V1_HEADER_SIZE (offsetof(ManifestHeader, entry_size))
+#define MANIFEST_V1_ENTRY_SIZE (offsetof(LogSegmentInfo, max_skew))
+
+// Global variables for the segment store
+static LogSegmentInfo* segments = NULL;
+static int segment_count = 0;
+static int segment_capacity = 0;
+static int next_segment_id = 1;
+static int store_open = 0;
+static LogStoreConfig store_config = { LOG_STORE_DEFAULT_SEGMENT_BYTES };
+static pthread_mutex_t store_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Active (unsealed) segment being appended to
+static FILE* active_file = NULL;
+static char* active_buffer = NULL;
+static long long active_bytes = 0;
+static time_t active_partition_end = 0;
+static LogTimeIndexBuilder active_index;
+
+// Compaction of sealed segments. Passes are serialized; a background worker
+// runs one after each rotation so appends never wait on archiving.
+static int compaction_failed_id = -1;
+static pthread_mutex_t compaction_pass_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t compaction_thread;
+static int compaction_worker_running = 0;
+static int compaction_stopping = 0;
+static int compaction_requested = 0;
+static pthread_mutex_t compaction_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t compaction_wake = PTHREAD_COND_INITIALIZER;
+
+// Checkpoint of the active segment, advanced after each sync
+static FILE* checkpoint_file = NULL;
+static int checkpoint_segment_id = 0;
+static long long checkpoint_records = 0;
+static pthread_mutex_t checkpoint_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Helper function to get local midnight for a timestamp
+static time_t local_midnight(time_t timestamp) {
+    struct tm timeinfo;
+    localtime_r(&timestamp, &timeinfo);
+    timeinfo.tm_hour = 0;
+    timeinfo.tm_min = 0;
+    timeinfo.tm_sec = 0;
+    timeinfo.tm_isdst = -1;
+    return mktime(&timeinfo);
+}
+
+// Helper function to get the local midnight that follows a partition start
+static time_t next_local_midnight(time_t midnight) {
+    struct tm timeinfo;
+    localtime_r(&midnight, &timeinfo);
+    timeinfo.tm_mday += 1;
+    timeinfo.tm_hour = 0;
+    timeinfo.tm_min = 0;
+    timeinfo.tm_sec = 0;
+    timeinfo.tm_isdst = -1;
+    return mktime(&timeinfo);
+}
+
+// Helper function to get the active segment, if any; caller holds store_lock
+static LogSegmentInfo* active_segment_locked() {
+    if (segment_count > 0 && !segments[segment_count - 1].sealed) {
+        return &segments[segment_count - 1];
+    }
+    return NULL;
+}
+
+// Helper function to fold one record into a segment's statistics
+static void account_record(LogSegmentInfo* info, const LogEntry* entry) {
+    if (info->record_count == 0 || entry->timestamp < info->min_timestamp) {
+        info->min_timestamp = entry->timestamp;
+    }
+    if (info->record_count > 0 && info->max_timestamp - entry->timestamp > info->max_skew) {
+        info->max_skew = info->max_timestamp - entry->timestamp;
+    }
+    if (info->record_count == 0 || entry->timestamp > info->max_timestamp) {
+        info->max_timestamp = entry->timestamp;
+    }
+    info->record_count++;
+}
+
+// Helper function to get the on-disk size of one record of a raw or framed segment
+static long long record_size(int format) {
+    return format == LOG_SEGMENT_FRAMED ? (long long)sizeof(LogFrame) : (long long)sizeof(LogEntry);
+}
+
+// Helper function to compute the checksum of a checkpoint record
+static uint32_t checkpoint_crc(const CheckpointRecord* record) {
+    return crc32c(0, record, offsetof(CheckpointRecord, crc));
+}
+
+// Helper function to record that the first record_count records of a segment
+// are durable. Checkpoints only move forward, so a slow sync finishing after
+// a faster one cannot move it back.
+static void write_checkpoint(int segment_id, long long record_count) {
+    pthread_mutex_lock(&checkpoint_lock);
+
+    if (segment_id < checkpoint_segment_id ||
+        (segment_id == checkpoint_segment_id && record_count <= checkpoint_records)) {
+        pthread_mutex_unlock(&checkpoint_lock);
+        return;
+    }
+
+    if (!checkpoint_file) {
+        checkpoint_file = fopen(LOG_STORE_CHECKPOINT, "wb");
+    }
+    if (checkpoint_file) {
+        CheckpointRecord record;
+        memset(&record, 0, sizeof(record));
+        memcpy(record.magic, CHECKPOINT_MAGIC, sizeof(record.magic));
+        record.segment_id = segment_id;
+        record.record_count = record_count;
+        record.crc = checkpoint_crc(&record);
+
+        // The file is not synced itself: a lost update only leaves an older
+        // checkpoint, which makes recovery verify more frames
+        if (fseek(checkpoint_file, 0, SEEK_SET) == 0 &&
+            fwrite(&record, sizeof(record), 1, checkpoint_file) == 1 && fflush(checkpoint_file) == 0) {
+            checkpoint_segment_id = segment_id;
+            checkpoint_records = record_count;
+        }
+    }
+
+    pthread_mutex_unlock(&checkpoint_lock);
+}
+
+// Helper function to read the checkpoint of a segment; returns 0 when none applies
+static long long read_checkpoint(int segment_id) {
+    FILE* file = fopen(LOG_STORE_CHECKPOINT, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    CheckpointRecord record;
+    int ok = fread(&record, sizeof(record), 1, file) == 1;
+    fclose(file);
+
+    if (!ok || memcmp(record.magic, CHECKPOINT_MAGIC, sizeof(record.magic)) != 0 ||
+        record.crc != checkpoint_crc(&record) || record.segment_id != segment_id || record.record_count < 0) {
+        return 0;
+    }
+    return record.record_count;
+}
+
+// Helper function to make room for one more manifest entry; caller holds store_lock
+static ErrorCode grow_segments_locked() {
+    if (segment_count < segment_capacity) {
+        return SUCCESS;
+    }
+
+    int new_capacity = segment_capacity > 0 ? segment_capacity * 2 : 16;
+    LogSegmentInfo* grown = (LogSegmentInfo*)realloc(segments, new_capacity * sizeof(LogSegmentInfo));
+    if (!grown) {
+        log_error(ERROR_MEMORY_ALLOCATION, "grow_segments_locked", "Failed to grow segment manifest");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    segments = grown;
+    segment_capacity = new_capacity;
+    return SUCCESS;
+}
+
+// Helper function to persist the manifest atomically; caller holds store_lock
+static ErrorCode write_manifest_locked() {
+    char temp_path[128];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", LOG_STORE_MANIFEST);
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        log_error(ERROR_FILE_OPERATION, "write_manifest_locked", "Could not open manifest for writing");
+        return ERROR_FILE_OPERATION;
+    }
+
+    ManifestHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MANIFEST_MAGIC, sizeof(header.magic));
+    header.version = MANIFEST_VERSION;
+    header.segment_count = segment_count;
+    header.next_segment_id = next_segment_id;
+    header.entry_size = (int)sizeof(LogSegmentInfo);
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        (segment_count > 0 &&
+         fwrite(segments, sizeof(LogSegmentInfo), segment_count, file) != (size_t)segment_count)) {
+        fclose(file);
+        remove(temp_path);
+        log_error(ERROR_FILE_OPERATION, "write_manifest_locked", "Could not write manifest");
+        return ERROR_FILE_OPERATION;
+    }
+
+    fclose(file);
+
+    // Replace the old manifest in one step so readers never see a partial file
+    remove(LOG_STORE_MANIFEST);
+    if (rename(temp_path, LOG_STORE_MANIFEST) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Helper function to read a manifest file into a new array; a missing
+// manifest means an empty store
+static ErrorCode read_manifest_file(LogSegmentInfo** result_segments, int* result_count, int* next_id) {
+    *result_segments = NULL;
+    *result_count = 0;
+
+    FILE* file = fopen(LOG_STORE_MANIFEST, "rb");
+    if (!file) {
+        return SUCCESS;
+    }
+
+    ManifestHeader header;
+    memset(&header, 0, sizeof(header));
+    if (fread(&header, MANIFEST_V1_HEADER_SIZE, 1, file) != 1 ||
+        memcmp(header.magic, MANIFEST_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version < 1 || header.version > MANIFEST_VERSION || header.segment_count < 0) {
+        fclose(file);
+        log_error(ERROR_FILE_OPERATION, "read_manifest_file", "Log manifest is corrupt");
+        return ERROR_FILE_OPERATION;
+    }
+
+    if (header.version == 1) {
+        header.entry_size = (int)MANIFEST_V1_ENTRY_SIZE;
+    } else if (fread(&header.entry_size, sizeof(header.entry_size), 1, file) != 1 ||
+               header.entry_size <= 0) {
+        fclose(file);
+        log_error(ERROR_FILE_OPERATION, "read_manifest_file", "Log manifest is corrupt");
+        return ERROR_FILE_OPERATION;
+    }
+
+    LogSegmentInfo* loaded = NULL;
+    if (header.segment_count > 0) {
+        loaded = (LogSegmentInfo*)calloc(header.segment_count, sizeof(LogSegmentInfo));
+        if (!loaded) {
+            fclose(file);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    }
+
+    // Older manifests have shorter entries: fields they lack read as zero
+    size_t stored_size = (size_t)header.entry_size;
+    size_t copy_size = stored_size < sizeof(LogSegmentInfo) ? stored_size : sizeof(LogSegmentInfo);
+
+    for (int i = 0; i < header.segment_count; i++) {
+        if (fread(&loaded[i], copy_size, 1, file) != 1 ||
+            (stored_size > copy_size && fseek(file, (long)(stored_size - copy_size), SEEK_CUR) != 0)) {
+            fclose(file);
+            free(loaded);
+            log_error(ERROR_FILE_OPERATION, "read_manifest_file", "Log manifest is truncated");
+            return ERROR_FILE_OPERATION;
+        }
+    }
+
+    fclose(file);
+    *result_segments = loaded;
+    *result_count = header.segment_count;
+    if (next_id) {
+        *next_id = header.next_segment_id;
+    }
+    return SUCCESS;
+}
+
+// Helper function to load the manifest; caller holds store_lock
+static ErrorCode load_manifest_locked() {
+    LogSegmentInfo* loaded = NULL;
+    int loaded_count = 0;
+    int loaded_next_id = next_segment_id;
+    ErrorCode result = read_manifest_file(&loaded, &loaded_count, &loaded_next_id);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    free(segments);
+    segments = loaded;
+    segment_count = loaded_count;
+    segment_capacity = loaded_count;
+    next_segment_id = loaded_next_id;
+    return SUCCESS;
+}
+
+// Helper function to scan a raw or framed segment from a record index up to
+// end_index (-1 for the end of the file) and update its statistics
+static ErrorCode scan_segment_tail(const char* path, LogSegmentInfo* info, long long from_index, long long end_index) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    if (fseek(file, (long)(from_index * record_size(info->format)), SEEK_SET) != 0) {
+        fclose(file);
+        return ERROR_FILE_OPERATION;
+    }
+
+    info->record_count = from_index;
+    LogFrame frame;
+    while (end_index < 0 || info->record_count < end_index) {
+        if (info->format == LOG_SEGMENT_FRAMED) {
+            if (fread(&frame, sizeof(LogFrame), 1, file) != 1) {
+                break;
+            }
+        } else if (fread(&frame.entry, sizeof(LogEntry), 1, file) != 1) {
+            break;
+        }
+        account_record(info, &frame.entry);
+    }
+
+    fclose(file);
+    return SUCCESS;
+}
+
+// Helper function to verify the frames of a segment file from a record index
+// on; returns the number of records before the first torn or corrupt frame
+static long long verify_frames(FILE* file, long long from_index, long long file_records) {
+    if (from_index >= file_records) {
+        return file_records;
+    }
+    if (fseek(file, (long)(from_index * (long long)sizeof(LogFrame)), SEEK_SET) != 0) {
+        return from_index;
+    }
+
+    LogFrame* batch = (LogFrame*)safe_malloc(RECOVERY_BATCH_FRAMES * sizeof(LogFrame));
+    if (!batch) {
+        return from_index;
+    }
+
+    long long valid = from_index;
+    int intact = 1;
+    while (intact && valid < file_records) {
+        size_t wanted = file_records - valid < RECOVERY_BATCH_FRAMES ? (size_t)(file_records - valid)
+                                                                      : RECOVERY_BATCH_FRAMES;
+        size_t read_count = fread(batch, sizeof(LogFrame), wanted, file);
+        for (size_t i = 0; i < read_count; i++) {
+            if (batch[i].length != sizeof(LogEntry) ||
+                batch[i].crc != crc32c(0, &batch[i].entry, sizeof(LogEntry))) {
+                intact = 0;
+                break;
+            }
+            valid++;
+        }
+        if (read_count < wanted) {
+            break;
+        }
+    }
+
+    safe_free((void**)&batch);
+    return valid;
+}
+
+// Helper function to cut a segment file back to its last intact frame
+static ErrorCode truncate_segment_file(const char* path, long long size) {
+    FILE* file = fopen(path, "r+b");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    int ok = ftruncate(fileno(file), (off_t)size) == 0;
+    fclose(file);
+    return ok ? SUCCESS : ERROR_FILE_OPERATION;
+}
+
+// Helper function to recover a framed active segment after a restart. Frames
+// up to the checkpoint were synced before it was written and are trusted;
+// only the tail after it is verified.
+static ErrorCode recover_framed_segment_locked(const char* path, LogSegmentInfo* active, long long size) {
+    long long file_records = size / (long long)sizeof(LogFrame);
+    long long checkpoint = read_checkpoint(active->segment_id);
+    if (checkpoint > file_records) {
+        checkpoint = 0;  // The file lost synced data; trust nothing
+    }
+
+    long long valid_records = file_records;
+    if (checkpoint < file_records || size % (long long)sizeof(LogFrame) != 0) {
+        FILE* file = fopen(path, "rb");
+        if (!file) {
+            return ERROR_FILE_OPERATION;
+        }
+        valid_records = verify_frames(file, checkpoint, file_records);
+        fclose(file);
+    }
+
+    if (valid_records * (long long)sizeof(LogFrame) < size) {
+        if (truncate_segment_file(path, valid_records * (long long)sizeof(LogFrame)) != SUCCESS) {
+            log_error(ERROR_FILE_OPERATION, "recover_framed_segment_locked", "Could not truncate torn log records");
+            return ERROR_FILE_OPERATION;
+        }
+        // Expected after a crash mid-write: recovery worked, so only warn
+        log_warning("recover_framed_segment_locked",
+                    "Discarded torn or corrupt records at the end of the active log segment");
+    }
+
+    // The manifest is only rewritten on rotation and close; pick up records
+    // written since, or recount if it covers records that were discarded
+    if (valid_records != active->record_count) {
+        long long from_index = valid_records > active->record_count ? active->record_count : 0;
+        return scan_segment_tail(path, active, from_index, valid_records);
+    }
+    return SUCCESS;
+}
+
+// Helper function to build a segment file name from its partition day
+static void build_segment_name(LogSegmentInfo* info) {
+    struct tm timeinfo;
+    char day[9];
+    localtime_r(&info->partition_start, &timeinfo);
+    strftime(day, sizeof(day), "%Y%m%d", &timeinfo);
+    snprintf(info->file_name, sizeof(info->file_name), "seg-%s-%06d.dat", day, info->segment_id);
+}
+
+// Helper function to adopt a pre-segmentation data/logs.dat as a sealed segment
+static ErrorCode import_legacy_log_locked() {
+    long size = get_file_size(LOG_STORE_LEGACY_FILE);
+    if (size <= 0) {
+        return SUCCESS;
+    }
+
+    ErrorCode result = grow_segments_locked();
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    LogSegmentInfo info;
+    memset(&info, 0, sizeof(info));
+    info.segment_id = next_segment_id;
+    info.format = LOG_SEGMENT_RAW;
+    info.sealed = 1;
+
+    result = scan_segment_tail(LOG_STORE_LEGACY_FILE, &info, 0, -1);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    // Legacy history sorts before everything already in the store
+    if (segment_count > 0) {
+        memmove(&segments[1], &segments[0], segment_count * sizeof(LogSegmentInfo));
+        for (int i = 1; i <= segment_count; i++) {
+            segments[i].base_sequence += info.record_count;
+        }
+    }
+
+    info.partition_start = local_midnight(info.min_timestamp);
+    build_segment_name(&info);
+
+    char path[128];
+    log_store_segment_path(&info, path, sizeof(path));
+    if (rename(LOG_STORE_LEGACY_FILE, path) != 0) {
+        if (segment_count > 0) {
+            memmove(&segments[0], &segments[1], segment_count * sizeof(LogSegmentInfo));
+            for (int i = 0; i < segment_count; i++) {
+                segments[i].base_sequence -= info.record_count;
+            }
+        }
+        log_error(ERROR_FILE_OPERATION, "import_legacy_log_locked", "Could not move legacy log into the store");
+        return ERROR_FILE_OPERATION;
+    }
+
+    segments[0] = info;
+    segment_count++;
+    next_segment_id++;
+
+    // Index the adopted history once so date-range and key queries can seek into it
+    log_time_index_build(&info);
+    log_postings_build(&info);
+    return SUCCESS;
+}
+
+// Helper function to reconcile the active segment with its file after a restart
+static ErrorCode recover_active_segment_locked() {
+    LogSegmentInfo* active = active_segment_locked();
+    if (!active) {
+        return SUCCESS;
+    }
+
+    char path[128];
+    log_store_segment_path(active, path, sizeof(path));
+
+    long size = get_file_size(path);
+    if (size < 0) {
+        size = 0;
+    }
+
+    if (active->format == LOG_SEGMENT_FRAMED) {
+        return recover_framed_segment_locked(path, active, size);
+    }
+
+    // The manifest is only rewritten on rotation and close; pick up records written since
+    long long file_records = size / (long long)sizeof(LogEntry);
+    if (file_records != active->record_count) {
+        long long from_index = file_records > active->record_count ? active->record_count : 0;
+        return scan_segment_tail(path, active, from_index, -1);
+    }
+
+    return SUCCESS;
+}
+
+// Helper function to open the active segment for appending; caller holds store_lock
+static ErrorCode open_active_file_locked() {
+    LogSegmentInfo* active = active_segment_locked();
+    if (!active || active_file) {
+        return SUCCESS;
+    }
+
+    char path[128];
+    log_store_segment_path(active, path, sizeof(path));
+
+    active_file = fopen(path, "ab");
+    if (!active_file) {
+        log_error(ERROR_FILE_OPERATION, "open_active_file_locked", "Could not open active log segment");
+        return ERROR_FILE_OPERATION;
+    }
+
+    active_buffer = (char*)safe_malloc(STORE_BUFFER_SIZE);
+    if (active_buffer) {
+        setvbuf(active_file, active_buffer, _IOFBF, STORE_BUFFER_SIZE);
+    }
+
+    active_bytes = active->record_count * record_size(active->format);
+    active_partition_end = next_local_midnight(active->partition_start);
+
+    if (log_time_index_builder_open(&active_index, active) != SUCCESS) {
+        log_error(ERROR_FILE_OPERATION, "open_active_file_locked", "Could not open time index for active segment");
+    }
+    if (log_postings_active_open(active) != SUCCESS) {
+        log_error(ERROR_FILE_OPERATION, "open_active_file_locked", "Could not open postings for active segment");
+    }
+    return SUCCESS;
+}
+
+// Helper function to flush, sync and close the active file; caller holds store_lock
+static void close_active_file_locked(int sync) {
+    if (!active_file) {
+        return;
+    }
+
+    int flushed = fflush(active_file) == 0;
+#ifndef _WIN32
+    if (sync && flushed && fdatasync(fileno(active_file)) == 0) {
+#else
+    if (sync && flushed && _commit(fileno(active_file)) == 0) {
+#endif
+        LogSegmentInfo* active = active_segment_locked();
+        if (active) {
+            write_checkpoint(active->segment_id, active->record_count);
+        }
+    }
+    fclose(active_file);
+    active_file = NULL;
+    safe_free((void**)&active_buffer);
+
+    log_time_index_builder_close(&active_index);
+}
+
+static void request_compaction();
+
+// Helper function to open the store; caller holds store_lock
+static ErrorCode open_store_locked() {
+    if (store_open) {
+        return SUCCESS;
+    }
+
+    ErrorCode result = ensure_directory_exists("data");
+    if (result == SUCCESS) {
+        result = ensure_directory_exists(LOG_STORE_DIR);
+    }
+    if (result == SUCCESS) {
+        result = load_manifest_locked();
+    }
+    if (result == SUCCESS) {
+        result = import_legacy_log_locked();
+    }
+    if (result == SUCCESS) {
+        result = recover_active_segment_locked();
+    }
+    if (result == SUCCESS) {
+        result = write_manifest_locked();
+    }
+
+    if (result != SUCCESS) {
+        free(segments);
+        segments = NULL;
+        segment_count = 0;
+        segment_capacity = 0;
+        return result;
+    }
+
+    store_open = 1;
+    return SUCCESS;
+}
+
+// Helper function to seal the active segment and start a new one for entry
+static ErrorCode rotate_locked(const LogEntry* entry) {
+    LogSegmentInfo* active = active_segment_locked();
+    if (active) {
+        // A sealed segment is complete and durable before it is published as such
+        close_active_file_locked(1);
+        active->sealed = 1;
+        log_postings_active_seal(active);
+    }
+
+    ErrorCode result = grow_segments_locked();
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    LogSegmentInfo info;
+    memset(&info, 0, sizeof(info));
+    info.segment_id = next_segment_id++;
+    info.format = LOG_SEGMENT_FRAMED;
+    info.partition_start = local_midnight(entry->timestamp);
+    if (segment_count > 0) {
+        const LogSegmentInfo* last = &segments[segment_count - 1];
+        info.base_sequence = last->base_sequence + last->record_count;
+    }
+    build_segment_name(&info);
+
+    segments[segment_count++] = info;
+
+    result = write_manifest_locked();
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    return open_active_file_locked();
+}
+
+// Function to configure segment rotation
+ErrorCode log_store_configure(const LogStoreConfig* config) {
+    if (!config || config->max_segment_bytes < (long long)sizeof(LogFrame)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&store_lock);
+    store_config = *config;
+    pthread_mutex_unlock(&store_lock);
+
+    return SUCCESS;
+}
+
+// Function to open the store, importing a legacy data/logs.dat if present
+ErrorCode log_store_open() {
+    pthread_mutex_lock(&store_lock);
+
+    ErrorCode result = open_store_locked();
+    if (result == SUCCESS) {
+        result = open_active_file_locked();
+    }
+
+    pthread_mutex_unlock(&store_lock);
+
+    // Segments sealed before a crash may still await archiving
+    if (result == SUCCESS) {
+        request_compaction();
+    }
+    return result;
+}
+
+// Function to append a record, rotating to a new segment on a day change or size cap
+ErrorCode log_store_append(const LogEntry* entry) {
+    if (!entry) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&store_lock);
+
+    ErrorCode result = open_store_locked();
+    if (result == SUCCESS) {
+        result = open_active_file_locked();
+    }
+
+    int rotated = 0;
+    if (result == SUCCESS) {
+        // Late entries from a previous day stay in the current segment; only move forward
+        if (!active_file || entry->timestamp >= active_partition_end ||
+            active_bytes + record_size(active_segment_locked()->format) > store_config.max_segment_bytes) {
+            result = rotate_locked(entry);
+            rotated = 1;
+        }
+    }
+
+    if (result == SUCCESS) {
+        LogSegmentInfo* active = active_segment_locked();
+        int written;
+        if (active->format == LOG_SEGMENT_FRAMED) {
+            LogFrame frame;
+            frame.length = sizeof(LogEntry);
+            frame.crc = crc32c(0, entry, sizeof(LogEntry));
+            memcpy(&frame.entry, entry, sizeof(LogEntry));  // Byte for byte, as checksummed
+            written = fwrite(&frame, sizeof(LogFrame), 1, active_file) == 1;
+        } else {
+            written = fwrite(entry, sizeof(LogEntry), 1, active_file) == 1;
+        }
+
+        if (written) {
+            account_record(active, entry);
+            active_bytes += record_size(active->format);
+            if (active_index.file) {
+                log_time_index_builder_add(&active_index, entry);
+            }
+            log_postings_active_add(active->record_count - 1, entry);
+        } else {
+            log_error(ERROR_FILE_OPERATION, "log_store_append", "Could not write log data");
+            result = ERROR_FILE_OPERATION;
+        }
+    }
+
+    pthread_mutex_unlock(&store_lock);
+
+    // The segment just sealed is archived by the background worker
+    if (rotated) {
+        request_compaction();
+    }
+    return result;
+}
+
+// Helper function to find a segment by id; caller holds store_lock
+static LogSegmentInfo* find_segment_locked(int segment_id) {
+    for (int i = 0; i < segment_count; i++) {
+        if (segments[i].segment_id == segment_id) {
+            return &segments[i];
+        }
+    }
+    return NULL;
+}
+
+// Helper function to claim the next sealed raw or framed segment for compaction
+static int claim_compaction(LogSegmentInfo* info) {
+    pthread_mutex_lock(&compaction_lock);
+    int stopping = compaction_stopping;
+    pthread_mutex_unlock(&compaction_lock);
+
+    pthread_mutex_lock(&store_lock);
+
+    int claimed = 0;
+    if (store_open && !stopping) {
+        for (int i = 0; i < segment_count; i++) {
+            if (segments[i].sealed &&
+                (segments[i].format == LOG_SEGMENT_RAW || segments[i].format == LOG_SEGMENT_FRAMED) &&
+                segments[i].record_count > 0 && segments[i].segment_id != compaction_failed_id) {
+                *info = segments[i];
+                claimed = 1;
+                break;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&store_lock);
+    return claimed;
+}
+
+// Function to archive every sealed raw or framed segment in the columnar
+// format. Each archive is complete and durable before the manifest points at it; the raw
+// file is removed last, so a crash at any step leaves a readable segment.
+ErrorCode log_store_compact() {
+    ErrorCode result = SUCCESS;
+    LogSegmentInfo info;
+
+    pthread_mutex_lock(&compaction_pass_lock);
+
+    // Index files of freshly sealed segments are written here, off the append path
+    if (log_postings_write_sealed() != SUCCESS) {
+        log_error(ERROR_FILE_OPERATION, "log_store_compact", "Could not write sealed segment index");
+    }
+
+    while (result == SUCCESS && claim_compaction(&info)) {
+        char raw_path[128];
+        char archive_path[128];
+        char temp_path[140];
+        log_store_segment_path(&info, raw_path, sizeof(raw_path));
+
+        LogSegmentInfo archived = info;
+        log_columnar_file_name(info.file_name, archived.file_name, sizeof(archived.file_name));
+        archived.format = LOG_SEGMENT_COLUMNAR;
+        log_store_segment_path(&archived, archive_path, sizeof(archive_path));
+        snprintf(temp_path, sizeof(temp_path), "%s.tmp", archive_path);
+
+        // The aggregation summary is written while the raw records are still
+        // cached; a failure only means it is built on first use instead
+        log_aggregate_build_summary(&info);
+
+        result = log_columnar_write(&info, temp_path);
+        if (result == SUCCESS && rename(temp_path, archive_path) != 0) {
+            remove(temp_path);
+            result = ERROR_FILE_OPERATION;
+        }
+
+        pthread_mutex_lock(&store_lock);
+
+        int published = 0;
+        LogSegmentInfo* current = store_open ? find_segment_locked(info.segment_id) : NULL;
+        if (result == SUCCESS && current && current->format == info.format) {
+            safe_strcpy(current->file_name, archived.file_name, sizeof(current->file_name));
+            current->format = LOG_SEGMENT_COLUMNAR;
+            result = write_manifest_locked();
+            published = result == SUCCESS;
+        }
+        if (result != SUCCESS) {
+            compaction_failed_id = info.segment_id;  // Leave it raw rather than retry forever
+        }
+
+        pthread_mutex_unlock(&store_lock);
+
+        if (published) {
+            remove(raw_path);
+        } else if (result == SUCCESS) {
+            remove(archive_path);  // The store closed or the segment changed meanwhile
+        }
+    }
+
+    pthread_mutex_unlock(&compaction_pass_lock);
+    return result;
+}
+
+// Background worker: one compaction pass per request
+static void* compaction_main(void* arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&compaction_lock);
+    while (!compaction_stopping) {
+        if (!compaction_requested) {
+            pthread_cond_wait(&compaction_wake, &compaction_lock);
+            continue;
+        }
+        compaction_requested = 0;
+        pthread_mutex_unlock(&compaction_lock);
+
+        if (log_store_compact() != SUCCESS) {
+            log_error(ERROR_FILE_OPERATION, "compaction_main", "Could not archive sealed segment");
+        }
+
+        pthread_mutex_lock(&compaction_lock);
+    }
+    pthread_mutex_unlock(&compaction_lock);
+
+    return NULL;
+}
+
+// Helper function to wake the compaction worker, starting it on first use
+static void request_compaction() {
+    pthread_mutex_lock(&compaction_lock);
+
+    compaction_requested = 1;
+    if (!compaction_worker_running && !compaction_stopping) {
+        if (pthread_create(&compaction_thread, NULL, compaction_main, NULL) == 0) {
+            compaction_worker_running = 1;
+        } else {
+            log_error(ERROR_FILE_OPERATION, "request_compaction", "Could not start compaction worker");
+        }
+    }
+    pthread_cond_signal(&compaction_wake);
+
+    pthread_mutex_unlock(&compaction_lock);
+}
+
+// Helper function to stop the compaction worker after the segment it is archiving
+static void stop_compaction_worker() {
+    pthread_mutex_lock(&compaction_lock);
+    if (!compaction_worker_running) {
+        pthread_mutex_unlock(&compaction_lock);
+        return;
+    }
+    compaction_stopping = 1;
+    pthread_cond_signal(&compaction_wake);
+    pthread_mutex_unlock(&compaction_lock);
+
+    pthread_join(compaction_thread, NULL);
+
+    pthread_mutex_lock(&compaction_lock);
+    compaction_worker_running = 0;
+    compaction_stopping = 0;
+    compaction_requested = 0;
+    pthread_mutex_unlock(&compaction_lock);
+}
+
+// Function to push buffered records to the operating system
+ErrorCode log_store_flush() {
+    pthread_mutex_lock(&store_lock);
+
+    ErrorCode result = SUCCESS;
+    if (active_file && fflush(active_file) != 0) {
+        result = ERROR_FILE_OPERATION;
+    }
+    log_time_index_builder_flush(&active_index);
+    log_postings_active_flush();
+
+    pthread_mutex_unlock(&store_lock);
+    return result;
+}
+
+// Function to make every appended record durable, then advance the checkpoint.
+// The sync runs on a duplicated descriptor so appends and rotation proceed meanwhile.
+ErrorCode log_store_sync() {
+    pthread_mutex_lock(&store_lock);
+
+    int fd = -1;
+    int segment_id = 0;
+    long long record_count = 0;
+    ErrorCode result = SUCCESS;
+    if (active_file) {
+        if (fflush(active_file) != 0) {
+            result = ERROR_FILE_OPERATION;
+        } else {
+            fd = dup(fileno(active_file));
+            segment_id = active_segment_locked()->segment_id;
+            record_count = active_segment_locked()->record_count;
+        }
+    }
+
+    pthread_mutex_unlock(&store_lock);
+
+    if (fd >= 0) {
+#ifdef _WIN32
+        if (_commit(fd) != 0) {
+#else
+        if (fdatasync(fd) != 0) {
+#endif
+            result = ERROR_FILE_OPERATION;
+        } else {
+            write_checkpoint(segment_id, record_count);
+        }
+        close(fd);
+    }
+
+    return result;
+}
+
+// Function to close the store and persist the manifest
+void log_store_close() {
+    stop_compaction_worker();
+    log_postings_write_sealed();
+
+    pthread_mutex_lock(&store_lock);
+
+    if (store_open) {
+        // Synced so the checkpoint covers the whole segment and the next open verifies nothing
+        close_active_file_locked(1);
+        log_postings_active_close();
+        log_bloom_cache_clear();
+        write_manifest_locked();
+
+        free(segments);
+        segments = NULL;
+        segment_count = 0;
+        segment_capacity = 0;
+        next_segment_id = 1;
+        store_open = 0;
+    }
+
+    pthread_mutex_lock(&checkpoint_lock);
+    if (checkpoint_file) {
+        fclose(checkpoint_file);
+        checkpoint_file = NULL;
+    }
+    checkpoint_segment_id = 0;
+    checkpoint_records = 0;
+    pthread_mutex_unlock(&checkpoint_lock);
+
+    pthread_mutex_unlock(&store_lock);
+}
+
+// Function to list segments whose time range overlaps [start, end]
+ErrorCode log_store_list_segments(time_t start, time_t end, LogSegmentInfo** result_segments, int* count) {
+    if (!result_segments || !count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    *result_segments = NULL;
+    *count = 0;
+
+    pthread_mutex_lock(&store_lock);
+
+    ErrorCode result = open_store_locked();
+    if (result != SUCCESS || segment_count == 0) {
+        pthread_mutex_unlock(&store_lock);
+        return result;
+    }
+
+    LogSegmentInfo* matching = (LogSegmentInfo*)safe_malloc(segment_count * sizeof(LogSegmentInfo));
+    if (!matching) {
+        pthread_mutex_unlock(&store_lock);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int matching_count = 0;
+    for (int i = 0; i < segment_count; i++) {
+        const LogSegmentInfo* info = &segments[i];
+        if (info->record_count == 0) {
+            continue;
+        }
+        if (start != 0 && info->max_timestamp < start) {
+            continue;
+        }
+        if (end != 0 && info->min_timestamp > end) {
+            continue;
+        }
+        matching[matching_count++] = *info;
+    }
+
+    pthread_mutex_unlock(&store_lock);
+
+    if (matching_count == 0) {
+        safe_free((void**)&matching);
+        return SUCCESS;
+    }
+
+    *result_segments = matching;
+    *count = matching_count;
+    return SUCCESS;
+}
+
+// Function to list the segments recorded in the on-disk manifest without
+// opening the store; the unsealed segment's records are counted from its file
+ErrorCode log_store_read_manifest(LogSegmentInfo** result_segments, int* count) {
+    if (!result_segments || !count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    ErrorCode result = read_manifest_file(result_segments, count, NULL);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    // The manifest is only rewritten on rotation and close
+    for (int i = 0; i < *count; i++) {
+        LogSegmentInfo* info = &(*result_segments)[i];
+        if (info->sealed || (info->format != LOG_SEGMENT_RAW && info->format != LOG_SEGMENT_FRAMED)) {
+            continue;
+        }
+
+        char path[128];
+        log_store_segment_path(info, path, sizeof(path));
+        long size = get_file_size(path);
+        if (size > 0) {
+            info->record_count = (long long)size / record_size(info->format);
+        }
+    }
+    return SUCCESS;
+}
+
+// Function to remove a sealed segment from the manifest. Its files are left in
+// place for readers that listed the segment earlier; the caller removes them
+// once those readers are done.
+ErrorCode log_store_drop_segment(int segment_id) {
+    pthread_mutex_lock(&store_lock);
+
+    ErrorCode result = open_store_locked();
+    LogSegmentInfo* info = result == SUCCESS ? find_segment_locked(segment_id) : NULL;
+    if (result == SUCCESS && (!info || !info->sealed)) {
+        result = info ? ERROR_INVALID_INPUT : ERROR_DATA_NOT_FOUND;
+    }
+
+    if (result == SUCCESS) {
+        int index = (int)(info - segments);
+        LogSegmentInfo dropped = *info;
+        memmove(&segments[index], &segments[index + 1], (segment_count - index - 1) * sizeof(LogSegmentInfo));
+        segment_count--;
+
+        result = write_manifest_locked();
+        if (result != SUCCESS) {
+            // Keep the segment rather than let memory and manifest disagree
+            memmove(&segments[index + 1], &segments[index], (segment_count - index) * sizeof(LogSegmentInfo));
+            segments[index] = dropped;
+            segment_count++;
+        }
+    }
+
+    pthread_mutex_unlock(&store_lock);
+
+    if (result == SUCCESS) {
+        log_postings_discard(segment_id);
+    }
+    return result;
+}
+
+// Function to build the path of a segment file
+void log_store_segment_path(const LogSegmentInfo* info, char* buffer, size_t buffer_size) {
+    if (!info || !buffer || buffer_size == 0) {
+        return;
+    }
+
+    snprintf(buffer, buffer_size, "%s/%s", LOG_STORE_DIR, info->file_name);
+}
+
+// Helper function to set up block-wise reading of a mapped columnar segment
+static ErrorCode open_columnar_reader(LogSegmentReader* reader) {
+    reader->columnar = (LogColumnarSegment*)safe_malloc(sizeof(LogColumnarSegment));
+    if (!reader->columnar) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    ErrorCode result = log_columnar_open(&reader->map, reader->columnar);
+    if (result != SUCCESS) {
+        safe_free((void**)&reader->columnar);
+        log_error(result, "log_segment_reader_open", "Corrupt columnar log segment");
+        return result;
+    }
+
+    reader->record_count = reader->columnar->record_count;
+    if (reader->record_count > reader->info.record_count) {
+        reader->record_count = reader->info.record_count;
+    }
+
+    // Zeroed once: blocks are decoded field by field and never touch the padding
+    reader->block_buffer = (LogEntry*)calloc((size_t)reader->columnar->block_records, sizeof(LogEntry));
+    if (!reader->block_buffer) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    reader->records = reader->block_buffer;
+    return SUCCESS;
+}
+
+// Function to open a reader over a segment, mapping its file read-only
+ErrorCode log_segment_reader_open(const LogSegmentInfo* info, LogSegmentReader* reader) {
+    if (!info || !reader) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(reader, 0, sizeof(LogSegmentReader));
+    reader->info = *info;
+    reader->columns = LOG_COLUMNS_ALL;
+
+    if (info->format != LOG_SEGMENT_RAW && info->format != LOG_SEGMENT_FRAMED &&
+        info->format != LOG_SEGMENT_COLUMNAR) {
+        log_error(ERROR_INVALID_INPUT, "log_segment_reader_open", "Unsupported log segment format");
+        return ERROR_INVALID_INPUT;
+    }
+
+    char path[128];
+    log_store_segment_path(info, path, sizeof(path));
+
+    ErrorCode result = mapped_file_open(path, MAPPED_ACCESS_SEQUENTIAL, &reader->map);
+
+    // The caller's snapshot may predate compaction replacing the raw file
+    if (result == ERROR_DATA_NOT_FOUND && info->sealed &&
+        (info->format == LOG_SEGMENT_RAW || info->format == LOG_SEGMENT_FRAMED)) {
+        log_columnar_file_name(info->file_name, reader->info.file_name, sizeof(reader->info.file_name));
+        reader->info.format = LOG_SEGMENT_COLUMNAR;
+        log_store_segment_path(&reader->info, path, sizeof(path));
+        result = mapped_file_open(path, MAPPED_ACCESS_SEQUENTIAL, &reader->map);
+    }
+    if (result != SUCCESS) {
+        return result == ERROR_DATA_NOT_FOUND ? ERROR_FILE_OPERATION : result;
+    }
+
+    if (reader->info.format == LOG_SEGMENT_COLUMNAR) {
+        result = open_columnar_reader(reader);
+        if (result != SUCCESS) {
+            log_segment_reader_close(reader);
+        }
+        return result;
+    }
+
+    // Records still buffered by the writer are not in the file yet
+    if (reader->info.format == LOG_SEGMENT_FRAMED) {
+        reader->frames = (const LogFrame*)reader->map.data;
+        reader->record_count = (long long)(reader->map.size / sizeof(LogFrame));
+    } else {
+        reader->records = (const LogEntry*)reader->map.data;
+        reader->record_count = (long long)(reader->map.size / sizeof(LogEntry));
+    }
+    if (reader->record_count > info->record_count) {
+        reader->record_count = info->record_count;
+    }
+    reader->window_count = reader->record_count;
+
+    return SUCCESS;
+}
+
+// Helper function to decode the selected columns of the columnar block holding a record
+static int load_columnar_window(LogSegmentReader* reader, long long record_index) {
+    long long block_index = record_index / reader->columnar->block_records;
+    if (block_index >= reader->columnar->block_count) {
+        return 0;
+    }
+
+    const LogColumnarBlock* block = &reader->columnar->blocks[block_index];
+    if (record_index < block->first_record || record_index >= block->first_record + block->record_count ||
+        log_columnar_read_block(reader->columnar, (int)block_index, reader->columns,
+                                reader->block_buffer) != SUCCESS) {
+        return 0;
+    }
+
+    reader->window_start = block->first_record;
+    reader->window_count = block->record_count;
+    return 1;
+}
+
+// Helper function to make a record index part of the reader's window,
+// decoding its block when needed; returns the record or NULL
+static const LogEntry* reader_record(LogSegmentReader* reader, long long record_index) {
+    if (record_index < 0 || record_index >= reader->record_count) {
+        return NULL;
+    }
+    if (reader->frames) {
+        return &reader->frames[record_index].entry;
+    }
+
+    if (record_index < reader->window_start || record_index >= reader->window_start + reader->window_count) {
+        if (!reader->columnar || !load_columnar_window(reader, record_index)) {
+            reader->window_count = 0;
+            return NULL;
+        }
+    }
+
+    return &reader->records[record_index - reader->window_start];
+}
+
+// Function to choose the columns a columnar reader decodes; readers of other
+// formats always return whole records
+void log_segment_reader_set_columns(LogSegmentReader* reader, unsigned int columns) {
+    if (!reader) {
+        return;
+    }
+
+    columns &= LOG_COLUMNS_ALL;
+    if (reader->columnar && columns != reader->columns) {
+        reader->window_count = 0;  // The decoded block lacks the new columns
+    }
+    reader->columns = columns;
+}
+
+// Function to position a reader at a record index
+ErrorCode log_segment_reader_seek(LogSegmentReader* reader, long long record_index) {
+    if (!reader || record_index < 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    reader->next_index = record_index;
+    return SUCCESS;
+}
+
+// Function to read the next record in place; returns NULL at the end.
+// The record stays valid until the next read from the reader.
+const LogEntry* log_segment_reader_next(LogSegmentReader* reader) {
+    if (!reader) {
+        return NULL;
+    }
+
+    const LogEntry* entry = reader_record(reader, reader->next_index);
+    if (entry) {
+        reader->next_index++;
+    }
+    return entry;
+}
+
+// Function to read the record at an index in place; returns NULL outside the segment
+const LogEntry* log_segment_reader_read_at(LogSegmentReader* reader, long long record_index) {
+    if (!reader) {
+        return NULL;
+    }
+
+    const LogEntry* entry = reader_record(reader, record_index);
+    if (entry) {
+        reader->next_index = record_index + 1;
+    }
+    return entry;
+}
+
+// Function to close a segment reader
+void log_segment_reader_close(LogSegmentReader* reader) {
+    if (!reader) {
+        return;
+    }
+
+    if (reader->columnar) {
+        log_columnar_close(reader->columnar);
+        safe_free((void**)&reader->columnar);
+    }
+    mapped_file_close(&reader->map);
+    safe_free((void**)&reader->block_buffer);
+    reader->records = NULL;
+    reader->frames = NULL;
+    reader->record_count = 0;
+    reader->window_count = 0;
+}
+
+// Function to visit every record in segments overlapping [start, end]
+ErrorCode log_store_scan(time_t start, time_t end, LogRecordVisitor visitor, void* context) {
+    if (!visitor) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    LogSegmentInfo* overlapping = NULL;
+    int overlapping_count = 0;
+    ErrorCode result = log_store_list_segments(start, end, &overlapping, &overlapping_count);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    int stopped = 0;
+    for (int i = 0; i < overlapping_count && !stopped; i++) {
+        LogSegmentReader reader;
+        result = log_segment_reader_open(&overlapping[i], &reader);
+        if (result != SUCCESS) {
+            break;
+        }
+
+        const LogEntry* entry;
+        while ((entry = log_segment_reader_next(&reader)) != NULL) {
+            if (visitor(entry, context)) {
+                stopped = 1;
+                break;
+            }
+        }
+
+        log_segment_reader_close(&reader);
+    }
+
+    safe_free((void**)&overlapping);
+    return result;
+}
+
+// Function to visit records with start <= timestamp <= end; 0 leaves a bound open.
+// Each segment's sparse index finds the first block that can reach start, and
+// the scan stops at the first block that starts after end. A block's minimum
+// less the segment's skew bounds every later record, so stopping there is exact.
+ErrorCode log_store_scan_time_range(time_t start, time_t end, LogRecordVisitor visitor, void* context) {
+    if (!visitor) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    LogSegmentInfo* overlapping = NULL;
+    int overlapping_count = 0;
+    ErrorCode result = log_store_list_segments(start, end, &overlapping, &overlapping_count);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    int stopped = 0;
+    for (int i = 0; i < overlapping_count && !stopped && result == SUCCESS; i++) {
+        const LogSegmentInfo* info = &overlapping[i];
+
+        LogTimeIndexEntry* entries = NULL;
+        int entry_count = 0;
+        result = log_time_index_load(info, &entries, &entry_count);
+        if (result != SUCCESS) {
+            break;
+        }
+
+        LogSegmentReader reader;
+        result = log_segment_reader_open(info, &reader);
+        if (result != SUCCESS) {
+            safe_free((void**)&entries);
+            break;
+        }
+
+        long long index = start != 0 ? log_time_index_find_start(entries, entry_count, start) : 0;
+        result = log_segment_reader_seek(&reader, index);
+
+        const LogEntry* entry;
+        while (result == SUCCESS) {
+            if (end != 0 && index % LOG_TIME_INDEX_INTERVAL == 0) {
+                long long block = index / LOG_TIME_INDEX_INTERVAL;
+                if (block < entry_count && entries[block].min_timestamp - info->max_skew > end) {
+                    break;
+                }
+            }
+
+            if ((entry = log_segment_reader_next(&reader)) == NULL) {
+                break;
+            }
+            index++;
+
+            if ((start != 0 && entry->timestamp < start) || (end != 0 && entry->timestamp > end)) {
+                continue;
+            }
+            if (visitor(entry, context)) {
+                stopped = 1;
+                break;
+            }
+        }
+
+        log_segment_reader_close(&reader);
+        safe_free((void**)&entries);
+    }
+
+    safe_free((void**)&overlapping);
+    return result;
+}
@@ -0,0 +1,120 @@
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+
+#include "data_structures.h"
+#include "mapped_file.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// The binary audit log is stored as time-partitioned segment files in
+// LOG_STORE_DIR, described by a small manifest. Each segment holds one
+// local day of records, capped by size; queries open only the segments
+// whose time range overlaps the request.
+//
+// Records are appended as frames carrying their length and CRC-32C, so a
+// record torn by a crash mid-write is detected. LOG_STORE_CHECKPOINT records
+// how many records of the active segment are known durable; on open only the
+// frames after it are verified, and the file is truncated at the first bad one.
+#define LOG_STORE_DIR "data/logs"
+#define LOG_STORE_MANIFEST "data/logs/MANIFEST"
+#define LOG_STORE_CHECKPOINT "data/logs/CHECKPOINT"
+#define LOG_STORE_LEGACY_FILE "data/logs.dat"
+#define LOG_STORE_DEFAULT_SEGMENT_BYTES (64LL * 1024 * 1024)
+#define LOG_SEGMENT_PATH_LEN 64
+
+// On-disk segment formats
+typedef enum {
+    LOG_SEGMENT_RAW = 0,        // Array of fixed-size LogEntry records
+                                // 1 was the block-compressed format, replaced by columnar
+    LOG_SEGMENT_FRAMED = 2,     // Array of LogFrame records
+    LOG_SEGMENT_COLUMNAR = 3    // Sealed segment archived column by column (log_columnar.h)
+} LogSegmentFormat;
+
+// Record of a framed segment. Frames are fixed size so records stay
+// addressable by index; crc covers the entry bytes.
+typedef struct {
+    uint32_t length;            // sizeof(LogEntry)
+    uint32_t crc;
+    LogEntry entry;
+} LogFrame;
+
+// Manifest entry describing one segment
+typedef struct {
+    int segment_id;
+    char file_name[LOG_SEGMENT_PATH_LEN];  // Relative to LOG_STORE_DIR
+    time_t min_timestamp;
+    time_t max_timestamp;
+    time_t partition_start;                // Local midnight of the segment's day
+    long long record_count;
+    long long base_sequence;               // Global sequence of the first record
+    int format;
+    int sealed;                            // Sealed segments never change again
+    time_t max_skew;                       // Largest amount a record trails an earlier one
+} LogSegmentInfo;
+
+// Store configuration
+typedef struct {
+    long long max_segment_bytes;  // Rotate before a segment grows past this size
+} LogStoreConfig;
+
+struct LogColumnarSegment;
+
+// Reader over one segment. Raw and framed segments are read in place from a
+// read-only mapping; columnar segments one decoded block at a time. A columnar reader decodes only the columns set with
+// log_segment_reader_set_columns, all of them by default.
+typedef struct {
+    LogSegmentInfo info;
+    MappedFile map;
+    const LogEntry* records;      // Records of the current window
+    const LogFrame* frames;       // Set for framed segments instead of records
+    long long window_start;       // Record index of records[0]
+    long long window_count;
+    long long record_count;       // Records visible to the reader
+    long long next_index;         // Record index of the next record returned
+    struct LogColumnarSegment* columnar;      // Set for columnar segments
+    unsigned int columns;                     // LogColumn bits decoded by a columnar reader
+    LogEntry* block_buffer;
+} LogSegmentReader;
+
+// Visitor called for each record; return non-zero to stop the scan
+typedef int (*LogRecordVisitor)(const LogEntry* entry, void* context);
+
+// Store lifecycle
+ErrorCode log_store_configure(const LogStoreConfig* config);
+ErrorCode log_store_open();
+void log_store_close();
+
+// Writing
+ErrorCode log_store_append(const LogEntry* entry);
+ErrorCode log_store_flush();
+ErrorCode log_store_sync();
+
+// Writing the postings index of freshly sealed segments and archiving sealed
+// raw and framed segments in the columnar format. A background worker runs it
+// after each rotation; a direct call waits for a pass in progress.
+ErrorCode log_store_compact();
+
+// Segment enumeration; start/end of 0 mean unbounded
+ErrorCode log_store_list_segments(time_t start, time_t end, LogSegmentInfo** segments, int* count);
+ErrorCode log_store_read_manifest(LogSegmentInfo** segments, int* count);
+void log_store_segment_path(const LogSegmentInfo* info, char* buffer, size_t buffer_size);
+
+// Retention: removing a sealed segment from the manifest (its files stay)
+ErrorCode log_store_drop_segment(int segment_id);
+
+// Segment readers
+ErrorCode log_segment_reader_open(const LogSegmentInfo* info, LogSegmentReader* reader);
+ErrorCode log_segment_reader_seek(LogSegmentReader* reader, long long record_index);
+void log_segment_reader_set_columns(LogSegmentReader* reader, unsigned int columns);
+const LogEntry* log_segment_reader_next(LogSegmentReader* reader);
+const LogEntry* log_segment_reader_read_at(LogSegmentReader* reader, long long record_index);
+void log_segment_reader_close(LogSegmentReader* reader);
+
+// Scanning every record whose segment overlaps [start, end]
+ErrorCode log_store_scan(time_t start, time_t end, LogRecordVisitor visitor, void* context);
+
+// Scanning only records with start <= timestamp <= end, located through the time index
+ErrorCode log_store_scan_time_range(time_t start, time_t end, LogRecordVisitor visitor, void* context);
+
+#endif // LOG_STORE_H
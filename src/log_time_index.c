@@ -0,0 +1,244 @@
+#include "log_time_index.h"
+#include "log_columnar.h"
+#include "file_io.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Function to build the index path for a segment: seg-*.dat -> seg-*.idx
+void log_time_index_path(const LogSegmentInfo* info, char* buffer, size_t buffer_size) {
+    if (!info || !buffer || buffer_size == 0) {
+        return;
+    }
+
+    log_store_segment_path(info, buffer, buffer_size);
+
+    char* extension = strrchr(buffer, '.');
+    if (extension && strlen(extension) == 4) {
+        strcpy(extension, ".idx");
+    } else {
+        safe_strcat(buffer, ".idx", buffer_size);
+    }
+}
+
+// Function to load the index entries covering a segment's complete blocks
+ErrorCode log_time_index_load(const LogSegmentInfo* info, LogTimeIndexEntry** entries, int* count) {
+    if (!info || !entries || !count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    *entries = NULL;
+    *count = 0;
+
+    char path[128];
+    log_time_index_path(info, path, sizeof(path));
+
+    long size = get_file_size(path);
+    if (size <= 0) {
+        return SUCCESS;  // No index: callers fall back to a sequential scan
+    }
+
+    // Never trust entries beyond the records the caller can see
+    long long entry_count = size / (long)sizeof(LogTimeIndexEntry);
+    long long complete_blocks = info->record_count / LOG_TIME_INDEX_INTERVAL;
+    if (entry_count > complete_blocks) {
+        entry_count = complete_blocks;
+    }
+    if (entry_count == 0) {
+        return SUCCESS;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return SUCCESS;
+    }
+
+    LogTimeIndexEntry* loaded = (LogTimeIndexEntry*)safe_malloc(entry_count * sizeof(LogTimeIndexEntry));
+    if (!loaded) {
+        fclose(file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int read_count = (int)fread(loaded, sizeof(LogTimeIndexEntry), entry_count, file);
+    fclose(file);
+
+    if (read_count == 0) {
+        safe_free((void**)&loaded);
+        return SUCCESS;
+    }
+
+    *entries = loaded;
+    *count = read_count;
+    return SUCCESS;
+}
+
+// Helper function to start a builder writing to an already opened file
+static void builder_init(LogTimeIndexBuilder* builder, FILE* file) {
+    memset(builder, 0, sizeof(LogTimeIndexBuilder));
+    builder->file = file;
+}
+
+// Function to rebuild a segment's index from its records
+ErrorCode log_time_index_build(const LogSegmentInfo* info) {
+    if (!info) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    char path[128];
+    char temp_path[140];
+    log_time_index_path(info, path, sizeof(path));
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    LogSegmentReader reader;
+    ErrorCode result = log_segment_reader_open(info, &reader);
+    if (result != SUCCESS) {
+        return result;
+    }
+    log_segment_reader_set_columns(&reader, LOG_COLUMN_BIT(LOG_COLUMN_TIMESTAMP));
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        log_segment_reader_close(&reader);
+        return ERROR_FILE_OPERATION;
+    }
+
+    LogTimeIndexBuilder builder;
+    builder_init(&builder, file);
+
+    const LogEntry* entry;
+    while (result == SUCCESS && (entry = log_segment_reader_next(&reader)) != NULL) {
+        result = log_time_index_builder_add(&builder, entry);
+    }
+
+    log_segment_reader_close(&reader);
+    fclose(file);
+
+    if (result != SUCCESS) {
+        remove(temp_path);
+        return result;
+    }
+
+    remove(path);
+    if (rename(temp_path, path) != 0) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    return SUCCESS;
+}
+
+// Function to resume indexing the active segment, rebuilding a stale index first
+ErrorCode log_time_index_builder_open(LogTimeIndexBuilder* builder, const LogSegmentInfo* info) {
+    if (!builder || !info) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    char path[128];
+    log_time_index_path(info, path, sizeof(path));
+
+    long size = get_file_size(path);
+    long long entry_count = size > 0 ? size / (long)sizeof(LogTimeIndexEntry) : 0;
+    long long complete_blocks = info->record_count / LOG_TIME_INDEX_INTERVAL;
+
+    // A crash can leave the index behind or ahead of the data; rebuild it from the segment
+    if (entry_count != complete_blocks || (size > 0 && size % (long)sizeof(LogTimeIndexEntry) != 0)) {
+        ErrorCode result = log_time_index_build(info);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+
+    FILE* file = fopen(path, "ab");
+    if (!file) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    builder_init(builder, file);
+    builder->records = complete_blocks * LOG_TIME_INDEX_INTERVAL;
+    builder->running_max = info->max_timestamp;
+
+    // Recover the minimum of the partial block at the tail
+    if (builder->records < info->record_count) {
+        LogSegmentReader reader;
+        if (log_segment_reader_open(info, &reader) == SUCCESS) {
+            const LogEntry* entry;
+            log_segment_reader_seek(&reader, builder->records);
+            while ((entry = log_segment_reader_next(&reader)) != NULL) {
+                if (builder->records % LOG_TIME_INDEX_INTERVAL == 0 || entry->timestamp < builder->block_min) {
+                    builder->block_min = entry->timestamp;
+                }
+                builder->records++;
+            }
+            log_segment_reader_close(&reader);
+        }
+    }
+
+    return SUCCESS;
+}
+
+// Function to account for one appended record, writing an entry when a block completes
+ErrorCode log_time_index_builder_add(LogTimeIndexBuilder* builder, const LogEntry* entry) {
+    if (!builder || !builder->file || !entry) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (builder->records % LOG_TIME_INDEX_INTERVAL == 0 || entry->timestamp < builder->block_min) {
+        builder->block_min = entry->timestamp;
+    }
+    if (builder->records == 0 || entry->timestamp > builder->running_max) {
+        builder->running_max = entry->timestamp;
+    }
+    builder->records++;
+
+    if (builder->records % LOG_TIME_INDEX_INTERVAL == 0) {
+        LogTimeIndexEntry index_entry;
+        memset(&index_entry, 0, sizeof(index_entry));
+        index_entry.record_index = builder->records - LOG_TIME_INDEX_INTERVAL;
+        index_entry.min_timestamp = builder->block_min;
+        index_entry.max_timestamp = builder->running_max;
+
+        if (fwrite(&index_entry, sizeof(index_entry), 1, builder->file) != 1) {
+            return ERROR_FILE_OPERATION;
+        }
+    }
+
+    return SUCCESS;
+}
+
+// Function to push buffered index entries to the operating system
+void log_time_index_builder_flush(LogTimeIndexBuilder* builder) {
+    if (builder && builder->file) {
+        fflush(builder->file);
+    }
+}
+
+// Function to close an index builder
+void log_time_index_builder_close(LogTimeIndexBuilder* builder) {
+    if (builder && builder->file) {
+        fclose(builder->file);
+        builder->file = NULL;
+    }
+}
+
+// Function to binary-search the first block whose records may reach start.
+// max_timestamp is a running maximum, so it never decreases along the index.
+long long log_time_index_find_start(const LogTimeIndexEntry* entries, int count, time_t start) {
+    if (!entries || count <= 0) {
+        return 0;
+    }
+
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (entries[mid].max_timestamp < start) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < count) {
+        return entries[low].record_index;
+    }
+    return (long long)count * LOG_TIME_INDEX_INTERVAL;
+}
@@ -0,0 +1,41 @@
+#ifndef LOG_TIME_INDEX_H
+#define LOG_TIME_INDEX_H
+
+#include "data_structures.h"
+#include "log_store.h"
+#include <stdio.h>
+#include <time.h>
+
+// Sparse timestamp index stored next to each segment (seg-*.idx). One entry
+// describes each complete block of LOG_TIME_INDEX_INTERVAL records.
+#define LOG_TIME_INDEX_INTERVAL 64
+
+typedef struct {
+    long long record_index;   // First record of the block
+    time_t min_timestamp;     // Smallest timestamp inside the block
+    time_t max_timestamp;     // Largest timestamp in the segment up to the end of the block
+} LogTimeIndexEntry;
+
+// Incremental index writer for the active segment
+typedef struct {
+    FILE* file;
+    long long records;        // Records seen so far
+    time_t block_min;         // Smallest timestamp in the current partial block
+    time_t running_max;       // Largest timestamp seen so far
+} LogTimeIndexBuilder;
+
+// Index files
+void log_time_index_path(const LogSegmentInfo* info, char* buffer, size_t buffer_size);
+ErrorCode log_time_index_load(const LogSegmentInfo* info, LogTimeIndexEntry** entries, int* count);
+ErrorCode log_time_index_build(const LogSegmentInfo* info);
+
+// Incremental building
+ErrorCode log_time_index_builder_open(LogTimeIndexBuilder* builder, const LogSegmentInfo* info);
+ErrorCode log_time_index_builder_add(LogTimeIndexBuilder* builder, const LogEntry* entry);
+void log_time_index_builder_flush(LogTimeIndexBuilder* builder);
+void log_time_index_builder_close(LogTimeIndexBuilder* builder);
+
+// Lookup: first record that may hold a timestamp >= start
+long long log_time_index_find_start(const LogTimeIndexEntry* entries, int count, time_t start);
+
+#endif // LOG_TIME_INDEX_H
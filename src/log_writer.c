@@ -0,0 +1,411 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log_writer.h"
+#include "log_store.h"
+#include "file_io.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SYSTEM_LOG_FILE "logs/system.log"
+#define ERROR_LOG_FILE "logs/error.log"
+
+// Helper function to open a sink with a large userspace buffer
+static FILE* open_sink(const char* path, const char* mode, char** buffer) {
+    FILE* file = fopen(path, mode);
+    if (!file) {
+        return NULL;
+    }
+
+    *buffer = (char*)safe_malloc(LOG_WRITER_BUFFER_SIZE);
+    if (*buffer) {
+        setvbuf(file, *buffer, _IOFBF, LOG_WRITER_BUFFER_SIZE);
+    }
+
+    return file;
+}
+
+// Helper function to close a sink and release its buffer
+static void close_sink(FILE** file, char** buffer) {
+    if (*file) {
+        fclose(*file);
+        *file = NULL;
+    }
+    safe_free((void**)buffer);
+}
+
+// Helper function to get milliseconds elapsed since a monotonic timestamp
+static long elapsed_ms(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000L + (now.tv_nsec - since->tv_nsec) / 1000000L;
+}
+
+// Helper function to run one group commit; caller holds the writer lock.
+// The lock is released around fdatasync so appends continue while the disk works.
+static ErrorCode sync_as_leader(LogWriter* writer) {
+    writer->sync_in_progress = 1;
+    unsigned long long target = writer->stats.records_written;
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    pthread_mutex_unlock(&writer->lock);
+    ErrorCode result = log_store_sync();
+    pthread_mutex_lock(&writer->lock);
+
+    if (result == SUCCESS) {
+        if (target > writer->stats.synced_records) {
+            writer->stats.synced_records = target;
+        }
+        writer->stats.syncs++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &writer->last_sync);
+
+    // Records appended while the lock was released are no older than the sync
+    if (writer->stats.synced_records < writer->stats.records_written) {
+        if (result == SUCCESS) {
+            writer->first_unsynced = started;
+        }
+        pthread_cond_signal(&writer->timer_wake);
+    }
+
+    writer->sync_in_progress = 0;
+    pthread_cond_broadcast(&writer->synced);
+    return result;
+}
+
+// Background thread of the interval policy: sleeps until interval_ms after
+// the first unsynced record and syncs, so records logged just before the
+// application goes idle do not stay unsynced until the next commit
+static void* sync_timer_main(void* arg) {
+    LogWriter* writer = (LogWriter*)arg;
+
+    pthread_mutex_lock(&writer->lock);
+    while (!writer->timer_stopping) {
+        int pending = writer->is_open && writer->durability.mode == LOG_DURABILITY_INTERVAL &&
+                      writer->stats.synced_records < writer->stats.records_written;
+        if (!pending || writer->sync_in_progress) {
+            pthread_cond_wait(&writer->timer_wake, &writer->lock);
+            continue;
+        }
+
+        long remaining = writer->durability.interval_ms - elapsed_ms(&writer->first_unsynced);
+        if (remaining <= 0) {
+            if (sync_as_leader(writer) != SUCCESS) {
+                log_error(ERROR_FILE_OPERATION, "sync_timer_main", "Could not sync log data");
+                clock_gettime(CLOCK_MONOTONIC, &writer->first_unsynced);  // Retry one interval later
+            }
+            continue;
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += remaining / 1000;
+        deadline.tv_nsec += (remaining % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&writer->timer_wake, &writer->lock, &deadline);
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+// Helper function to start the interval timer once; caller holds the writer lock
+static void start_sync_timer(LogWriter* writer) {
+    if (writer->timer_running || writer->durability.mode != LOG_DURABILITY_INTERVAL) {
+        return;
+    }
+
+    writer->timer_stopping = 0;
+    if (pthread_create(&writer->sync_timer, NULL, sync_timer_main, writer) != 0) {
+        log_error(ERROR_FILE_OPERATION, "start_sync_timer", "Could not start log sync timer");
+        return;
+    }
+    writer->timer_running = 1;
+}
+
+// Helper function to stop the interval timer; caller holds the writer lock,
+// which is released while the thread exits
+static void stop_sync_timer(LogWriter* writer) {
+    if (!writer->timer_running) {
+        return;
+    }
+
+    writer->timer_stopping = 1;
+    pthread_cond_broadcast(&writer->timer_wake);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->sync_timer, NULL);
+    pthread_mutex_lock(&writer->lock);
+
+    writer->timer_running = 0;
+    writer->timer_stopping = 0;
+}
+
+// Helper function to release every sink; caller holds the writer lock
+static void close_all_sinks(LogWriter* writer) {
+    close_sink(&writer->system_log, &writer->buffers[0]);
+    close_sink(&writer->error_log, &writer->buffers[1]);
+    log_store_close();
+    writer->is_open = 0;
+}
+
+// Helper function to open every sink; caller holds the writer lock
+static ErrorCode open_all_sinks(LogWriter* writer) {
+    if (writer->is_open) {
+        return SUCCESS;
+    }
+
+    // Late writers (a thread-exit publish, say) must not reopen closed sinks
+    if (writer->closed) {
+        return ERROR_FILE_OPERATION;
+    }
+
+    // Directories are checked once here instead of on every append
+    ErrorCode result = ensure_directory_exists("logs");
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    result = log_store_open();
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    writer->system_log = open_sink(SYSTEM_LOG_FILE, "a", &writer->buffers[0]);
+    writer->error_log = open_sink(ERROR_LOG_FILE, "a", &writer->buffers[1]);
+
+    if (!writer->system_log || !writer->error_log) {
+        log_error(ERROR_FILE_OPERATION, "log_writer_open", "Could not open log sinks");
+        close_all_sinks(writer);
+        return ERROR_FILE_OPERATION;
+    }
+
+    writer->is_open = 1;
+    clock_gettime(CLOCK_MONOTONIC, &writer->last_sync);
+    start_sync_timer(writer);
+    return SUCCESS;
+}
+
+// Function to open the binary and text sinks once
+ErrorCode log_writer_open(LogWriter* writer) {
+    if (!writer) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    writer->closed = 0;
+    ErrorCode result = open_all_sinks(writer);
+    pthread_mutex_unlock(&writer->lock);
+
+    return result;
+}
+
+// Function to select the durability policy for the binary audit log
+ErrorCode log_writer_set_durability(LogWriter* writer, const LogDurability* durability) {
+    if (!writer || !durability) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (durability->mode < LOG_DURABILITY_NONE || durability->mode > LOG_DURABILITY_SYNC) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if ((durability->mode == LOG_DURABILITY_INTERVAL && durability->interval_ms <= 0) ||
+        (durability->mode == LOG_DURABILITY_EVERY_N && durability->every_n <= 0)) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    writer->durability = *durability;
+    if (writer->is_open) {
+        start_sync_timer(writer);
+    }
+    pthread_cond_signal(&writer->timer_wake);
+    pthread_mutex_unlock(&writer->lock);
+
+    return SUCCESS;
+}
+
+// Function to append a log entry to the binary log and the matching text log
+ErrorCode log_writer_append(LogWriter* writer, const LogEntry* entry, int is_error,
+                            unsigned long long* sequence) {
+    if (!writer || !entry) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+
+    // Writers used before init_logging_system open their sinks lazily
+    ErrorCode result = open_all_sinks(writer);
+    if (result != SUCCESS) {
+        pthread_mutex_unlock(&writer->lock);
+        return result;
+    }
+
+    result = log_store_append(entry);
+    if (result != SUCCESS) {
+        pthread_mutex_unlock(&writer->lock);
+        return result;
+    }
+    if (writer->stats.records_written == writer->stats.synced_records) {
+        clock_gettime(CLOCK_MONOTONIC, &writer->first_unsynced);
+        if (writer->timer_running) {
+            pthread_cond_signal(&writer->timer_wake);
+        }
+    }
+    writer->stats.records_written++;
+    writer->stats.bytes_written += sizeof(LogEntry);
+    if (sequence) {
+        *sequence = writer->stats.records_written;
+    }
+
+    char time_str[30];
+    format_timestamp(entry->timestamp, time_str, sizeof(time_str));
+
+    int written = fprintf(is_error ? writer->error_log : writer->system_log,
+                          "[%s] %sUSER: %s | MODULE: %s | ACTION: %s | DETAILS: %s\n",
+                          time_str, is_error ? "ERROR - " : "", entry->userID,
+                          entry->module, entry->action, entry->details);
+    if (written > 0) {
+        writer->stats.bytes_written += written;
+    }
+
+    pthread_mutex_unlock(&writer->lock);
+    return SUCCESS;
+}
+
+// Function to append a timestamped line to the system log
+ErrorCode log_writer_write_line(LogWriter* writer, const char* message) {
+    if (!writer || !message) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+
+    ErrorCode result = open_all_sinks(writer);
+    if (result != SUCCESS) {
+        pthread_mutex_unlock(&writer->lock);
+        return result;
+    }
+
+    char time_str[30];
+    format_timestamp(time(NULL), time_str, sizeof(time_str));
+
+    int written = fprintf(writer->system_log, "[%s] %s\n", time_str, message);
+    if (written > 0) {
+        writer->stats.bytes_written += written;
+    }
+
+    pthread_mutex_unlock(&writer->lock);
+    return SUCCESS;
+}
+
+// Function to push buffered data to the operating system
+ErrorCode log_writer_flush(LogWriter* writer) {
+    if (!writer) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+
+    ErrorCode result = SUCCESS;
+    if (writer->is_open) {
+        if (log_store_flush() != SUCCESS ||
+            fflush(writer->system_log) != 0 ||
+            fflush(writer->error_log) != 0) {
+            result = ERROR_FILE_OPERATION;
+        }
+        writer->stats.flushes++;
+    }
+
+    pthread_mutex_unlock(&writer->lock);
+    return result;
+}
+
+// Function to apply the durability policy to every record up to sequence.
+// Under LOG_DURABILITY_SYNC concurrent callers share one fdatasync: the first
+// caller becomes the leader and the rest wait for its sync to cover them.
+ErrorCode log_writer_commit(LogWriter* writer, unsigned long long sequence) {
+    if (!writer) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+
+    ErrorCode result = SUCCESS;
+    if (!writer->is_open) {
+        pthread_mutex_unlock(&writer->lock);
+        return result;
+    }
+
+    unsigned long long unsynced = writer->stats.records_written - writer->stats.synced_records;
+
+    switch (writer->durability.mode) {
+        case LOG_DURABILITY_NONE:
+            break;
+        case LOG_DURABILITY_INTERVAL:
+            // The timer thread covers records no later commit arrives for
+            if (unsynced > 0 && !writer->sync_in_progress &&
+                elapsed_ms(&writer->first_unsynced) >= writer->durability.interval_ms) {
+                result = sync_as_leader(writer);
+            }
+            break;
+        case LOG_DURABILITY_EVERY_N:
+            if (unsynced >= (unsigned long long)writer->durability.every_n && !writer->sync_in_progress) {
+                result = sync_as_leader(writer);
+            }
+            break;
+        case LOG_DURABILITY_SYNC:
+            while (writer->stats.synced_records < sequence && writer->is_open && result == SUCCESS) {
+                if (writer->sync_in_progress) {
+                    pthread_cond_wait(&writer->synced, &writer->lock);
+                } else {
+                    result = sync_as_leader(writer);
+                }
+            }
+            break;
+    }
+
+    pthread_mutex_unlock(&writer->lock);
+    return result;
+}
+
+// Function to read the writer counters
+void log_writer_get_stats(LogWriter* writer, LogWriterStats* stats) {
+    if (!writer || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    *stats = writer->stats;
+    pthread_mutex_unlock(&writer->lock);
+}
+
+// Function to flush and close every sink
+void log_writer_close(LogWriter* writer) {
+    if (!writer) {
+        return;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+
+    stop_sync_timer(writer);
+    while (writer->sync_in_progress) {
+        pthread_cond_wait(&writer->synced, &writer->lock);
+    }
+
+    // Leave nothing unsynced behind unless durability is disabled
+    if (writer->is_open && writer->durability.mode != LOG_DURABILITY_NONE &&
+        writer->stats.synced_records < writer->stats.records_written) {
+        sync_as_leader(writer);
+    }
+
+    close_all_sinks(writer);
+    writer->closed = 1;
+    pthread_cond_broadcast(&writer->synced);
+    pthread_mutex_unlock(&writer->lock);
+}
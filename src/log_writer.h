@@ -0,0 +1,74 @@
+#ifndef LOG_WRITER_H
+#define LOG_WRITER_H
+
+#include "data_structures.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#define LOG_WRITER_BUFFER_SIZE (256 * 1024)
+
+// Durability policies for the binary audit log
+typedef enum {
+    LOG_DURABILITY_NONE = 0,      // Never fdatasync; the OS decides when data hits disk
+    LOG_DURABILITY_INTERVAL = 1,  // fdatasync within interval_ms of the first unsynced record
+    LOG_DURABILITY_EVERY_N = 2,   // fdatasync once every_n records are unsynced
+    LOG_DURABILITY_SYNC = 3       // Every record is durable before it is acknowledged
+} LogDurabilityMode;
+
+typedef struct {
+    LogDurabilityMode mode;
+    int interval_ms;   // Used by LOG_DURABILITY_INTERVAL
+    int every_n;       // Used by LOG_DURABILITY_EVERY_N
+} LogDurability;
+
+// Counters maintained by the log writer
+typedef struct {
+    unsigned long long records_written;  // Binary records appended to the segment store
+    unsigned long long bytes_written;    // Bytes handed to all sinks
+    unsigned long long flushes;          // Userspace buffer flushes
+    unsigned long long syncs;            // fdatasync calls on the active segment
+    unsigned long long synced_records;   // Records known to be on stable storage
+} LogWriterStats;
+
+// Long-lived sinks for the audit log
+typedef struct {
+    FILE* system_log;   // logs/system.log
+    FILE* error_log;    // logs/error.log
+    char* buffers[2];   // stdio buffers for the sinks above
+    LogWriterStats stats;
+    int is_open;
+    int closed;         // Set by log_writer_close; appends fail until log_writer_open
+
+    // Group commit state: one fdatasync covers every record appended before it started
+    LogDurability durability;
+    int sync_in_progress;
+    struct timespec last_sync;
+    struct timespec first_unsynced;  // Append time of the oldest unsynced record
+    pthread_cond_t synced;
+
+    // Interval policy: a timer thread syncs records that no later commit covers
+    pthread_t sync_timer;
+    int timer_running;
+    int timer_stopping;
+    pthread_cond_t timer_wake;
+
+    pthread_mutex_t lock;
+} LogWriter;
+
+#define LOG_WRITER_INITIALIZER { .lock = PTHREAD_MUTEX_INITIALIZER, \
+                                 .synced = PTHREAD_COND_INITIALIZER, \
+                                 .timer_wake = PTHREAD_COND_INITIALIZER }
+
+// Log writer functions
+ErrorCode log_writer_open(LogWriter* writer);
+ErrorCode log_writer_set_durability(LogWriter* writer, const LogDurability* durability);
+ErrorCode log_writer_append(LogWriter* writer, const LogEntry* entry, int is_error,
+                            unsigned long long* sequence);
+ErrorCode log_writer_write_line(LogWriter* writer, const char* message);
+ErrorCode log_writer_flush(LogWriter* writer);
+ErrorCode log_writer_commit(LogWriter* writer, unsigned long long sequence);
+void log_writer_get_stats(LogWriter* writer, LogWriterStats* stats);
+void log_writer_close(LogWriter* writer);
+
+#endif // LOG_WRITER_H
@@ -1,321 +1,842 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "logging.h"
+#include "log_writer.h"
+#include "log_sampling.h"
+#include "log_scan.h"
 #include "file_io.h"
 #include "utils.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define DEFAULT_QUEUE_CAPACITY 1024
+#define WRITER_BATCH_SIZE 64
+#define INGEST_WINDOW_BATCHES 64
+#define MAX_LEVEL_OVERRIDES 16
+
+// Global variables for log levels. log_level_floor is the lowest of the
+// global level and every override; it is the only thing the LOG_*F macros read.
+static atomic_int current_log_level = LOG_LEVEL_INFO;
+atomic_int log_level_floor = LOG_LEVEL_INFO;
+
+typedef struct {
+    char module[MAX_MODULE_LEN];
+    LogLevel level;
+} LevelOverride;
+
+static LevelOverride level_overrides[MAX_LEVEL_OVERRIDES];
+static atomic_int level_override_count = 0;
+static pthread_rwlock_t level_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+// Global variables for the logging configuration and async writer
+static LogConfig log_config = { LOG_MODE_SYNC, DEFAULT_QUEUE_CAPACITY, LOG_BACKPRESSURE_BLOCK,
+                                { LOG_DURABILITY_NONE, 0, 0 }, 1 };
+static LogQueue log_queue;
+static pthread_t writer_thread;
+static int logging_initialized = 0;
+static int async_running = 0;
+static pthread_rwlock_t mode_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+// Global variables for lock-free ingestion. Producers never take mode_lock on
+// this path: they read lockfree_running and the two settings below, which only
+// change while it is 0, and the queue itself rejects batches once closed.
+static LogMpscQueue ingest_queue;
+static pthread_t ingest_thread;
+static atomic_int lockfree_running = 0;
+static atomic_int lockfree_staging = 1;
+static atomic_int lockfree_durable = 0;
+
+// Each thread's staging buffer. Slots are registered so flush and cleanup can
+// publish entries staged on any thread. The owning thread checks its batch out
+// with one compare-and-swap, leaving a marker; a flush waits only while the
+// owner is mid-stage, and the owner only while a flush publishes its batch, so
+// per-thread order is kept without a lock. The key's destructor unregisters
+// the slot and publishes it at thread exit.
+typedef struct StagingSlot {
+    LogMpscBatch* _Atomic batch;
+    struct StagingSlot* next;
+} StagingSlot;
+
+// Markers left in a slot while its batch is checked out
+static char staging_markers[2];
+#define SLOT_STAGING ((LogMpscBatch*)&staging_markers[0])
+#define SLOT_PUBLISHING ((LogMpscBatch*)&staging_markers[1])
+
+static _Thread_local StagingSlot* staging_slot = NULL;
+static StagingSlot* staging_slots = NULL;
+static pthread_mutex_t staging_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t staging_key;
+static pthread_once_t staging_key_once = PTHREAD_ONCE_INIT;
+
+// Long-lived sinks shared by the sync and async paths
+static LogWriter log_writer = LOG_WRITER_INITIALIZER;
+
+// Helper function to build a log entry
+static void build_log_entry(LogEntry* log_entry, const char* prefix, const char* user_id,
+                            const char* module, const char* action, const char* details) {
+    memset(log_entry, 0, sizeof(LogEntry));
+    generate_unique_id(log_entry->logID, sizeof(log_entry->logID), prefix);
+
+    safe_strcpy(log_entry->userID, user_id, sizeof(log_entry->userID));
+    safe_strcpy(log_entry->module, module, sizeof(log_entry->module));
+    safe_strcpy(log_entry->action, action, sizeof(log_entry->action));
 
-// Global variable for log level
-static LogLevel current_log_level = LOG_LEVEL_INFO;
+    if (details) {
+        safe_strcpy(log_entry->details, details, sizeof(log_entry->details));
+    }
 
-// Function to initialize the logging system
-ErrorCode init_logging_system() {
-    // Ensure logs directory exists
-    ErrorCode dir_result = ensure_directory_exists("logs");
-    if (dir_result != SUCCESS) {
-        return dir_result;
-    }
-
-    // Create initial log file if it doesn't exist
-    FILE* log_file = fopen("logs/system.log", "a");
-    if (log_file) {
-        time_t now;
-        time(&now);
-        char time_str[30];
-        format_timestamp(now, time_str, sizeof(time_str));
-
-        fprintf(log_file, "[%s] LOGGING SYSTEM INITIALIZED\n", time_str);
-        fclose(log_file);
-    } else {
-        return ERROR_FILE_OPERATION;
+    log_entry->timestamp = time(NULL);
+}
+
+// Helper function to write a log entry to the binary and text sinks
+static ErrorCode write_log_entry(const QueuedLog* record, unsigned long long* sequence) {
+    return log_writer_append(&log_writer, &record->entry, record->is_error, sequence);
+}
+
+// Background thread that drains the ring buffer into the sinks
+static void* writer_main(void* arg) {
+    (void)arg;
+    QueuedLog batch[WRITER_BATCH_SIZE];
+
+    int taken;
+    while ((taken = log_queue_pop_batch(&log_queue, batch, WRITER_BATCH_SIZE)) > 0) {
+        unsigned long long sequence = 0;
+        for (int i = 0; i < taken; i++) {
+            if (write_log_entry(&batch[i], &sequence) != SUCCESS) {
+                log_error(ERROR_FILE_OPERATION, "writer_main", "Could not write queued log entry");
+            }
+        }
+
+        // One flush and at most one fdatasync per batch; producers waiting
+        // on durability are acknowledged together when the batch completes
+        log_writer_flush(&log_writer);
+        if (log_writer_commit(&log_writer, sequence) != SUCCESS) {
+            log_error(ERROR_FILE_OPERATION, "writer_main", "Could not sync log data");
+        }
+        log_queue_complete(&log_queue, taken);
     }
 
-    return SUCCESS;
+    return NULL;
 }
 
-// Function to log an action
-ErrorCode log_action(const char* user_id, const char* module, const char* action, const char* details) {
-    if (!user_id || !module || !action) {
-        return ERROR_INVALID_INPUT;
+// Helper function to order a window of records by timestamp. Insertion sort is
+// stable, keeping each thread's arrival order for equal timestamps, and close
+// to linear because producers publish nearly ordered batches.
+static void sort_by_timestamp(const QueuedLog** records, int count) {
+    for (int i = 1; i < count; i++) {
+        const QueuedLog* record = records[i];
+        int j = i - 1;
+        while (j >= 0 && records[j]->entry.timestamp > record->entry.timestamp) {
+            records[j + 1] = records[j];
+            j--;
+        }
+        records[j + 1] = record;
     }
+}
 
-    // Create log entry
-    LogEntry log_entry;
-    generate_unique_id(log_entry.logID, sizeof(log_entry.logID), "LOG");
+// Background thread that drains published batches into the sinks
+static void* ingest_main(void* arg) {
+    (void)arg;
+    LogMpscBatch* window[INGEST_WINDOW_BATCHES];
+    const QueuedLog* records[INGEST_WINDOW_BATCHES * LOG_MPSC_BATCH_RECORDS];
+
+    for (;;) {
+        int batch_count = 0;
+        int record_count = 0;
+        LogMpscBatch* batch;
+        while (batch_count < INGEST_WINDOW_BATCHES && (batch = log_mpsc_pop(&ingest_queue)) != NULL) {
+            window[batch_count++] = batch;
+            for (int i = 0; i < batch->count; i++) {
+                records[record_count++] = &batch->records[i];
+            }
+        }
 
-    safe_strcpy(log_entry.userID, user_id, sizeof(log_entry.userID));
-    safe_strcpy(log_entry.module, module, sizeof(log_entry.module));
-    safe_strcpy(log_entry.action, action, sizeof(log_entry.action));
+        if (batch_count == 0) {
+            if (!log_mpsc_wait(&ingest_queue)) {
+                break;
+            }
+            continue;
+        }
 
-    if (details) {
-        safe_strcpy(log_entry.details, details, sizeof(log_entry.details));
-    } else {
-        strcpy(log_entry.details, "");
+        // Batches from different threads interleave; write the window in timestamp order
+        sort_by_timestamp(records, record_count);
+
+        unsigned long long sequence = 0;
+        for (int i = 0; i < record_count; i++) {
+            if (write_log_entry(records[i], &sequence) != SUCCESS) {
+                log_error(ERROR_FILE_OPERATION, "ingest_main", "Could not write published log entry");
+            }
+        }
+
+        log_writer_flush(&log_writer);
+        if (record_count > 0 && log_writer_commit(&log_writer, sequence) != SUCCESS) {
+            log_error(ERROR_FILE_OPERATION, "ingest_main", "Could not sync log data");
+        }
+        for (int i = 0; i < batch_count; i++) {
+            log_mpsc_complete(&ingest_queue, window[i]);
+        }
     }
 
-    log_entry.timestamp = time(NULL);
+    return NULL;
+}
 
-    // Save to binary file using file_io module
-    ErrorCode result = save_log(&log_entry);
-    if (result != SUCCESS) {
-        return result;
+// Helper function to write records on the caller's thread and make them visible
+static ErrorCode write_records_directly(const QueuedLog* records, int count) {
+    unsigned long long sequence = 0;
+    ErrorCode result = SUCCESS;
+    for (int i = 0; i < count && result == SUCCESS; i++) {
+        result = write_log_entry(&records[i], &sequence);
+    }
+    if (result == SUCCESS) {
+        result = log_writer_flush(&log_writer);
+    }
+    if (result == SUCCESS) {
+        result = log_writer_commit(&log_writer, sequence);
     }
+    return result;
+}
 
-    // Also write to text log file for easier reading
-    FILE* text_log = fopen("logs/system.log", "a");
-    if (text_log) {
-        char time_str[30];
-        format_timestamp(log_entry.timestamp, time_str, sizeof(time_str));
+// Helper function to publish a staged batch, taking ownership of it. With done
+// set, the consumer raises it once the batch is written (and, per durability, synced).
+static ErrorCode publish_batch(LogMpscBatch* batch, atomic_int* done) {
+    batch->done = done;
+    if (log_mpsc_publish(&ingest_queue, batch) == SUCCESS) {
+        return SUCCESS;
+    }
 
-        fprintf(text_log, "[%s] USER: %s | MODULE: %s | ACTION: %s | DETAILS: %s\n",
-                time_str, user_id, module, action, details ? details : "");
-        fclose(text_log);
+    // The queue is closed: write the entries on this thread
+    ErrorCode result = write_records_directly(batch->records, batch->count);
+    if (done) {
+        atomic_store(done, 1);
     }
+    free(batch);
+    return result;
+}
 
-    return SUCCESS;
+// Helper function to check out a slot's batch, leaving marker in its place
+static LogMpscBatch* checkout_slot(StagingSlot* slot, LogMpscBatch* marker) {
+    LogMpscBatch* batch = atomic_load(&slot->batch);
+    for (;;) {
+        if (batch == SLOT_STAGING || batch == SLOT_PUBLISHING) {
+            sched_yield();
+            batch = atomic_load(&slot->batch);
+        } else if (atomic_compare_exchange_weak(&slot->batch, &batch, marker)) {
+            return batch;
+        }
+    }
 }
 
-// Function to log an error action
-ErrorCode log_error_action(const char* user_id, const char* module, const char* action, const char* details) {
-    if (!user_id || !module || !action) {
-        return ERROR_INVALID_INPUT;
+// Helper function to publish the entries staged in another thread's slot
+static void publish_slot(StagingSlot* slot) {
+    LogMpscBatch* batch = checkout_slot(slot, SLOT_PUBLISHING);
+    if (batch && batch->count > 0) {
+        publish_batch(batch, NULL);
+        batch = NULL;
     }
+    atomic_store(&slot->batch, batch);
+}
 
-    // Create log entry
-    LogEntry log_entry;
-    generate_unique_id(log_entry.logID, sizeof(log_entry.logID), "ERR");
+// Helper function to publish the entries staged on every thread
+static void publish_all_staging() {
+    pthread_mutex_lock(&staging_lock);
+    for (StagingSlot* slot = staging_slots; slot; slot = slot->next) {
+        publish_slot(slot);
+    }
+    pthread_mutex_unlock(&staging_lock);
+}
 
-    safe_strcpy(log_entry.userID, user_id, sizeof(log_entry.userID));
-    safe_strcpy(log_entry.module, module, sizeof(log_entry.module));
-    safe_strcpy(log_entry.action, action, sizeof(log_entry.action));
+// Helper function run at thread exit to publish entries the thread still stages
+static void release_staging(void* marker) {
+    StagingSlot* slot = marker;
 
-    if (details) {
-        safe_strcpy(log_entry.details, details, sizeof(log_entry.details));
+    pthread_mutex_lock(&staging_lock);
+    for (StagingSlot** link = &staging_slots; *link; link = &(*link)->next) {
+        if (*link == slot) {
+            *link = slot->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&staging_lock);
+
+    // Unlinked, so no flush can reach the slot any more
+    LogMpscBatch* batch = atomic_exchange(&slot->batch, NULL);
+    if (batch && batch->count > 0) {
+        publish_batch(batch, NULL);
     } else {
-        strcpy(log_entry.details, "");
+        free(batch);
+    }
+    free(slot);
+    staging_slot = NULL;
+}
+
+// Helper function to create the thread-exit hook for staging buffers
+static void create_staging_key() {
+    pthread_key_create(&staging_key, release_staging);
+}
+
+// Helper function to register the calling thread's staging slot
+static StagingSlot* register_staging_slot() {
+    StagingSlot* slot = malloc(sizeof(StagingSlot));
+    if (!slot) {
+        return NULL;
+    }
+    atomic_init(&slot->batch, NULL);
+
+    pthread_once(&staging_key_once, create_staging_key);
+    pthread_setspecific(staging_key, slot);
+
+    pthread_mutex_lock(&staging_lock);
+    slot->next = staging_slots;
+    staging_slots = slot;
+    pthread_mutex_unlock(&staging_lock);
+
+    staging_slot = slot;
+    return slot;
+}
+
+// Helper function to add an entry to the calling thread's staging buffer,
+// publishing the buffer once it holds lockfree_staging entries
+static ErrorCode stage_log_entry(const QueuedLog* record) {
+    StagingSlot* slot = staging_slot ? staging_slot : register_staging_slot();
+    if (!slot) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    LogMpscBatch* batch = checkout_slot(slot, SLOT_STAGING);
+    if (!batch) {
+        batch = log_mpsc_batch_new();
+        if (!batch) {
+            atomic_store(&slot->batch, NULL);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    batch->records[batch->count++] = *record;
+
+    // Durable acknowledgement cannot wait for the buffer to fill, and an entry
+    // staged after ingestion stopped would miss the final drain
+    int durable = atomic_load(&lockfree_durable);
+    ErrorCode result = SUCCESS;
+    atomic_int done = 0;
+    if (durable || batch->count >= atomic_load(&lockfree_staging) || !atomic_load(&lockfree_running)) {
+        result = publish_batch(batch, durable ? &done : NULL);
+        batch = NULL;
+    }
+
+    atomic_store(&slot->batch, batch);
+
+    if (durable && result == SUCCESS) {
+        log_mpsc_wait_done(&ingest_queue, &done);
     }
+    return result;
+}
 
-    log_entry.timestamp = time(NULL);
+// Helper function to write a barrier batch and wait until the consumer reaches it
+static void wait_ingest_drained() {
+    LogMpscBatch* barrier = log_mpsc_batch_new();
+    if (!barrier) {
+        return;
+    }
 
-    // Save to binary file using file_io module
-    ErrorCode result = save_log(&log_entry);
+    atomic_int done = 0;
+    barrier->done = &done;
+    if (log_mpsc_publish(&ingest_queue, barrier) != SUCCESS) {
+        free(barrier);
+        return;
+    }
+    log_mpsc_wait_done(&ingest_queue, &done);
+}
+
+// Helper function to start lock-free ingestion; caller holds mode_lock for writing
+static ErrorCode start_lockfree_writer() {
+    ErrorCode result = log_mpsc_open(&ingest_queue, log_config.queue_capacity, log_config.backpressure);
     if (result != SUCCESS) {
         return result;
     }
 
-    // Also write to error log file
-    FILE* error_log = fopen("logs/error.log", "a");
-    if (error_log) {
-        char time_str[30];
-        format_timestamp(log_entry.timestamp, time_str, sizeof(time_str));
+    if (pthread_create(&ingest_thread, NULL, ingest_main, NULL) != 0) {
+        log_mpsc_close(&ingest_queue);
+        return ERROR_FILE_OPERATION;
+    }
+
+    atomic_store(&lockfree_staging, log_config.staging_records > 0 ? log_config.staging_records : 1);
+    atomic_store(&lockfree_durable, log_config.durability.mode == LOG_DURABILITY_SYNC);
+    atomic_store(&lockfree_running, 1);
+    return SUCCESS;
+}
 
-        fprintf(error_log, "[%s] ERROR - USER: %s | MODULE: %s | ACTION: %s | DETAILS: %s\n",
-                time_str, user_id, module, action, details ? details : "");
-        fclose(error_log);
+// Helper function to drain and stop lock-free ingestion; caller holds mode_lock for writing
+static unsigned long long stop_lockfree_writer() {
+    if (!atomic_load(&lockfree_running)) {
+        return 0;
     }
 
+    // Producers that still see the flag running are refused by the closed
+    // queue and write their batch themselves
+    atomic_store(&lockfree_running, 0);
+    log_mpsc_close(&ingest_queue);
+    pthread_join(ingest_thread, NULL);
+
+    // Entries still staged on any thread are written here, in order after the queue
+    publish_all_staging();
+
+    return atomic_load(&ingest_queue.dropped);
+}
+
+// Helper function to start the async writer; caller holds mode_lock for writing
+static ErrorCode start_async_writer() {
+    ErrorCode result = log_queue_init(&log_queue, log_config.queue_capacity, log_config.backpressure);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        log_queue_destroy(&log_queue);
+        return ERROR_FILE_OPERATION;
+    }
+
+    async_running = 1;
     return SUCCESS;
 }
 
-// Function to get logs by date
-ErrorCode get_logs_by_date(const char* date, LogEntry** logs, int* count) {
-    if (!date || !logs || !count) {
+// Helper function to drain and stop the async writer; caller holds mode_lock for writing
+static unsigned long long stop_async_writer() {
+    if (!async_running) {
+        return 0;
+    }
+
+    log_queue_close(&log_queue);
+    pthread_join(writer_thread, NULL);
+
+    unsigned long long dropped = log_queue.dropped;
+    log_queue_destroy(&log_queue);
+    async_running = 0;
+    return dropped;
+}
+
+// Helper function to append a line to the system log
+static void write_system_line(const char* message) {
+    log_writer_write_line(&log_writer, message);
+    log_writer_flush(&log_writer);
+}
+
+// Helper function to report entries lost to backpressure
+static void report_dropped(unsigned long long dropped) {
+    if (dropped > 0) {
+        char message[100];
+        snprintf(message, sizeof(message), "ASYNC LOGGER DROPPED %llu ENTRIES", dropped);
+        write_system_line(message);
+    }
+}
+
+// Function to configure the logging mode; restarts the async writer if needed
+ErrorCode configure_logging(const LogConfig* config) {
+    if (!config || config->queue_capacity <= 0) {
         return ERROR_INVALID_INPUT;
     }
 
-    // First, count matching logs
-    LogEntry temp_log;
-    FILE* file = fopen("data/logs.dat", "rb");
-    if (!file) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;  // No logs file is not an error
+    if (config->mode < LOG_MODE_SYNC || config->mode > LOG_MODE_LOCKFREE) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (config->staging_records < 0 || config->staging_records > LOG_MPSC_BATCH_RECORDS) {
+        return ERROR_INVALID_INPUT;
     }
 
-    int matching_count = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        char date_str[11];
-        strftime(date_str, sizeof(date_str), "%Y-%m-%d", localtime(&temp_log.timestamp));
-        if (strcmp(date_str, date) == 0) {
-            matching_count++;
+    if (config->backpressure < LOG_BACKPRESSURE_BLOCK ||
+        config->backpressure > LOG_BACKPRESSURE_DROP_NEWEST) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Published lock-free batches are immutable, so there is no oldest entry to drop
+    if (config->mode == LOG_MODE_LOCKFREE && config->backpressure == LOG_BACKPRESSURE_DROP_OLDEST) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    pthread_rwlock_wrlock(&mode_lock);
+
+    unsigned long long dropped = stop_async_writer() + stop_lockfree_writer();
+
+    ErrorCode result = log_writer_set_durability(&log_writer, &config->durability);
+    if (result == SUCCESS) {
+        log_config = *config;
+    }
+
+    if (result == SUCCESS && logging_initialized) {
+        if (log_config.mode == LOG_MODE_ASYNC) {
+            result = start_async_writer();
+        } else if (log_config.mode == LOG_MODE_LOCKFREE) {
+            result = start_lockfree_writer();
         }
     }
-    fclose(file);
 
-    if (matching_count == 0) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;
+    pthread_rwlock_unlock(&mode_lock);
+
+    report_dropped(dropped);
+    return result;
+}
+
+// Function to initialize the logging system
+ErrorCode init_logging_system() {
+    // Open the sinks once; they stay open until cleanup_logging_system
+    ErrorCode open_result = log_writer_open(&log_writer);
+    if (open_result != SUCCESS) {
+        return open_result;
     }
 
-    // Allocate memory for matching logs
-    LogEntry* matching_logs = (LogEntry*)safe_malloc(matching_count * sizeof(LogEntry));
-    if (!matching_logs) {
-        return ERROR_MEMORY_ALLOCATION;
+    write_system_line("LOGGING SYSTEM INITIALIZED");
+
+    pthread_rwlock_wrlock(&mode_lock);
+
+    ErrorCode result = SUCCESS;
+    logging_initialized = 1;
+    if (log_config.mode == LOG_MODE_ASYNC && !async_running) {
+        result = start_async_writer();
+    } else if (log_config.mode == LOG_MODE_LOCKFREE && !atomic_load(&lockfree_running)) {
+        result = start_lockfree_writer();
     }
 
-    // Read matching logs again
-    file = fopen("data/logs.dat", "rb");
-    if (!file) {
-        safe_free((void**)&matching_logs);
-        return ERROR_FILE_OPERATION;
+    pthread_rwlock_unlock(&mode_lock);
+    return result;
+}
+
+// Helper function to hand a record to the async writer or write it directly
+static ErrorCode submit_log_entry(const QueuedLog* record) {
+    if (atomic_load(&lockfree_running)) {
+        return stage_log_entry(record);
     }
 
-    int index = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        char date_str[11];
-        strftime(date_str, sizeof(date_str), "%Y-%m-%d", localtime(&temp_log.timestamp));
-        if (strcmp(date_str, date) == 0) {
-            matching_logs[index] = temp_log;
-            index++;
+    pthread_rwlock_rdlock(&mode_lock);
+
+    if (async_running) {
+        unsigned long long ticket = 0;
+        ErrorCode result = log_queue_push(&log_queue, record, &ticket);
+
+        // Durable acknowledgement: wait for the writer batch that syncs this entry
+        if (result == SUCCESS && ticket > 0 && log_config.durability.mode == LOG_DURABILITY_SYNC) {
+            log_queue_wait_completed(&log_queue, ticket);
         }
+
+        pthread_rwlock_unlock(&mode_lock);
+        return result;
     }
-    fclose(file);
 
-    *logs = matching_logs;
-    *count = matching_count;
-    return SUCCESS;
+    pthread_rwlock_unlock(&mode_lock);
+
+    // Sync mode makes each entry visible to readers as soon as the call returns
+    return write_records_directly(record, 1);
 }
 
-// Function to get logs by user
-ErrorCode get_logs_by_user(const char* user_id, LogEntry** logs, int* count) {
-    if (!user_id || !logs || !count) {
+// Helper function to log a summary record for each (module, action) whose
+// events were sampled out, once per summary window or immediately with force
+static void write_sampling_summaries(int force) {
+    time_t now = time(NULL);
+    if (!force && !log_sampling_summary_due(now)) {
+        return;
+    }
+
+    LogSamplingSummary summaries[LOG_SAMPLING_MAX_POLICIES];
+    int count = log_sampling_collect(now, force, summaries, LOG_SAMPLING_MAX_POLICIES);
+    for (int i = 0; i < count; i++) {
+        char since[30];
+        format_timestamp(summaries[i].window_start, since, sizeof(since));
+
+        QueuedLog record;
+        char details[MAX_DETAILS_LEN];
+        snprintf(details, sizeof(details), "Sampled out %lld of %lld events since %s",
+                 summaries[i].suppressed, summaries[i].seen, since);
+        build_log_entry(&record.entry, "SUM", "SYSTEM", summaries[i].module, summaries[i].action, details);
+        record.is_error = 0;
+
+        if (submit_log_entry(&record) != SUCCESS) {
+            log_error(ERROR_FILE_OPERATION, "write_sampling_summaries", "Could not log sampling summary");
+        }
+    }
+}
+
+// Helper function to log an entry that passed the level check; sampled entries
+// are subject to the (module, action) policy
+static ErrorCode log_enabled_entry(LogLevel level, const char* user_id, const char* module,
+                                   const char* action, const char* details, int sampled) {
+    ErrorCode result = SUCCESS;
+    if (!sampled || log_sampling_admit(module, action)) {
+        QueuedLog record;
+        record.is_error = level >= LOG_LEVEL_ERROR;
+        build_log_entry(&record.entry, record.is_error ? "ERR" : "LOG", user_id, module, action, details);
+        result = submit_log_entry(&record);
+    }
+
+    write_sampling_summaries(0);
+    return result;
+}
+
+// Function to log an action at a level; entries below the module's level are
+// skipped, and entries sampled out by the (module, action) policy are counted
+// into summary records. ERROR and above also go to the error log.
+ErrorCode log_action_lvl(LogLevel level, const char* user_id, const char* module, const char* action,
+                         const char* details) {
+    if (!user_id || !module || !action) {
         return ERROR_INVALID_INPUT;
     }
 
-    // First, count matching logs
-    LogEntry temp_log;
-    FILE* file = fopen("data/logs.dat", "rb");
-    if (!file) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;  // No logs file is not an error
+    if (!log_level_enabled(level, module)) {
+        return SUCCESS;
     }
 
-    int matching_count = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        if (strcmp(temp_log.userID, user_id) == 0) {
-            matching_count++;
-        }
+    return log_enabled_entry(level, user_id, module, action, details, 1);
+}
+
+// Function to log an action that changes stored data; logged at INFO and
+// never sampled out, whatever policy its (module, action) has
+ErrorCode log_write_action(const char* user_id, const char* module, const char* action, const char* details) {
+    if (!user_id || !module || !action) {
+        return ERROR_INVALID_INPUT;
     }
-    fclose(file);
 
-    if (matching_count == 0) {
-        *logs = NULL;
-        *count = 0;
+    if (!log_level_enabled(LOG_LEVEL_INFO, module)) {
         return SUCCESS;
     }
 
-    // Allocate memory for matching logs
-    LogEntry* matching_logs = (LogEntry*)safe_malloc(matching_count * sizeof(LogEntry));
-    if (!matching_logs) {
-        return ERROR_MEMORY_ALLOCATION;
+    return log_enabled_entry(LOG_LEVEL_INFO, user_id, module, action, details, 0);
+}
+
+// Function to log an action at a level with printf-style details
+ErrorCode log_action_fmt(LogLevel level, const char* user_id, const char* module, const char* action,
+                         const char* format, ...) {
+    if (!format) {
+        return log_action_lvl(level, user_id, module, action, NULL);
     }
 
-    // Read matching logs again
-    file = fopen("data/logs.dat", "rb");
-    if (!file) {
-        safe_free((void**)&matching_logs);
-        return ERROR_FILE_OPERATION;
+    char details[MAX_DETAILS_LEN];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(details, sizeof(details), format, args);
+    va_end(args);
+
+    return log_action_lvl(level, user_id, module, action, details);
+}
+
+// Function to log an action
+ErrorCode log_action(const char* user_id, const char* module, const char* action, const char* details) {
+    return log_action_lvl(LOG_LEVEL_INFO, user_id, module, action, details);
+}
+
+// Function to log an error action
+ErrorCode log_error_action(const char* user_id, const char* module, const char* action, const char* details) {
+    return log_action_lvl(LOG_LEVEL_ERROR, user_id, module, action, details);
+}
+
+// Function to wait until every entry logged so far has reached the sinks
+ErrorCode flush_logging_system() {
+    // Readers see suppressed events accounted for up to now
+    write_sampling_summaries(1);
+
+    pthread_rwlock_rdlock(&mode_lock);
+
+    if (async_running) {
+        log_queue_wait_drained(&log_queue);
+    } else if (atomic_load(&lockfree_running)) {
+        publish_all_staging();
+        wait_ingest_drained();
     }
 
-    int index = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        if (strcmp(temp_log.userID, user_id) == 0) {
-            matching_logs[index] = temp_log;
-            index++;
-        }
+    pthread_rwlock_unlock(&mode_lock);
+    return log_writer_flush(&log_writer);
+}
+
+// Function to read the log writer counters
+ErrorCode get_log_writer_stats(LogWriterStats* stats) {
+    if (!stats) {
+        return ERROR_INVALID_INPUT;
     }
-    fclose(file);
 
-    *logs = matching_logs;
-    *count = matching_count;
+    log_writer_get_stats(&log_writer, stats);
     return SUCCESS;
 }
 
+// Function to get logs by date
+ErrorCode get_logs_by_date(const char* date, LogEntry** logs, int* count) {
+    if (!date || !logs || !count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Make queued and buffered entries visible to the reader
+    flush_logging_system();
+    return load_logs_by_date(date, logs, count);
+}
+
+// Function to get logs with start <= timestamp <= end
+ErrorCode get_logs_by_time_range(time_t start, time_t end, LogEntry** logs, int* count) {
+    if (!logs || !count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    flush_logging_system();
+    return load_logs_by_time_range(start, end, logs, count);
+}
+
+// Function to get logs by user
+ErrorCode get_logs_by_user(const char* user_id, LogEntry** logs, int* count) {
+    if (!user_id || !logs || !count) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    flush_logging_system();
+    return load_logs_by_user(user_id, logs, count);
+}
+
 // Function to get logs by module
 ErrorCode get_logs_by_module(const char* module, LogEntry** logs, int* count) {
     if (!module || !logs || !count) {
         return ERROR_INVALID_INPUT;
     }
 
-    // First, count matching logs
-    LogEntry temp_log;
-    FILE* file = fopen("data/logs.dat", "rb");
-    if (!file) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;  // No logs file is not an error
+    flush_logging_system();
+    return load_logs_by_module(module, logs, count);
+}
+
+// Function to get logs matching every predicate of a query, e.g. one user
+// in one module during a date range
+ErrorCode get_logs_matching(const LogQuery* query, LogEntry** logs, int* count) {
+    if (!query || !logs || !count) {
+        return ERROR_INVALID_INPUT;
     }
 
-    int matching_count = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        if (strcmp(temp_log.module, module) == 0) {
-            matching_count++;
+    flush_logging_system();
+    return load_logs_matching(query, logs, count);
+}
+
+// Helper function to find a module's override; caller holds level_lock
+static int find_level_override(const char* module) {
+    int count = atomic_load(&level_override_count);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(level_overrides[i].module, module) == 0) {
+            return i;
         }
     }
-    fclose(file);
+    return -1;
+}
 
-    if (matching_count == 0) {
-        *logs = NULL;
-        *count = 0;
-        return SUCCESS;
+// Helper function to recompute log_level_floor; caller holds level_lock for writing
+static void update_level_floor() {
+    int floor = atomic_load(&current_log_level);
+    int count = atomic_load(&level_override_count);
+    for (int i = 0; i < count; i++) {
+        if ((int)level_overrides[i].level < floor) {
+            floor = level_overrides[i].level;
+        }
     }
+    atomic_store(&log_level_floor, floor);
+}
 
-    // Allocate memory for matching logs
-    LogEntry* matching_logs = (LogEntry*)safe_malloc(matching_count * sizeof(LogEntry));
-    if (!matching_logs) {
-        return ERROR_MEMORY_ALLOCATION;
+// Function to set log level
+ErrorCode set_log_level(LogLevel level) {
+    if (level < LOG_LEVEL_DEBUG || level > LOG_LEVEL_CRITICAL) {
+        return ERROR_INVALID_INPUT;
     }
 
-    // Read matching logs again
-    file = fopen("data/logs.dat", "rb");
-    if (!file) {
-        safe_free((void**)&matching_logs);
-        return ERROR_FILE_OPERATION;
+    pthread_rwlock_wrlock(&level_lock);
+    atomic_store(&current_log_level, level);
+    update_level_floor();
+    pthread_rwlock_unlock(&level_lock);
+    return SUCCESS;
+}
+
+// Function to get log level
+LogLevel get_log_level() {
+    return (LogLevel)atomic_load(&current_log_level);
+}
+
+// Function to set the level of one module, overriding the global level
+ErrorCode set_module_log_level(const char* module, LogLevel level) {
+    if (!module || module[0] == '\0' || level < LOG_LEVEL_DEBUG || level > LOG_LEVEL_CRITICAL) {
+        return ERROR_INVALID_INPUT;
     }
 
-    int index = 0;
-    while (fread(&temp_log, sizeof(LogEntry), 1, file) == 1) {
-        if (strcmp(temp_log.module, module) == 0) {
-            matching_logs[index] = temp_log;
-            index++;
+    pthread_rwlock_wrlock(&level_lock);
+
+    int index = find_level_override(module);
+    if (index < 0) {
+        index = atomic_load(&level_override_count);
+        if (index >= MAX_LEVEL_OVERRIDES) {
+            pthread_rwlock_unlock(&level_lock);
+            return ERROR_INVALID_INPUT;
         }
+        safe_strcpy(level_overrides[index].module, module, sizeof(level_overrides[index].module));
+        level_overrides[index].level = level;
+        atomic_store(&level_override_count, index + 1);
+    } else {
+        level_overrides[index].level = level;
     }
-    fclose(file);
+    update_level_floor();
 
-    *logs = matching_logs;
-    *count = matching_count;
+    pthread_rwlock_unlock(&level_lock);
     return SUCCESS;
 }
 
-// Function to set log level
-ErrorCode set_log_level(LogLevel level) {
-    if (level < LOG_LEVEL_DEBUG || level > LOG_LEVEL_CRITICAL) {
+// Function to remove a module's override so it follows the global level again
+ErrorCode clear_module_log_level(const char* module) {
+    if (!module) {
         return ERROR_INVALID_INPUT;
     }
 
-    current_log_level = level;
+    pthread_rwlock_wrlock(&level_lock);
+
+    int index = find_level_override(module);
+    if (index < 0) {
+        pthread_rwlock_unlock(&level_lock);
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    int count = atomic_load(&level_override_count);
+    level_overrides[index] = level_overrides[count - 1];
+    atomic_store(&level_override_count, count - 1);
+    update_level_floor();
+
+    pthread_rwlock_unlock(&level_lock);
     return SUCCESS;
 }
 
-// Function to get log level
-LogLevel get_log_level() {
-    return current_log_level;
+// Function to get the level in effect for a module
+LogLevel get_module_log_level(const char* module) {
+    if (!module || atomic_load(&level_override_count) == 0) {
+        return get_log_level();
+    }
+
+    pthread_rwlock_rdlock(&level_lock);
+    int index = find_level_override(module);
+    LogLevel level = index >= 0 ? level_overrides[index].level : get_log_level();
+    pthread_rwlock_unlock(&level_lock);
+    return level;
+}
+
+// Function to check whether a module logs entries of a level
+int log_level_enabled(LogLevel level, const char* module) {
+    if ((int)level < atomic_load_explicit(&log_level_floor, memory_order_relaxed)) {
+        return 0;
+    }
+    return level >= get_module_log_level(module);
 }
 
 // Function to cleanup the logging system
 void cleanup_logging_system() {
-    // Log system shutdown
-    FILE* log_file = fopen("logs/system.log", "a");
-    if (log_file) {
-        time_t now;
-        time(&now);
-        char time_str[30];
-        format_timestamp(now, time_str, sizeof(time_str));
+    // Drain pending entries before the shutdown marker
+    write_sampling_summaries(1);
 
-        fprintf(log_file, "[%s] LOGGING SYSTEM SHUTDOWN\n", time_str);
-        fclose(log_file);
-    }
+    pthread_rwlock_wrlock(&mode_lock);
+    unsigned long long dropped = stop_async_writer() + stop_lockfree_writer();
+    logging_initialized = 0;
+    pthread_rwlock_unlock(&mode_lock);
+
+    report_dropped(dropped);
+
+    // Log system shutdown
+    write_system_line("LOGGING SYSTEM SHUTDOWN");
+    log_scan_shutdown();
+    log_writer_close(&log_writer);
 }
\ No newline at end of file
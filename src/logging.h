@@ -2,15 +2,11 @@
 #define LOGGING_H
 
 #include "data_structures.h"
-
-// Logging functions
-ErrorCode init_logging_system();
-ErrorCode log_action(const char* user_id, const char* module, const char* action, const char* details);
-ErrorCode log_error_action(const char* user_id, const char* module, const char* action, const char* details);
-ErrorCode get_logs_by_date(const char* date, LogEntry** logs, int* count);
-ErrorCode get_logs_by_user(const char* user_id, LogEntry** logs, int* count);
-ErrorCode get_logs_by_module(const char* module, LogEntry** logs, int* count);
-void cleanup_logging_system();
+#include "log_queue.h"
+#include "log_mpsc.h"
+#include "log_writer.h"
+#include "log_query.h"
+#include <stdatomic.h>
 
 // Log level management
 typedef enum {
@@ -21,7 +17,94 @@ typedef enum {
     LOG_LEVEL_CRITICAL = 4
 } LogLevel;
 
+// Levels below this are removed at compile time (-DLOG_COMPILE_MIN_LEVEL=1
+// drops every LOG_DEBUGF call, arguments included)
+#ifndef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL 0
+#endif
+
+// Lowest level any module currently accepts; maintained by the level setters
+// so a disabled call costs one load and one branch
+extern atomic_int log_level_floor;
+
+#define LOG_LEVEL_ACTIVE(level) \
+    ((int)(level) >= atomic_load_explicit(&log_level_floor, memory_order_relaxed))
+
+// Leveled logging; details are only formatted when the level is enabled
+#define LOG_ATF(level, user_id, module, action, ...) \
+    (LOG_LEVEL_ACTIVE(level) ? log_action_fmt((level), (user_id), (module), (action), __VA_ARGS__) \
+                             : SUCCESS)
+
+// Stands in for calls removed at compile time
+static inline ErrorCode log_elided(void) {
+    return SUCCESS;
+}
+
+#if LOG_COMPILE_MIN_LEVEL <= 0
+#define LOG_DEBUGF(user_id, module, action, ...) LOG_ATF(LOG_LEVEL_DEBUG, user_id, module, action, __VA_ARGS__)
+#else
+#define LOG_DEBUGF(user_id, module, action, ...) log_elided()
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 1
+#define LOG_INFOF(user_id, module, action, ...) LOG_ATF(LOG_LEVEL_INFO, user_id, module, action, __VA_ARGS__)
+#else
+#define LOG_INFOF(user_id, module, action, ...) log_elided()
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 2
+#define LOG_WARNF(user_id, module, action, ...) LOG_ATF(LOG_LEVEL_WARNING, user_id, module, action, __VA_ARGS__)
+#else
+#define LOG_WARNF(user_id, module, action, ...) log_elided()
+#endif
+
+#define LOG_ERRORF(user_id, module, action, ...) LOG_ATF(LOG_LEVEL_ERROR, user_id, module, action, __VA_ARGS__)
+
+// Logging modes
+typedef enum {
+    LOG_MODE_SYNC = 0,   // Entries are written on the caller's thread
+    LOG_MODE_ASYNC = 1,  // Entries are queued and written by a background thread
+    LOG_MODE_LOCKFREE = 2 // Threads stage entries and publish them to a lock-free queue
+} LogMode;
+
+// Logging configuration
+typedef struct {
+    LogMode mode;
+    int queue_capacity;           // Ring buffer slots in async mode
+    LogBackpressure backpressure; // Policy when the ring buffer is full; lock-free
+                                  // mode rejects DROP_OLDEST
+    LogDurability durability;     // fdatasync policy for the binary audit log
+    int staging_records;          // Lock-free mode: entries a thread stages per publish
+                                  // (1..LOG_MPSC_BATCH_RECORDS, 0 means 1). Entries still
+                                  // staged are published by the next flush_logging_system
+                                  // call on any thread, by cleanup, or when the thread exits.
+} LogConfig;
+
+// Logging functions
+ErrorCode configure_logging(const LogConfig* config);
+ErrorCode init_logging_system();
+ErrorCode log_action(const char* user_id, const char* module, const char* action, const char* details);
+ErrorCode log_error_action(const char* user_id, const char* module, const char* action, const char* details);
+ErrorCode log_write_action(const char* user_id, const char* module, const char* action, const char* details);
+ErrorCode log_action_lvl(LogLevel level, const char* user_id, const char* module, const char* action,
+                         const char* details);
+ErrorCode log_action_fmt(LogLevel level, const char* user_id, const char* module, const char* action,
+                         const char* format, ...);
+ErrorCode get_logs_by_date(const char* date, LogEntry** logs, int* count);
+ErrorCode get_logs_by_time_range(time_t start, time_t end, LogEntry** logs, int* count);
+ErrorCode get_logs_by_user(const char* user_id, LogEntry** logs, int* count);
+ErrorCode get_logs_by_module(const char* module, LogEntry** logs, int* count);
+ErrorCode get_logs_matching(const LogQuery* query, LogEntry** logs, int* count);
+ErrorCode flush_logging_system();
+ErrorCode get_log_writer_stats(LogWriterStats* stats);
+void cleanup_logging_system();
+
+// Global level, and per-module overrides that take precedence over it
 ErrorCode set_log_level(LogLevel level);
 LogLevel get_log_level();
+ErrorCode set_module_log_level(const char* module, LogLevel level);
+ErrorCode clear_module_log_level(const char* module);
+LogLevel get_module_log_level(const char* module);
+int log_level_enabled(LogLevel level, const char* module);
 
 #endif // LOGGING_H
\ No newline at end of file
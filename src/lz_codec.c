@@ -0,0 +1,194 @@
+#include "lz_codec.h"
+#include <string.h>
+#include <stdint.h>
+
+#define LZ_HASH_BITS 14
+#define LZ_MAX_OFFSET 65535
+
+// Helper function to read four bytes for hashing and match checks
+static uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t hash32(uint32_t value) {
+    return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Helper function to write the 255-run extension of a length field
+static unsigned char* write_length(unsigned char* op, const unsigned char* op_end, size_t length) {
+    while (length >= 255) {
+        if (op >= op_end) {
+            return NULL;
+        }
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= op_end) {
+        return NULL;
+    }
+    *op++ = (unsigned char)length;
+    return op;
+}
+
+// Helper function to emit one sequence; match_length 0 marks the final literals
+static unsigned char* write_sequence(unsigned char* op, const unsigned char* op_end,
+                                     const unsigned char* literals, size_t literal_length,
+                                     size_t offset, size_t match_length) {
+    if (op >= op_end) {
+        return NULL;
+    }
+
+    unsigned char* token = op++;
+    size_t match_code = match_length > 0 ? match_length - LZ_MIN_MATCH : 0;
+    *token = (unsigned char)(((literal_length >= 15 ? 15 : literal_length) << 4) |
+                             (match_code >= 15 ? 15 : match_code));
+
+    if (literal_length >= 15 && !(op = write_length(op, op_end, literal_length - 15))) {
+        return NULL;
+    }
+    if ((size_t)(op_end - op) < literal_length) {
+        return NULL;
+    }
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (match_length == 0) {
+        return op;
+    }
+
+    if (op_end - op < 2) {
+        return NULL;
+    }
+    *op++ = (unsigned char)(offset & 0xff);
+    *op++ = (unsigned char)(offset >> 8);
+
+    if (match_code >= 15 && !(op = write_length(op, op_end, match_code - 15))) {
+        return NULL;
+    }
+    return op;
+}
+
+size_t lz_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+// Function to compress one block with a single-probe hash table of recent positions
+size_t lz_compress(const unsigned char* src, size_t src_size, unsigned char* dst, size_t dst_capacity) {
+    if (!src || !dst) {
+        return 0;
+    }
+
+    uint32_t table[1 << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));  // Position 0 doubles as "empty"; it is verified anyway
+
+    unsigned char* op = dst;
+    const unsigned char* op_end = dst + dst_capacity;
+    size_t anchor = 0;
+    size_t ip = 0;
+
+    while (src_size >= LZ_MIN_MATCH && ip + LZ_MIN_MATCH <= src_size) {
+        uint32_t sequence = read32(src + ip);
+        uint32_t hash = hash32(sequence);
+        size_t candidate = table[hash];
+        table[hash] = (uint32_t)ip;
+
+        if (candidate >= ip || ip - candidate > LZ_MAX_OFFSET || read32(src + candidate) != sequence) {
+            ip++;
+            continue;
+        }
+
+        size_t length = LZ_MIN_MATCH;
+        while (ip + length < src_size && src[candidate + length] == src[ip + length]) {
+            length++;
+        }
+
+        op = write_sequence(op, op_end, src + anchor, ip - anchor, ip - candidate, length);
+        if (!op) {
+            return 0;
+        }
+
+        ip += length;
+        anchor = ip;
+        if (ip >= 2 && ip + LZ_MIN_MATCH <= src_size) {
+            table[hash32(read32(src + ip - 2))] = (uint32_t)(ip - 2);
+        }
+    }
+
+    op = write_sequence(op, op_end, src + anchor, src_size - anchor, 0, 0);
+    return op ? (size_t)(op - dst) : 0;
+}
+
+// Helper function to read a length extension; returns 0 on truncated input
+static int read_length(const unsigned char** ip, const unsigned char* ip_end, size_t* length) {
+    unsigned char byte;
+    do {
+        if (*ip >= ip_end) {
+            return 0;
+        }
+        byte = *(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+    return 1;
+}
+
+// Function to decompress one block, checking every bound against corrupt input
+size_t lz_decompress(const unsigned char* src, size_t src_size, unsigned char* dst, size_t dst_capacity) {
+    if (!src || !dst) {
+        return (size_t)-1;
+    }
+
+    const unsigned char* ip = src;
+    const unsigned char* ip_end = src + src_size;
+    unsigned char* op = dst;
+    unsigned char* op_end = dst + dst_capacity;
+
+    while (ip < ip_end) {
+        unsigned char token = *ip++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(&ip, ip_end, &literal_length)) {
+            return (size_t)-1;
+        }
+        if ((size_t)(ip_end - ip) < literal_length || (size_t)(op_end - op) < literal_length) {
+            return (size_t)-1;
+        }
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        if (ip == ip_end) {
+            break;  // Final sequence carries literals only
+        }
+
+        if (ip_end - ip < 2) {
+            return (size_t)-1;
+        }
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+
+        size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(&ip, ip_end, &match_length)) {
+            return (size_t)-1;
+        }
+        match_length += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > (size_t)(op - dst) || (size_t)(op_end - op) < match_length) {
+            return (size_t)-1;
+        }
+
+        // Byte-wise copy so overlapping matches replicate runs
+        const unsigned char* match = op - offset;
+        if (offset >= match_length) {
+            memcpy(op, match, match_length);
+            op += match_length;
+        } else {
+            for (size_t i = 0; i < match_length; i++) {
+                *op++ = match[i];
+            }
+        }
+    }
+
+    return (size_t)(op - dst);
+}
@@ -0,0 +1,22 @@
+#ifndef LZ_CODEC_H
+#define LZ_CODEC_H
+
+#include <stddef.h>
+
+// Small LZ77 byte codec in the style of LZ4: sequences of literals followed
+// by a back-reference of at least LZ_MIN_MATCH bytes within a 64 KB window.
+// It favours speed over ratio and excels at the long zero runs that pad
+// fixed-size records. Each call compresses one independent block.
+
+#define LZ_MIN_MATCH 4
+
+// Largest possible compressed size of size input bytes
+size_t lz_compress_bound(size_t size);
+
+// Returns the compressed size, or 0 when dst is too small
+size_t lz_compress(const unsigned char* src, size_t src_size, unsigned char* dst, size_t dst_capacity);
+
+// Returns the decompressed size, or (size_t)-1 on corrupt input or a short dst
+size_t lz_decompress(const unsigned char* src, size_t src_size, unsigned char* dst, size_t dst_capacity);
+
+#endif // LZ_CODEC_H
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <time.h>
+#include <pthread.h>
 
 // Include all module headers
 #include "data_structures.h"
@@ -29,6 +30,10 @@
 #include "officer.h"
 #include "payment.h"
 #include "logging.h"
+#include "log_query.h"
+#include "log_follow.h"
+#include "log_aggregate.h"
+#include "log_retention.h"
 #include "ui.h"
 #include "file_io.h"
 #include "utils.h"
@@ -50,6 +55,11 @@ void handle_student_logging();
 void handle_officer_logging();
 void handle_payment_processing();
 void handle_view_logs();
+void follow_live_logs();
+void show_log_dashboard();
+
+// Longest time an audit entry waits for fdatasync
+#define LOG_SYNC_INTERVAL_MS 200
 
 /**
  * Initialize the system
@@ -58,6 +68,17 @@ ErrorCode initialize_system() {
     // Initialize all subsystems
     ErrorCode result;
     
+    // Write audit entries from a background thread so operations don't wait on log I/O.
+    // Entries are synced in groups at most LOG_SYNC_INTERVAL_MS after they are logged,
+    // instead of one fdatasync per entry on this single-threaded menu.
+    LogConfig log_config = { LOG_MODE_ASYNC, 4096, LOG_BACKPRESSURE_BLOCK,
+                             { LOG_DURABILITY_INTERVAL, LOG_SYNC_INTERVAL_MS, 0 }, 1 };
+    result = configure_logging(&log_config);
+    if (result != SUCCESS) {
+        fprintf(stderr, "Failed to configure logging system: %s\n", get_error_message(result));
+        return result;
+    }
+    
     // Initialize logging system first
     result = init_logging_system();
     if (result != SUCCESS) {
@@ -65,6 +86,12 @@ ErrorCode initialize_system() {
         return result;
     }
     
+    // Keep raw audit records 90 days and hourly rollups 2 years, enforced in the background
+    result = log_retention_start(NULL);
+    if (result != SUCCESS) {
+        log_error(result, "main", "Failed to start log retention");
+    }
+    
     // Initialize authentication system
     result = init_auth_system();
     if (result != SUCCESS) {
@@ -88,6 +115,9 @@ void cleanup_system() {
     // Cleanup authentication system
     cleanup_auth_system();
     
+    // Stop log retention before the store closes
+    log_retention_stop();
+    
     // Cleanup logging system
     cleanup_logging_system();
 }
@@ -324,10 +354,12 @@ void show_log_menu() {
         "[2] View Logs by User",
         "[3] View Logs by Module",
         "[4] View All Logs",
-        "[5] Back to Main Menu"
+        "[5] Follow Live Logs",
+        "[6] Activity Dashboard",
+        "[7] Back to Main Menu"
     };
     
-    print_menu("Log Operations", options, 5);
+    print_menu("Log Operations", options, 7);
 }
 
 /**
@@ -824,6 +856,9 @@ void handle_payment_operations() {
     }
 }
 
+// Records shown per page of the full log listing
+#define LOG_VIEW_PAGE_SIZE 20
+
 /**
  * Handle log operations
  */
@@ -833,26 +868,23 @@ void handle_log_operations() {
     while (log_menu_active) {
         show_log_menu();
         
-        int choice = get_user_choice(1, 5);
+        int choice = get_user_choice(1, 7);
         
         switch (choice) {
             case 1: {  // View Logs by Date
                 char date[11];
                 get_string_input(date, sizeof(date), "Enter Date (YYYY-MM-DD): ");
                 
-                LogEntry* logs = NULL;
-                int count = 0;
+                // Records are streamed to the screen instead of being loaded into memory
+                flush_logging_system();
+                print_separator();
+                printf("Logs for Date '%s':\n", date);
                 
-                ErrorCode result = get_logs_by_date(date, &logs, &count);
+                int shown = 0;
+                ErrorCode result = log_query_foreach_date(date, display_log_row, &shown);
                 if (result == SUCCESS) {
+                    display_log_rows_end(shown);
                     print_separator();
-                    printf("Logs for Date '%s' (%d total):\n", date, count);
-                    display_log_list(logs, count);
-                    print_separator();
-                    
-                    if (logs) {
-                        safe_free((void**)&logs);
-                    }
                 } else {
                     print_error(get_error_message(result));
                 }
@@ -862,19 +894,15 @@ void handle_log_operations() {
                 char user_id[20];
                 get_string_input(user_id, sizeof(user_id), "Enter User ID to view logs for: ");
                 
-                LogEntry* logs = NULL;
-                int count = 0;
+                flush_logging_system();
+                print_separator();
+                printf("Logs for User '%s':\n", user_id);
                 
-                ErrorCode result = get_logs_by_user(user_id, &logs, &count);
+                int shown = 0;
+                ErrorCode result = log_query_foreach_user(user_id, display_log_row, &shown);
                 if (result == SUCCESS) {
+                    display_log_rows_end(shown);
                     print_separator();
-                    printf("Logs for User '%s' (%d total):\n", user_id, count);
-                    display_log_list(logs, count);
-                    print_separator();
-                    
-                    if (logs) {
-                        safe_free((void**)&logs);
-                    }
                 } else {
                     print_error(get_error_message(result));
                 }
@@ -884,44 +912,64 @@ void handle_log_operations() {
                 char module[20];
                 get_string_input(module, sizeof(module), "Enter Module to view logs for (Auth/Student/Officer/Payment): ");
                 
-                LogEntry* logs = NULL;
-                int count = 0;
+                flush_logging_system();
+                print_separator();
+                printf("Logs for Module '%s':\n", module);
                 
-                ErrorCode result = get_logs_by_module(module, &logs, &count);
+                int shown = 0;
+                ErrorCode result = log_query_foreach_module(module, display_log_row, &shown);
                 if (result == SUCCESS) {
+                    display_log_rows_end(shown);
                     print_separator();
-                    printf("Logs for Module '%s' (%d total):\n", module, count);
-                    display_log_list(logs, count);
-                    print_separator();
-                    
-                    if (logs) {
-                        safe_free((void**)&logs);
-                    }
                 } else {
                     print_error(get_error_message(result));
                 }
                 break;
             }
             case 4: {  // View All Logs
-                LogEntry* logs = NULL;
-                int count = 0;
+                // Newest first, one page at a time: each page reads only its own records
+                flush_logging_system();
+                print_separator();
+                printf("All Logs (newest first):\n");
                 
-                ErrorCode result = load_all_logs(&logs, &count);
-                if (result == SUCCESS) {
-                    print_separator();
-                    printf("All Logs (%d total):\n", count);
-                    display_log_list(logs, count);
-                    print_separator();
+                LogQuery query = {0, 0, NULL, NULL, NULL, NULL, NULL};
+                LogEntry records[LOG_VIEW_PAGE_SIZE];
+                LogPage page = {records, LOG_VIEW_PAGE_SIZE, 0, ""};
+                char token[LOG_PAGE_TOKEN_LEN] = "";
+                int shown = 0;
+                ErrorCode result;
+                
+                while ((result = log_query_page(&query, LOG_PAGE_NEWEST_FIRST, token, &page)) == SUCCESS) {
+                    for (int i = 0; i < page.count; i++) {
+                        display_log_row(&page.records[i], &shown);
+                    }
+                    if (page.next_token[0] == '\0') {
+                        break;
+                    }
                     
-                    if (logs) {
-                        safe_free((void**)&logs);
+                    char answer[8];
+                    get_string_input(answer, sizeof(answer), "Press Enter for more, or Q to stop: ");
+                    if (answer[0] == 'q' || answer[0] == 'Q') {
+                        break;
                     }
+                    strcpy(token, page.next_token);
+                }
+                
+                if (result == SUCCESS) {
+                    display_log_rows_end(shown);
+                    print_separator();
                 } else {
                     print_error(get_error_message(result));
                 }
                 break;
             }
-            case 5:  // Back to Main Menu
+            case 5:  // Follow Live Logs
+                follow_live_logs();
+                break;
+            case 6:  // Activity Dashboard
+                show_log_dashboard();
+                break;
+            case 7:  // Back to Main Menu
                 log_menu_active = false;
                 break;
             default:
@@ -929,9 +977,147 @@ void handle_log_operations() {
                 break;
         }
         
-        if (log_menu_active && choice != 5) {
+        if (log_menu_active && choice != 5 && choice != 7) {
             printf("\nPress Enter to continue...");
             getchar();
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Live log display: a background thread follows the audit log
+ * while the menu thread waits for Enter
+ */
+typedef struct {
+    LogFollowOptions options;
+    atomic_int stop;
+    int shown;
+} LiveLogView;
+
+static int display_followed_log(const LogEntry* log, long long offset, void* context) {
+    (void)offset;
+    display_log_row(log, context);
+    fflush(stdout);
+    return 0;
+}
+
+static void* follow_logs_thread(void* arg) {
+    LiveLogView* view = (LiveLogView*)arg;
+    ErrorCode result = log_follow(LOG_FOLLOW_RESUME, display_followed_log, &view->shown, &view->options);
+    if (result != SUCCESS) {
+        print_error(get_error_message(result));
+    }
+    return NULL;
+}
+
+void follow_live_logs() {
+    char user_id[20];
+    char module[20];
+    get_string_input(user_id, sizeof(user_id), "Filter by User ID (blank for all): ");
+    get_string_input(module, sizeof(module), "Filter by Module (blank for all): ");
+    
+    // Resume where the last follow stopped, so nothing logged in between is missed
+    flush_logging_system();
+    
+    LiveLogView view;
+    memset(&view, 0, sizeof(view));
+    view.options.offset_path = LOG_FOLLOW_DEFAULT_OFFSET_FILE;
+    view.options.user_id = user_id;
+    view.options.module = module;
+    view.options.stop = &view.stop;
+    atomic_init(&view.stop, 0);
+    
+    print_separator();
+    printf("Following logs (press Enter to stop)...\n");
+    
+    pthread_t follower;
+    if (pthread_create(&follower, NULL, follow_logs_thread, &view) != 0) {
+        print_error("Could not start log follower");
+        return;
+    }
+    
+    getchar();
+    atomic_store(&view.stop, 1);
+    pthread_join(follower, NULL);
+    
+    display_log_rows_end(view.shown);
+    print_separator();
+}
+
+/**
+ * Activity dashboard: audit statistics computed by aggregation
+ * queries, without loading the log entries themselves
+ */
+#define DASHBOARD_HOURS 24
+#define DASHBOARD_DAYS 7
+
+// Failed logins are logged by SYSTEM; the account tried ends the details
+static int failed_login_account(const LogEntry* log, char* key, size_t key_size, void* context) {
+    (void)context;
+    const char* account = strrchr(log->details, ':');
+    if (!account) {
+        return 0;
+    }
+    account++;
+    while (*account == ' ') {
+        account++;
+    }
+    safe_strcpy(key, account, key_size);
+    return key[0] != '\0';
+}
+
+void show_log_dashboard() {
+    flush_logging_system();
+    
+    // Windows start on local hour and day boundaries so sealed segments are
+    // answered from their summaries
+    time_t now = time(NULL);
+    struct tm local = *localtime(&now);
+    time_t hour_start = now - (local.tm_min * 60 + local.tm_sec);
+    
+    local.tm_mday -= DASHBOARD_DAYS - 1;
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_isdst = -1;
+    time_t week_start = mktime(&local);
+    
+    LogAggregateQuery logins;
+    memset(&logins, 0, sizeof(logins));
+    logins.group_by = LOG_GROUP_HOUR;
+    logins.start = hour_start - (DASHBOARD_HOURS - 1) * 3600;
+    logins.module = "Auth";
+    logins.action = "Login";
+    
+    LogAggregateQuery failures;
+    memset(&failures, 0, sizeof(failures));
+    failures.group_by = LOG_GROUP_CUSTOM;
+    failures.start = week_start;
+    failures.module = "Auth";
+    failures.action = "Login Failed";
+    failures.key_function = failed_login_account;
+    
+    LogAggregateResult result;
+    ErrorCode status = log_aggregate(&logins, &result);
+    if (status != SUCCESS) {
+        print_error(get_error_message(status));
+        return;
+    }
+    
+    print_separator();
+    printf("Logins per Hour (last %d hours):\n", DASHBOARD_HOURS);
+    display_log_aggregate(&result, logins.group_by, "Hour");
+    log_aggregate_free(&result);
+    
+    status = log_aggregate(&failures, &result);
+    if (status != SUCCESS) {
+        print_error(get_error_message(status));
+        return;
+    }
+    
+    print_separator();
+    printf("Failed Logins per User (last %d days):\n", DASHBOARD_DAYS);
+    display_log_aggregate(&result, failures.group_by, "User");
+    log_aggregate_free(&result);
+    print_separator();
+}
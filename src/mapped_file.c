@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "mapped_file.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// Function to read a whole file into a heap buffer in place of a mapping
+ErrorCode mapped_file_open(const char* path, MappedAccess access, MappedFile* file) {
+    (void)access;
+    if (!path || !file) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(file, 0, sizeof(MappedFile));
+
+    FILE* source = fopen(path, "rb");
+    if (!source) {
+        return ERROR_DATA_NOT_FOUND;
+    }
+
+    fseek(source, 0, SEEK_END);
+    long size = ftell(source);
+    fseek(source, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(source);
+        return size < 0 ? ERROR_FILE_OPERATION : SUCCESS;
+    }
+
+    void* data = safe_malloc((size_t)size);
+    if (!data) {
+        fclose(source);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    size_t read_size = fread(data, 1, (size_t)size, source);
+    fclose(source);
+
+    file->data = data;
+    file->size = read_size;
+    return SUCCESS;
+}
+
+void mapped_file_advise(MappedFile* file, MappedAccess access) {
+    (void)file;
+    (void)access;
+}
+
+void mapped_file_close(MappedFile* file) {
+    if (!file) {
+        return;
+    }
+
+    void* data = (void*)file->data;
+    safe_free(&data);
+    memset(file, 0, sizeof(MappedFile));
+}
+#else
+// Function to map a whole file read-only
+ErrorCode mapped_file_open(const char* path, MappedAccess access, MappedFile* file) {
+    if (!path || !file) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    memset(file, 0, sizeof(MappedFile));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? ERROR_DATA_NOT_FOUND : ERROR_FILE_OPERATION;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return ERROR_FILE_OPERATION;
+    }
+
+    // mmap rejects zero-length mappings; an empty file is an empty view
+    if (info.st_size == 0) {
+        close(fd);
+        return SUCCESS;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        log_error(ERROR_FILE_OPERATION, "mapped_file_open", "Could not map data file");
+        return ERROR_FILE_OPERATION;
+    }
+
+    file->data = data;
+    file->size = (size_t)info.st_size;
+    file->mapped = 1;
+    mapped_file_advise(file, access);
+    return SUCCESS;
+}
+
+// Function to tell the kernel how the mapping will be read
+void mapped_file_advise(MappedFile* file, MappedAccess access) {
+    if (!file || !file->mapped) {
+        return;
+    }
+
+    madvise((void*)file->data, file->size,
+            access == MAPPED_ACCESS_RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+}
+
+// Function to unmap a file
+void mapped_file_close(MappedFile* file) {
+    if (!file) {
+        return;
+    }
+
+    if (file->mapped) {
+        munmap((void*)file->data, file->size);
+    }
+    memset(file, 0, sizeof(MappedFile));
+}
+#endif
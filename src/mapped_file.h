@@ -0,0 +1,27 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "data_structures.h"
+#include <stddef.h>
+
+// Read-only memory mapping of a whole data file. Records are read in place
+// from the page cache instead of being copied into heap buffers. Platforms
+// without mmap fall back to reading the file into one heap buffer.
+
+typedef enum {
+    MAPPED_ACCESS_SEQUENTIAL = 0,  // Front-to-back scans: aggressive read-ahead
+    MAPPED_ACCESS_RANDOM = 1       // Scattered lookups: no read-ahead
+} MappedAccess;
+
+typedef struct {
+    const void* data;   // NULL for an empty file
+    size_t size;
+    int mapped;         // 0 when data is a heap copy
+} MappedFile;
+
+// Returns ERROR_DATA_NOT_FOUND when the file does not exist
+ErrorCode mapped_file_open(const char* path, MappedAccess access, MappedFile* file);
+void mapped_file_advise(MappedFile* file, MappedAccess access);
+void mapped_file_close(MappedFile* file);
+
+#endif // MAPPED_FILE_H
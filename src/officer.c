@@ -2,7 +2,9 @@
 #include "file_io.h"
 #include "logging.h"
 #include "utils.h"
+#include "field_match.h"
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -39,7 +41,7 @@ ErrorCode create_officer(const Officer* officer) {
     char log_details[200];
     snprintf(log_details, sizeof(log_details), "Created officer: %s (%s)", 
              officer->officerID, officer->name);
-    log_action("SYSTEM", "Officer", "Create", log_details);
+    log_write_action("SYSTEM", "Officer", "Create", log_details);
     
     return SUCCESS;
 }
@@ -53,9 +55,7 @@ ErrorCode retrieve_officer(const char* officer_id, Officer* officer) {
     ErrorCode result = load_officer(officer_id, officer);
     if (result == SUCCESS) {
         // Log the action
-        char log_details[100];
-        snprintf(log_details, sizeof(log_details), "Retrieved officer: %s", officer_id);
-        log_action("SYSTEM", "Officer", "Retrieve", log_details);
+        LOG_INFOF("SYSTEM", "Officer", "Retrieve", "Retrieved officer: %s", officer_id);
     }
     
     return result;
@@ -80,7 +80,7 @@ ErrorCode update_officer_record(const Officer* officer) {
         char log_details[200];
         snprintf(log_details, sizeof(log_details), "Updated officer: %s (%s)", 
                  officer->officerID, officer->name);
-        log_action("SYSTEM", "Officer", "Update", log_details);
+        log_write_action("SYSTEM", "Officer", "Update", log_details);
     }
     
     return result;
@@ -106,7 +106,7 @@ ErrorCode delete_officer_record(const char* officer_id) {
         char log_details[200];
         snprintf(log_details, sizeof(log_details), "Deleted officer: %s (%s)", 
                  officer.officerID, officer.name);
-        log_action("SYSTEM", "Officer", "Delete", log_details);
+        log_write_action("SYSTEM", "Officer", "Delete", log_details);
     }
     
     return result;
@@ -167,9 +167,7 @@ ErrorCode list_all_officers_sorted(Officer** officers, int* count, const char* s
     }
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Listed all officers sorted by: %s", sort_by);
-    log_action("SYSTEM", "Officer", "List", log_details);
+    LOG_INFOF("SYSTEM", "Officer", "List", "Listed all officers sorted by: %s", sort_by);
     
     return SUCCESS;
 }
@@ -180,13 +178,14 @@ ErrorCode search_officers_by_name(const char* name, Officer** officers, int* cou
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all officers
-    Officer* all_officers = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_officers(&all_officers, &total_count);
+    // Filter the mapped officers in place; only matches are copied
+    OfficerView view;
+    ErrorCode result = view_all_officers(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Officer* all_officers = view.items;
+    int total_count = view.count;
     
     // Count matching officers
     int matching_count = 0;
@@ -197,7 +196,7 @@ ErrorCode search_officers_by_name(const char* name, Officer** officers, int* cou
     }
     
     if (matching_count == 0) {
-        safe_free((void**)&all_officers);
+        release_officer_view(&view);
         *officers = NULL;
         *count = 0;
         return SUCCESS;
@@ -206,7 +205,7 @@ ErrorCode search_officers_by_name(const char* name, Officer** officers, int* cou
     // Create array for matching officers
     Officer* matching_officers = (Officer*)safe_malloc(matching_count * sizeof(Officer));
     if (!matching_officers) {
-        safe_free((void**)&all_officers);
+        release_officer_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
@@ -219,14 +218,12 @@ ErrorCode search_officers_by_name(const char* name, Officer** officers, int* cou
         }
     }
     
-    safe_free((void**)&all_officers);
+    release_officer_view(&view);
     *officers = matching_officers;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched officers by name: %s", name);
-    log_action("SYSTEM", "Officer", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Officer", "Search", "Searched officers by name: %s", name);
     
     return SUCCESS;
 }
@@ -237,24 +234,23 @@ ErrorCode search_officers_by_position(const char* position, Officer** officers,
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all officers
-    Officer* all_officers = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_officers(&all_officers, &total_count);
+    // Filter the mapped officers in place; only matches are copied
+    OfficerView view;
+    ErrorCode result = view_all_officers(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Officer* all_officers = view.items;
+    int total_count = view.count;
     
     // Count matching officers
-    int matching_count = 0;
-    for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_officers[i].position, position) == 0) {
-            matching_count++;
-        }
-    }
+    FieldPattern pattern;
+    field_pattern_init(&pattern, position, sizeof(all_officers[0].position), FIELD_MATCH_EQUAL);
+    int matching_count = field_match_block(&pattern, all_officers, sizeof(Officer), offsetof(Officer, position),
+                                           total_count, NULL);
     
     if (matching_count == 0) {
-        safe_free((void**)&all_officers);
+        release_officer_view(&view);
         *officers = NULL;
         *count = 0;
         return SUCCESS;
@@ -263,27 +259,25 @@ ErrorCode search_officers_by_position(const char* position, Officer** officers,
     // Create array for matching officers
     Officer* matching_officers = (Officer*)safe_malloc(matching_count * sizeof(Officer));
     if (!matching_officers) {
-        safe_free((void**)&all_officers);
+        release_officer_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
     // Copy matching officers
     int index = 0;
     for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_officers[i].position, position) == 0) {
+        if (field_match_record(&pattern, &all_officers[i], sizeof(Officer), offsetof(Officer, position))) {
             matching_officers[index] = all_officers[i];
             index++;
         }
     }
     
-    safe_free((void**)&all_officers);
+    release_officer_view(&view);
     *officers = matching_officers;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched officers by position: %s", position);
-    log_action("SYSTEM", "Officer", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Officer", "Search", "Searched officers by position: %s", position);
     
     return SUCCESS;
 }
@@ -294,13 +288,14 @@ ErrorCode search_officers_by_access_level(int access_level, Officer** officers,
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all officers
-    Officer* all_officers = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_officers(&all_officers, &total_count);
+    // Filter the mapped officers in place; only matches are copied
+    OfficerView view;
+    ErrorCode result = view_all_officers(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Officer* all_officers = view.items;
+    int total_count = view.count;
     
     // Count matching officers
     int matching_count = 0;
@@ -311,7 +306,7 @@ ErrorCode search_officers_by_access_level(int access_level, Officer** officers,
     }
     
     if (matching_count == 0) {
-        safe_free((void**)&all_officers);
+        release_officer_view(&view);
         *officers = NULL;
         *count = 0;
         return SUCCESS;
@@ -320,7 +315,7 @@ ErrorCode search_officers_by_access_level(int access_level, Officer** officers,
     // Create array for matching officers
     Officer* matching_officers = (Officer*)safe_malloc(matching_count * sizeof(Officer));
     if (!matching_officers) {
-        safe_free((void**)&all_officers);
+        release_officer_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
@@ -333,14 +328,12 @@ ErrorCode search_officers_by_access_level(int access_level, Officer** officers,
         }
     }
     
-    safe_free((void**)&all_officers);
+    release_officer_view(&view);
     *officers = matching_officers;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched officers by access level: %d", access_level);
-    log_action("SYSTEM", "Officer", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Officer", "Search", "Searched officers by access level: %d", access_level);
     
     return SUCCESS;
 }
@@ -382,27 +375,28 @@ ErrorCode validate_officer_data(const Officer* officer) {
 
 // Function to get total officer count
 int get_total_officer_count() {
-    Officer* officers = NULL;
-    int count = 0;
-    ErrorCode result = list_all_officers(&officers, &count);
-    
-    if (result == SUCCESS && officers) {
-        safe_free((void**)&officers);
+    OfficerView view;
+    if (view_all_officers(&view) != SUCCESS) {
+        return 0;
     }
     
+    int count = view.count;
+    release_officer_view(&view);
     return count;
 }
 
 // Function to get active officer count
 int get_active_officer_count() {
-    Officer* officers = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_officers(&officers, &total_count);
+    OfficerView view;
+    ErrorCode result = view_all_officers(&view);
     
     if (result != SUCCESS) {
         return 0;
     }
     
+    const Officer* officers = view.items;
+    int total_count = view.count;
+    
     int active_count = 0;
     for (int i = 0; i < total_count; i++) {
         if (strcmp(officers[i].status, "Active") == 0) {
@@ -410,9 +404,7 @@ int get_active_officer_count() {
         }
     }
     
-    if (officers) {
-        safe_free((void**)&officers);
-    }
+    release_officer_view(&view);
     
     return active_count;
 }
\ No newline at end of file
@@ -2,8 +2,10 @@
 #include "file_io.h"
 #include "logging.h"
 #include "utils.h"
+#include "field_match.h"
 #include "student.h"
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -47,7 +49,7 @@ ErrorCode create_payment(const Payment* payment) {
     char log_details[200];
     snprintf(log_details, sizeof(log_details), "Created payment: %s for student: %s, amount: %.2f", 
              payment->paymentID, payment->studentID, payment->amount);
-    log_action("SYSTEM", "Payment", "Create", log_details);
+    log_write_action("SYSTEM", "Payment", "Create", log_details);
     
     return SUCCESS;
 }
@@ -61,9 +63,7 @@ ErrorCode retrieve_payment(const char* payment_id, Payment* payment) {
     ErrorCode result = load_payment(payment_id, payment);
     if (result == SUCCESS) {
         // Log the action
-        char log_details[100];
-        snprintf(log_details, sizeof(log_details), "Retrieved payment: %s", payment_id);
-        log_action("SYSTEM", "Payment", "Retrieve", log_details);
+        LOG_INFOF("SYSTEM", "Payment", "Retrieve", "Retrieved payment: %s", payment_id);
     }
     
     return result;
@@ -88,7 +88,7 @@ ErrorCode update_payment_record(const Payment* payment) {
         char log_details[200];
         snprintf(log_details, sizeof(log_details), "Updated payment: %s for student: %s, amount: %.2f", 
                  payment->paymentID, payment->studentID, payment->amount);
-        log_action("SYSTEM", "Payment", "Update", log_details);
+        log_write_action("SYSTEM", "Payment", "Update", log_details);
     }
     
     return result;
@@ -114,7 +114,7 @@ ErrorCode delete_payment_record(const char* payment_id) {
         char log_details[200];
         snprintf(log_details, sizeof(log_details), "Deleted payment: %s for student: %s, amount: %.2f", 
                  payment.paymentID, payment.studentID, payment.amount);
-        log_action("SYSTEM", "Payment", "Delete", log_details);
+        log_write_action("SYSTEM", "Payment", "Delete", log_details);
     }
     
     return result;
@@ -187,9 +187,7 @@ ErrorCode list_all_payments_sorted(Payment** payments, int* count, const char* s
     }
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Listed all payments sorted by: %s", sort_by);
-    log_action("SYSTEM", "Payment", "List", log_details);
+    LOG_INFOF("SYSTEM", "Payment", "List", "Listed all payments sorted by: %s", sort_by);
     
     return SUCCESS;
 }
@@ -200,24 +198,23 @@ ErrorCode search_payments_by_student(const char* student_id, Payment** payments,
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all payments
-    Payment* all_payments = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_payments(&all_payments, &total_count);
+    // Filter the mapped payments in place; only matches are copied
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Payment* all_payments = view.items;
+    int total_count = view.count;
     
     // Count matching payments
-    int matching_count = 0;
-    for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_payments[i].studentID, student_id) == 0) {
-            matching_count++;
-        }
-    }
+    FieldPattern pattern;
+    field_pattern_init(&pattern, student_id, sizeof(all_payments[0].studentID), FIELD_MATCH_EQUAL);
+    int matching_count = field_match_block(&pattern, all_payments, sizeof(Payment), offsetof(Payment, studentID),
+                                           total_count, NULL);
     
     if (matching_count == 0) {
-        safe_free((void**)&all_payments);
+        release_payment_view(&view);
         *payments = NULL;
         *count = 0;
         return SUCCESS;
@@ -226,27 +223,25 @@ ErrorCode search_payments_by_student(const char* student_id, Payment** payments,
     // Create array for matching payments
     Payment* matching_payments = (Payment*)safe_malloc(matching_count * sizeof(Payment));
     if (!matching_payments) {
-        safe_free((void**)&all_payments);
+        release_payment_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
     // Copy matching payments
     int index = 0;
     for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_payments[i].studentID, student_id) == 0) {
+        if (field_match_record(&pattern, &all_payments[i], sizeof(Payment), offsetof(Payment, studentID))) {
             matching_payments[index] = all_payments[i];
             index++;
         }
     }
     
-    safe_free((void**)&all_payments);
+    release_payment_view(&view);
     *payments = matching_payments;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched payments by student: %s", student_id);
-    log_action("SYSTEM", "Payment", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Payment", "Search", "Searched payments by student: %s", student_id);
     
     return SUCCESS;
 }
@@ -262,24 +257,23 @@ ErrorCode search_payments_by_status(const char* status, Payment** payments, int*
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all payments
-    Payment* all_payments = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_payments(&all_payments, &total_count);
+    // Filter the mapped payments in place; only matches are copied
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Payment* all_payments = view.items;
+    int total_count = view.count;
     
     // Count matching payments
-    int matching_count = 0;
-    for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_payments[i].status, status) == 0) {
-            matching_count++;
-        }
-    }
+    FieldPattern pattern;
+    field_pattern_init(&pattern, status, sizeof(all_payments[0].status), FIELD_MATCH_EQUAL);
+    int matching_count = field_match_block(&pattern, all_payments, sizeof(Payment), offsetof(Payment, status),
+                                           total_count, NULL);
     
     if (matching_count == 0) {
-        safe_free((void**)&all_payments);
+        release_payment_view(&view);
         *payments = NULL;
         *count = 0;
         return SUCCESS;
@@ -288,27 +282,25 @@ ErrorCode search_payments_by_status(const char* status, Payment** payments, int*
     // Create array for matching payments
     Payment* matching_payments = (Payment*)safe_malloc(matching_count * sizeof(Payment));
     if (!matching_payments) {
-        safe_free((void**)&all_payments);
+        release_payment_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
     // Copy matching payments
     int index = 0;
     for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_payments[i].status, status) == 0) {
+        if (field_match_record(&pattern, &all_payments[i], sizeof(Payment), offsetof(Payment, status))) {
             matching_payments[index] = all_payments[i];
             index++;
         }
     }
     
-    safe_free((void**)&all_payments);
+    release_payment_view(&view);
     *payments = matching_payments;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched payments by status: %s", status);
-    log_action("SYSTEM", "Payment", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Payment", "Search", "Searched payments by status: %s", status);
     
     return SUCCESS;
 }
@@ -319,13 +311,14 @@ ErrorCode search_payments_by_date_range(time_t start_date, time_t end_date, Paym
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all payments
-    Payment* all_payments = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_payments(&all_payments, &total_count);
+    // Filter the mapped payments in place; only matches are copied
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Payment* all_payments = view.items;
+    int total_count = view.count;
     
     // Count matching payments
     int matching_count = 0;
@@ -336,7 +329,7 @@ ErrorCode search_payments_by_date_range(time_t start_date, time_t end_date, Paym
     }
     
     if (matching_count == 0) {
-        safe_free((void**)&all_payments);
+        release_payment_view(&view);
         *payments = NULL;
         *count = 0;
         return SUCCESS;
@@ -345,7 +338,7 @@ ErrorCode search_payments_by_date_range(time_t start_date, time_t end_date, Paym
     // Create array for matching payments
     Payment* matching_payments = (Payment*)safe_malloc(matching_count * sizeof(Payment));
     if (!matching_payments) {
-        safe_free((void**)&all_payments);
+        release_payment_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
@@ -358,17 +351,17 @@ ErrorCode search_payments_by_date_range(time_t start_date, time_t end_date, Paym
         }
     }
     
-    safe_free((void**)&all_payments);
+    release_payment_view(&view);
     *payments = matching_payments;
     *count = matching_count;
     
-    // Log the action
-    char start_str[20], end_str[20];
-    format_timestamp(start_date, start_str, sizeof(start_str));
-    format_timestamp(end_date, end_str, sizeof(end_str));
-    char log_details[200];
-    snprintf(log_details, sizeof(log_details), "Searched payments from %s to %s", start_str, end_str);
-    log_action("SYSTEM", "Payment", "Search", log_details);
+    // Log the action; the dates are only formatted when search events are logged
+    if (LOG_LEVEL_ACTIVE(LOG_LEVEL_DEBUG)) {
+        char start_str[20], end_str[20];
+        format_timestamp(start_date, start_str, sizeof(start_str));
+        format_timestamp(end_date, end_str, sizeof(end_str));
+        LOG_INFOF("SYSTEM", "Payment", "Search", "Searched payments from %s to %s", start_str, end_str);
+    }
     
     return SUCCESS;
 }
@@ -402,9 +395,8 @@ ErrorCode get_total_payments_by_student(const char* student_id, float* total_amo
     }
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Calculated total payments for student: %s, amount: %.2f", student_id, total);
-    log_action("SYSTEM", "Payment", "Calculate Total", log_details);
+    LOG_INFOF("SYSTEM", "Payment", "Calculate Total",
+              "Calculated total payments for student: %s, amount: %.2f", student_id, total);
     
     return SUCCESS;
 }
@@ -465,14 +457,16 @@ bool is_valid_payment_status(const char* status) {
 
 // Function to calculate total payments
 float calculate_total_payments() {
-    Payment* payments = NULL;
-    int count = 0;
-    ErrorCode result = list_all_payments(&payments, &count);
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
     
     if (result != SUCCESS) {
         return 0.0f;
     }
     
+    const Payment* payments = view.items;
+    int count = view.count;
+    
     float total = 0.0f;
     for (int i = 0; i < count; i++) {
         if (strcmp(payments[i].status, "Completed") == 0) {
@@ -480,9 +474,7 @@ float calculate_total_payments() {
         }
     }
     
-    if (payments) {
-        safe_free((void**)&payments);
-    }
+    release_payment_view(&view);
     
     return total;
 }
@@ -498,14 +490,16 @@ int get_payment_count_by_status(const char* status) {
         return 0;
     }
     
-    Payment* payments = NULL;
-    int count = 0;
-    ErrorCode result = list_all_payments(&payments, &count);
+    PaymentView view;
+    ErrorCode result = view_all_payments(&view);
     
     if (result != SUCCESS) {
         return 0;
     }
     
+    const Payment* payments = view.items;
+    int count = view.count;
+    
     int status_count = 0;
     for (int i = 0; i < count; i++) {
         if (strcmp(payments[i].status, status) == 0) {
@@ -513,9 +507,7 @@ int get_payment_count_by_status(const char* status) {
         }
     }
     
-    if (payments) {
-        safe_free((void**)&payments);
-    }
+    release_payment_view(&view);
     
     return status_count;
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 #include "file_io.h"
 #include "logging.h"
 #include "utils.h"
+#include "field_match.h"
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -39,7 +41,7 @@ ErrorCode create_student(const Student* student) {
     char log_details[200];
     snprintf(log_details, sizeof(log_details), "Created student: %s (%s %s)", 
              student->studentID, student->firstName, student->lastName);
-    log_action("SYSTEM", "Student", "Create", log_details);
+    log_write_action("SYSTEM", "Student", "Create", log_details);
     
     return SUCCESS;
 }
@@ -53,9 +55,7 @@ ErrorCode retrieve_student(const char* student_id, Student* student) {
     ErrorCode result = load_student(student_id, student);
     if (result == SUCCESS) {
         // Log the action
-        char log_details[100];
-        snprintf(log_details, sizeof(log_details), "Retrieved student: %s", student_id);
-        log_action("SYSTEM", "Student", "Retrieve", log_details);
+        LOG_INFOF("SYSTEM", "Student", "Retrieve", "Retrieved student: %s", student_id);
     }
     
     return result;
@@ -80,7 +80,7 @@ ErrorCode update_student_record(const Student* student) {
         char log_details[200];
         snprintf(log_details, sizeof(log_details), "Updated student: %s (%s %s)", 
                  student->studentID, student->firstName, student->lastName);
-        log_action("SYSTEM", "Student", "Update", log_details);
+        log_write_action("SYSTEM", "Student", "Update", log_details);
     }
     
     return result;
@@ -106,7 +106,7 @@ ErrorCode delete_student_record(const char* student_id) {
         char log_details[200];
         snprintf(log_details, sizeof(log_details), "Deleted student: %s (%s %s)", 
                  student.studentID, student.firstName, student.lastName);
-        log_action("SYSTEM", "Student", "Delete", log_details);
+        log_write_action("SYSTEM", "Student", "Delete", log_details);
     }
     
     return result;
@@ -167,9 +167,7 @@ ErrorCode list_all_students_sorted(Student** students, int* count, const char* s
     }
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Listed all students sorted by: %s", sort_by);
-    log_action("SYSTEM", "Student", "List", log_details);
+    LOG_INFOF("SYSTEM", "Student", "List", "Listed all students sorted by: %s", sort_by);
     
     return SUCCESS;
 }
@@ -180,13 +178,14 @@ ErrorCode search_students_by_name(const char* name, Student** students, int* cou
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all students
-    Student* all_students = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_students(&all_students, &total_count);
+    // Filter the mapped students in place; only matches are copied
+    StudentView view;
+    ErrorCode result = view_all_students(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Student* all_students = view.items;
+    int total_count = view.count;
     
     // Count matching students
     int matching_count = 0;
@@ -197,7 +196,7 @@ ErrorCode search_students_by_name(const char* name, Student** students, int* cou
     }
     
     if (matching_count == 0) {
-        safe_free((void**)&all_students);
+        release_student_view(&view);
         *students = NULL;
         *count = 0;
         return SUCCESS;
@@ -206,7 +205,7 @@ ErrorCode search_students_by_name(const char* name, Student** students, int* cou
     // Create array for matching students
     Student* matching_students = (Student*)safe_malloc(matching_count * sizeof(Student));
     if (!matching_students) {
-        safe_free((void**)&all_students);
+        release_student_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
@@ -219,14 +218,12 @@ ErrorCode search_students_by_name(const char* name, Student** students, int* cou
         }
     }
     
-    safe_free((void**)&all_students);
+    release_student_view(&view);
     *students = matching_students;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched students by name: %s", name);
-    log_action("SYSTEM", "Student", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Student", "Search", "Searched students by name: %s", name);
     
     return SUCCESS;
 }
@@ -237,24 +234,23 @@ ErrorCode search_students_by_status(const char* status, Student** students, int*
         return ERROR_INVALID_INPUT;
     }
     
-    // Get all students
-    Student* all_students = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_students(&all_students, &total_count);
+    // Filter the mapped students in place; only matches are copied
+    StudentView view;
+    ErrorCode result = view_all_students(&view);
     if (result != SUCCESS) {
         return result;
     }
+    const Student* all_students = view.items;
+    int total_count = view.count;
     
     // Count matching students
-    int matching_count = 0;
-    for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_students[i].status, status) == 0) {
-            matching_count++;
-        }
-    }
+    FieldPattern pattern;
+    field_pattern_init(&pattern, status, sizeof(all_students[0].status), FIELD_MATCH_EQUAL);
+    int matching_count = field_match_block(&pattern, all_students, sizeof(Student), offsetof(Student, status),
+                                           total_count, NULL);
     
     if (matching_count == 0) {
-        safe_free((void**)&all_students);
+        release_student_view(&view);
         *students = NULL;
         *count = 0;
         return SUCCESS;
@@ -263,27 +259,25 @@ ErrorCode search_students_by_status(const char* status, Student** students, int*
     // Create array for matching students
     Student* matching_students = (Student*)safe_malloc(matching_count * sizeof(Student));
     if (!matching_students) {
-        safe_free((void**)&all_students);
+        release_student_view(&view);
         return ERROR_MEMORY_ALLOCATION;
     }
     
     // Copy matching students
     int index = 0;
     for (int i = 0; i < total_count; i++) {
-        if (strcmp(all_students[i].status, status) == 0) {
+        if (field_match_record(&pattern, &all_students[i], sizeof(Student), offsetof(Student, status))) {
             matching_students[index] = all_students[i];
             index++;
         }
     }
     
-    safe_free((void**)&all_students);
+    release_student_view(&view);
     *students = matching_students;
     *count = matching_count;
     
     // Log the action
-    char log_details[100];
-    snprintf(log_details, sizeof(log_details), "Searched students by status: %s", status);
-    log_action("SYSTEM", "Student", "Search", log_details);
+    LOG_INFOF("SYSTEM", "Student", "Search", "Searched students by status: %s", status);
     
     return SUCCESS;
 }
@@ -330,27 +324,28 @@ ErrorCode validate_student_data(const Student* student) {
 
 // Function to get total student count
 int get_total_student_count() {
-    Student* students = NULL;
-    int count = 0;
-    ErrorCode result = list_all_students(&students, &count);
-    
-    if (result == SUCCESS && students) {
-        safe_free((void**)&students);
+    StudentView view;
+    if (view_all_students(&view) != SUCCESS) {
+        return 0;
     }
     
+    int count = view.count;
+    release_student_view(&view);
     return count;
 }
 
 // Function to get active student count
 int get_active_student_count() {
-    Student* students = NULL;
-    int total_count = 0;
-    ErrorCode result = list_all_students(&students, &total_count);
+    StudentView view;
+    ErrorCode result = view_all_students(&view);
     
     if (result != SUCCESS) {
         return 0;
     }
     
+    const Student* students = view.items;
+    int total_count = view.count;
+    
     int active_count = 0;
     for (int i = 0; i < total_count; i++) {
         if (strcmp(students[i].status, "Active") == 0) {
@@ -358,9 +353,7 @@ int get_active_student_count() {
         }
     }
     
-    if (students) {
-        safe_free((void**)&students);
-    }
+    release_student_view(&view);
     
     return active_count;
 }
\ No newline at end of file
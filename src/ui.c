@@ -210,11 +210,11 @@ void display_student_list(const Student* students, int count) {
         return;
     }
     
-    printf("  %-15s %-30s %-20s %-12s %-10s\n", "ID", "Name", "Email", "Phone", "Status");
+    printf("  %-17s %-30s %-20s %-12s %-10s\n", "ID", "Name", "Email", "Phone", "Status");
     print_separator();
     
     for (int i = 0; i < count; i++) {
-        printf("  %-15s %-30s %-20s %-12s %-10s\n", 
+        printf("  %-17s %-30s %-20s %-12s %-10s\n", 
                students[i].studentID, 
                students[i].fullName, 
                students[i].email, 
@@ -229,11 +229,11 @@ void display_officer_list(const Officer* officers, int count) {
         return;
     }
     
-    printf("  %-15s %-25s %-20s %-12s %-10s\n", "ID", "Name", "Position", "Access Level", "Status");
+    printf("  %-17s %-25s %-20s %-12s %-10s\n", "ID", "Name", "Position", "Access Level", "Status");
     print_separator();
     
     for (int i = 0; i < count; i++) {
-        printf("  %-15s %-25s %-20s %-12s %-10s\n", 
+        printf("  %-17s %-25s %-20s %-12s %-10s\n", 
                officers[i].officerID, 
                officers[i].name, 
                officers[i].position, 
@@ -248,7 +248,7 @@ void display_payment_list(const Payment* payments, int count) {
         return;
     }
     
-    printf("  %-15s %-15s %-10s %-30s %-12s %-10s\n", "ID", "Student ID", "Amount", "Purpose", "Date", "Status");
+    printf("  %-17s %-17s %-10s %-30s %-12s %-10s\n", "ID", "Student ID", "Amount", "Purpose", "Date", "Status");
     print_separator();
     
     for (int i = 0; i < count; i++) {
@@ -258,7 +258,7 @@ void display_payment_list(const Payment* payments, int count) {
         char date_str[12];
         format_date(payments[i].paymentDate, date_str, sizeof(date_str));
         
-        printf("  %-15s %-15s %-10s %-30s %-12s %-10s\n", 
+        printf("  %-17s %-17s %-10s %-30s %-12s %-10s\n", 
                payments[i].paymentID, 
                payments[i].studentID, 
                amount_str, 
@@ -269,25 +269,85 @@ void display_payment_list(const Payment* payments, int count) {
 }
 
 void display_log_list(const LogEntry* logs, int count) {
-    if (!logs || count <= 0) {
+    int shown = 0;
+    
+    for (int i = 0; logs && i < count; i++) {
+        display_log_row(&logs[i], &shown);
+    }
+    
+    display_log_rows_end(shown);
+}
+
+// Streaming log display: prints one row per record, with the column header
+// before the first; context points to the number of rows shown so far
+int display_log_row(const LogEntry* log, void* context) {
+    int* shown = (int*)context;
+    
+    if (*shown == 0) {
+        printf("  %-17s %-17s %-15s %-15s %-20s\n", "ID", "User ID", "Action", "Module", "Time");
+        print_separator();
+    }
+    
+    char time_str[20];
+    format_date(log->timestamp, time_str, sizeof(time_str));
+    
+    printf("  %-17s %-17s %-15s %-15s %-20s\n", 
+           log->logID, 
+           log->userID, 
+           log->action, 
+           log->module, 
+           time_str);
+    
+    (*shown)++;
+    return 0;
+}
+
+void display_log_rows_end(int shown) {
+    if (shown <= 0) {
+        printf("  No logs found.\n");
+    } else {
+        printf("  (%d total)\n", shown);
+    }
+}
+
+#define AGGREGATE_BAR_WIDTH 40
+
+void display_log_aggregate(const LogAggregateResult* result, LogGroupBy group_by, const char* label) {
+    if (!result || result->count == 0) {
         printf("  No logs found.\n");
         return;
     }
     
-    printf("  %-15s %-15s %-15s %-15s %-20s\n", "ID", "User ID", "Action", "Module", "Time");
+    long long largest = 0;
+    for (int i = 0; i < result->count; i++) {
+        if (result->rows[i].count > largest) {
+            largest = result->rows[i].count;
+        }
+    }
+    
+    printf("  %-20s %8s\n", label, "Count");
     print_separator();
     
-    for (int i = 0; i < count; i++) {
-        char time_str[20];
-        format_date(logs[i].timestamp, time_str, sizeof(time_str));
+    for (int i = 0; i < result->count; i++) {
+        const LogAggregateRow* row = &result->rows[i];
         
-        printf("  %-15s %-15s %-15s %-15s %-20s\n", 
-               logs[i].logID, 
-               logs[i].userID, 
-               logs[i].action, 
-               logs[i].module, 
-               time_str);
+        char group[LOG_AGGREGATE_KEY_LEN];
+        if (group_by == LOG_GROUP_HOUR || group_by == LOG_GROUP_DAY) {
+            format_date(row->bucket, group, sizeof(group));
+            group[group_by == LOG_GROUP_HOUR ? 16 : 10] = '\0';  // YYYY-MM-DD HH:MM or YYYY-MM-DD
+        } else {
+            safe_strcpy(group, row->key, sizeof(group));
+        }
+        
+        char bar[AGGREGATE_BAR_WIDTH + 1];
+        int length = (int)((row->count * AGGREGATE_BAR_WIDTH + largest - 1) / largest);
+        memset(bar, '#', length);
+        bar[length] = '\0';
+        
+        printf("  %-20s %8lld %s\n", group, row->count, bar);
     }
+    
+    printf("  (%lld total)\n", result->total);
 }
 
 // Formatting functions
@@ -300,6 +360,5 @@ void format_currency(float amount, char* buffer, size_t buffer_size) {
 void format_date(time_t timestamp, char* buffer, size_t buffer_size) {
     if (!buffer || buffer_size == 0) return;
     
-    struct tm* timeinfo = localtime(&timestamp);
-    strftime(buffer, buffer_size, "%Y-%m-%d %H:%M:%S", timeinfo);
+    format_timestamp(timestamp, buffer, buffer_size);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define UI_H
 
 #include "data_structures.h"
+#include "log_aggregate.h"
 #include <stdio.h>
 
 // UI utility functions
@@ -33,6 +34,13 @@ void display_officer_list(const Officer* officers, int count);
 void display_payment_list(const Payment* payments, int count);
 void display_log_list(const LogEntry* logs, int count);
 
+// Streaming log display, usable as a log query callback
+int display_log_row(const LogEntry* log, void* context);
+void display_log_rows_end(int shown);
+
+// Aggregation display: one row per group with its count and a bar
+void display_log_aggregate(const LogAggregateResult* result, LogGroupBy group_by, const char* label);
+
 // Formatting functions
 void format_currency(float amount, char* buffer, size_t buffer_size);
 void format_date(time_t timestamp, char* buffer, size_t buffer_size);
@@ -1,7 +1,20 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "utils.h"
+#include "file_io.h"
 #include <time.h>
 #include <ctype.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
 
 // Error handling functions
 const char* get_error_message(ErrorCode code) {
@@ -28,16 +41,20 @@ const char* get_error_message(ErrorCode code) {
 }
 
 void log_error(ErrorCode code, const char* function, const char* message) {
-    time_t now;
     char time_str[30];
-    
-    time(&now);
-    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    format_timestamp(time(NULL), time_str, sizeof(time_str));
     
     fprintf(stderr, "[%s] ERROR in %s: %s (%d: %s)\n", 
             time_str, function, message, code, get_error_message(code));
 }
 
+void log_warning(const char* function, const char* message) {
+    char time_str[30];
+    format_timestamp(time(NULL), time_str, sizeof(time_str));
+
+    fprintf(stderr, "[%s] WARNING in %s: %s\n", time_str, function, message);
+}
+
 // Input validation functions
 bool is_valid_email(const char* email) {
     if (!email || strlen(email) == 0) return false;
@@ -191,11 +208,59 @@ int safe_strcat(char* dest, const char* src, size_t dest_size) {
 }
 
 // Time utility functions
+// Per-thread cache of the last formatted timestamp. Later timestamps in the
+// same minute only rewrite the two seconds digits; anything else goes through
+// localtime_r, which avoids the shared buffer of localtime.
+#define TIMESTAMP_TEXT_LEN 32
+#define TIMESTAMP_SECONDS_POS 17
+
+typedef struct {
+    time_t second;        // Timestamp the text holds; -1 when empty
+    time_t minute_start;
+    int patchable;        // Text has the fixed "YYYY-MM-DD HH:MM:SS" layout
+    char text[TIMESTAMP_TEXT_LEN];
+} TimestampCache;
+
+static _Thread_local TimestampCache timestamp_cache = { (time_t)-1, 0, 0, "" };
+
+// Helper function to get the cached text for a timestamp, or NULL if it cannot be converted
+static const char* cached_timestamp_text(time_t timestamp) {
+    TimestampCache* cache = &timestamp_cache;
+    if (cache->second == timestamp) {
+        return cache->text;
+    }
+
+    if (cache->patchable && timestamp >= cache->minute_start && timestamp < cache->minute_start + 60) {
+        int seconds = (int)(timestamp - cache->minute_start);
+        cache->text[TIMESTAMP_SECONDS_POS] = (char)('0' + seconds / 10);
+        cache->text[TIMESTAMP_SECONDS_POS + 1] = (char)('0' + seconds % 10);
+        cache->second = timestamp;
+        return cache->text;
+    }
+
+    struct tm timeinfo;
+#ifdef _WIN32
+    if (localtime_s(&timeinfo, &timestamp) != 0) {
+#else
+    if (!localtime_r(&timestamp, &timeinfo)) {
+#endif
+        cache->second = (time_t)-1;
+        cache->patchable = 0;
+        return NULL;
+    }
+
+    size_t length = strftime(cache->text, sizeof(cache->text), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    cache->second = timestamp;
+    cache->minute_start = timestamp - timeinfo.tm_sec;
+    cache->patchable = length == TIMESTAMP_SECONDS_POS + 2 && timeinfo.tm_sec < 60;
+    return cache->text;
+}
+
 char* format_timestamp(time_t timestamp, char* buffer, size_t buf_size) {
     if (!buffer || buf_size == 0) return NULL;
     
-    struct tm* timeinfo = localtime(&timestamp);
-    strftime(buffer, buf_size, "%Y-%m-%d %H:%M:%S", timeinfo);
+    const char* text = cached_timestamp_text(timestamp);
+    safe_strcpy(buffer, text ? text : "", buf_size);
     return buffer;
 }
 
@@ -226,21 +291,161 @@ void safe_free(void** ptr) {
     }
 }
 
+// Unique IDs are Snowflake-style 63-bit values, from the top bit down:
+//
+//   41 bits  milliseconds since ID_EPOCH_MS (about 69 years)
+//   10 bits  node of the process
+//   12 bits  sequence within the millisecond
+//
+// written after the prefix as 13 Crockford base32 digits, so IDs of one
+// prefix sort in creation order. The millisecond and sequence live in one
+// atomic word advanced by compare-and-swap: every ID of the process is
+// larger than the one before, across threads and even if the clock steps
+// back. A millisecond that runs out of sequence numbers borrows the next
+// one, so the rate is not capped.
+//
+// The node starts from a hash of the host name and process ID. Processes
+// sharing the data directory each hold a lock on their node's byte of
+// ID_NODE_REGISTRY, so a process whose hash is taken moves on to the next
+// free node instead of colliding. The lock goes away with the process.
+#define ID_EPOCH_MS 1704067200000LL  // 2024-01-01 00:00:00 UTC
+#define ID_NODE_BITS 10
+#define ID_SEQUENCE_BITS 12
+#define ID_DIGITS 13
+#define ID_NODE_REGISTRY "data/id_nodes"
+
+static const char id_alphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+static atomic_ullong id_state = 0;    // (milliseconds << ID_SEQUENCE_BITS) | sequence of the last ID
+static atomic_int id_node = -1;
+static int id_node_fd = -1;           // Registry descriptor holding the node's lock
+static int id_fork_hooked = 0;
+static pthread_mutex_t id_node_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Fork hooks: a child inherits neither the parent's registry lock nor the
+// right to its node, so it claims a node of its own
+static void id_node_prepare_fork() {
+    pthread_mutex_lock(&id_node_lock);
+}
+
+static void id_node_parent_fork() {
+    pthread_mutex_unlock(&id_node_lock);
+}
+
+static void id_node_child_fork() {
+#ifndef _WIN32
+    if (id_node_fd >= 0) {
+        close(id_node_fd);
+        id_node_fd = -1;
+    }
+#endif
+    atomic_store(&id_node, -1);
+    pthread_mutex_unlock(&id_node_lock);
+}
+
+// Helper function to lock the first free node of the registry from preferred
+// on; returns preferred unchecked when the registry is unavailable
+static int claim_id_node(int preferred) {
+#ifndef _WIN32
+    ensure_directory_exists("data");
+    int fd = open(ID_NODE_REGISTRY, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return preferred;
+    }
+
+    for (int i = 0; i < (1 << ID_NODE_BITS); i++) {
+        int node = (preferred + i) & ((1 << ID_NODE_BITS) - 1);
+        struct flock lock;
+        memset(&lock, 0, sizeof(lock));
+        lock.l_type = F_WRLCK;
+        lock.l_whence = SEEK_SET;
+        lock.l_start = node;
+        lock.l_len = 1;
+        if (fcntl(fd, F_SETLK, &lock) == 0) {
+            id_node_fd = fd;
+            return node;
+        }
+    }
+
+    close(fd);
+    log_warning("claim_id_node", "Every ID node is in use; IDs of this process may collide");
+#endif
+    return preferred;
+}
+
+// Helper function to get the node bits, claiming a node on first use
+static int id_node_bits() {
+    int node = atomic_load(&id_node);
+    if (node >= 0) {
+        return node;
+    }
+
+    pthread_mutex_lock(&id_node_lock);
+    node = atomic_load(&id_node);
+    if (node >= 0) {
+        pthread_mutex_unlock(&id_node_lock);
+        return node;
+    }
+    if (!id_fork_hooked) {
+        pthread_atfork(id_node_prepare_fork, id_node_parent_fork, id_node_child_fork);
+        id_fork_hooked = 1;
+    }
+
+    // FNV-1a of the host name and process ID
+    unsigned long hash = 2166136261UL;
+#ifndef _WIN32
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+    for (const char* c = host; *c; c++) {
+        hash = ((hash ^ (unsigned char)*c) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+#endif
+    unsigned long pid = (unsigned long)getpid();
+    for (int i = 0; i < 4; i++) {
+        hash = ((hash ^ ((pid >> (8 * i)) & 0xFF)) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    node = (int)((hash ^ (hash >> ID_NODE_BITS) ^ (hash >> (2 * ID_NODE_BITS))) & ((1 << ID_NODE_BITS) - 1));
+    node = claim_id_node(node);
+    atomic_store(&id_node, node);
+
+    pthread_mutex_unlock(&id_node_lock);
+    return node;
+}
+
 // Generate unique ID
 int generate_unique_id(char* id_buffer, size_t buffer_size, const char* prefix) {
     if (!id_buffer || buffer_size == 0 || !prefix) {
         return -1;
     }
     
-    time_t now;
-    time(&now);
-    
-    int prefix_len = strlen(prefix);
-    if (prefix_len + 20 >= buffer_size) {  // 20 chars for timestamp + counter
+    size_t prefix_len = strlen(prefix);
+    if (prefix_len + ID_DIGITS >= buffer_size) {
         return -1;
     }
     
-    snprintf(id_buffer, buffer_size, "%s%ld", prefix, (long)now);
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    long long milliseconds = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000 - ID_EPOCH_MS;
+    unsigned long long floor = milliseconds > 0 ? (unsigned long long)milliseconds << ID_SEQUENCE_BITS : 0;
+    
+    unsigned long long last = atomic_load_explicit(&id_state, memory_order_relaxed);
+    unsigned long long next;
+    do {
+        next = last + 1 > floor ? last + 1 : floor;
+    } while (!atomic_compare_exchange_weak_explicit(&id_state, &last, next, memory_order_relaxed,
+                                                    memory_order_relaxed));
+    
+    unsigned long long sequence = next & ((1ULL << ID_SEQUENCE_BITS) - 1);
+    unsigned long long value = ((next >> ID_SEQUENCE_BITS) << (ID_NODE_BITS + ID_SEQUENCE_BITS)) |
+                               ((unsigned long long)id_node_bits() << ID_SEQUENCE_BITS) | sequence;
+    value &= (1ULL << 63) - 1;
+    
+    memcpy(id_buffer, prefix, prefix_len);
+    for (int i = ID_DIGITS - 1; i >= 0; i--) {
+        id_buffer[prefix_len + i] = id_alphabet[value & 31];
+        value >>= 5;
+    }
+    id_buffer[prefix_len + ID_DIGITS] = '\0';
     
     return 0;
 }
@@ -386,12 +591,7 @@ bool validate_payment_input(const Payment *payment) {
 
 // Date/time utility functions needed by main.c
 void getCurrentDateTimeString(char* buffer, size_t buffer_size) {
-    time_t now;
-    struct tm* timeinfo;
-    
-    time(&now);
-    timeinfo = localtime(&now);
-    strftime(buffer, buffer_size, "%Y-%m-%d %H:%M:%S", timeinfo);
+    format_timestamp(time(NULL), buffer, buffer_size);
 }
 
 void getCurrentDateString(char* buffer, size_t buffer_size) {
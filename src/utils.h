@@ -10,6 +10,7 @@
 // Error handling functions
 const char* get_error_message(ErrorCode code);
 void log_error(ErrorCode code, const char* function, const char* message);
+void log_warning(const char* function, const char* message);
 
 // Input validation functions
 bool is_valid_email(const char* email);
@@ -32,7 +33,9 @@ time_t parse_date_string(const char* date_str);  // Format: YYYY-MM-DD
 void* safe_malloc(size_t size);
 void safe_free(void** ptr);
 
-// Generate unique ID
+// Generate unique ID: prefix plus 13 characters, increasing within the process
+// and distinct from the IDs of other processes sharing the data directory;
+// returns -1 when the buffer cannot hold it
 int generate_unique_id(char* id_buffer, size_t buffer_size, const char* prefix);
 
 // Password utility functions
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "log_tests.h"
+
+// Function to start the next test from an empty store
+void log_test_reset_store(void) {
+    if (system("rm -rf data logs") != 0) {
+        printf("(could not clear the store) ");
+    }
+}
+
+// Main runner for the audit log tests; run it from a scratch directory
+int main() {
+    printf("=== Running Audit Log Tests ===\n\n");
+
+    int passed = 0;
+    int failed = 0;
+    int total = 0;
+
+    TEST_RUN(test_write_action_survives_sampling);
+    TEST_RUN(test_explicit_policy_survives_collect);
+    TEST_RUN(test_recovery_drops_torn_final_frame);
+    TEST_RUN(test_recovery_stops_at_corrupt_crc);
+    TEST_RUN(test_recovery_starts_from_checkpoint);
+    TEST_RUN(test_page_resumes_across_segments);
+    TEST_RUN(test_newest_first_page_pins_listing);
+    TEST_RUN(test_page_resumes_across_postings_tail_split);
+    TEST_RUN(test_page_rejects_tampered_token);
+    TEST_RUN(test_columnar_round_trips_all_columns);
+    TEST_RUN(test_columnar_reads_column_subsets);
+    TEST_RUN(test_ids_unique_and_increasing_across_threads);
+    TEST_RUN(test_ids_skip_nodes_held_by_other_processes);
+    TEST_RUN(test_field_match_kernels_agree);
+    TEST_RUN(test_retention_rolls_up_drops_then_unlinks);
+    TEST_RUN(test_retention_keeps_pending_segment_still_listed);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total: %d, Passed: %d, Failed: %d\n", total, passed, failed);
+
+    if (failed == 0) {
+        printf("All tests passed!\n");
+        return 0;
+    } else {
+        printf("Some tests failed!\n");
+        return 1;
+    }
+}
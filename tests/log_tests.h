@@ -0,0 +1,65 @@
+#ifndef LOG_TESTS_H
+#define LOG_TESTS_H
+
+#include <stdio.h>
+
+// Tests for the audit log subsystem. Each test runs in the scratch directory
+// the runner switches to and starts from an empty store.
+
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s at %s:%d - %s\n", __func__, __FILE__, __LINE__, message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_RUN(test_func) \
+    do { \
+        printf("Running %s... ", #test_func); \
+        fflush(stdout); \
+        log_test_reset_store(); \
+        if (test_func()) { \
+            printf("PASS\n"); \
+            passed++; \
+        } else { \
+            printf("FAIL\n"); \
+            failed++; \
+        } \
+        total++; \
+    } while(0)
+
+// Removes data/ and logs/ so the next test starts from an empty store
+void log_test_reset_store(void);
+
+// Sampling
+int test_write_action_survives_sampling(void);
+int test_explicit_policy_survives_collect(void);
+
+// Crash recovery of the active segment
+int test_recovery_drops_torn_final_frame(void);
+int test_recovery_stops_at_corrupt_crc(void);
+int test_recovery_starts_from_checkpoint(void);
+
+// Paged queries
+int test_page_resumes_across_segments(void);
+int test_newest_first_page_pins_listing(void);
+int test_page_resumes_across_postings_tail_split(void);
+int test_page_rejects_tampered_token(void);
+
+// Columnar archive
+int test_columnar_round_trips_all_columns(void);
+int test_columnar_reads_column_subsets(void);
+
+// Unique IDs
+int test_ids_unique_and_increasing_across_threads(void);
+int test_ids_skip_nodes_held_by_other_processes(void);
+
+// Field match kernels
+int test_field_match_kernels_agree(void);
+
+// Retention
+int test_retention_rolls_up_drops_then_unlinks(void);
+int test_retention_keeps_pending_segment_still_listed(void);
+
+#endif // LOG_TESTS_H
@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log_tests.h"
+#include "../src/log_store.h"
+#include "../src/log_columnar.h"
+
+// Spans three columnar blocks, the last one partial
+#define COLUMNAR_RECORDS 2500
+
+// Helper function to build record i of the archived segment. Fields mix
+// dictionary seeds with new values, timestamps step backwards now and then,
+// and one details string fills its field.
+static void make_record(int i, time_t base, LogEntry* entry) {
+    static const char* const modules[] = { "Payment", "Columnar", "Auth", "Archive" };
+
+    memset(entry, 0, sizeof(LogEntry));
+    snprintf(entry->logID, sizeof(entry->logID), "COL%05d", i);
+    snprintf(entry->userID, sizeof(entry->userID), "USER%d", i % 13);
+    snprintf(entry->module, sizeof(entry->module), "%s", modules[i % 4]);
+    snprintf(entry->action, sizeof(entry->action), "%s", i % 2 ? "Create" : "Compact");
+    entry->timestamp = base + i - (i % 3 == 0 ? 5 : 0);
+
+    if (i == 1500) {
+        memset(entry->details, 'x', sizeof(entry->details) - 1);
+    } else {
+        snprintf(entry->details, sizeof(entry->details), "record %d %.*s", i, i % 40,
+                 "abcdefghijklmnopqrstuvwxyzabcdefghijklmn");
+    }
+}
+
+// Helper function to fill a sealed segment, archive it and return its
+// manifest entry; the store is left open
+static int archive_records(time_t* base, LogSegmentInfo* archived) {
+    LogStoreConfig config = { COLUMNAR_RECORDS * (long long)sizeof(LogFrame) };
+    if (log_store_configure(&config) != SUCCESS) {
+        return 0;
+    }
+
+    // Midday keeps every record in one daily partition
+    time_t now = time(NULL);
+    struct tm local = *localtime(&now);
+    local.tm_hour = 12;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    *base = mktime(&local);
+
+    // One record past the cap seals the first segment
+    for (int i = 0; i <= COLUMNAR_RECORDS; i++) {
+        LogEntry entry;
+        make_record(i, *base, &entry);
+        if (log_store_append(&entry) != SUCCESS) {
+            return 0;
+        }
+    }
+    if (log_store_flush() != SUCCESS || log_store_compact() != SUCCESS) {
+        return 0;
+    }
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    if (log_store_list_segments(0, 0, &segments, &segment_count) != SUCCESS || segment_count != 2) {
+        free(segments);
+        return 0;
+    }
+    *archived = segments[0];
+    free(segments);
+    return archived->format == LOG_SEGMENT_COLUMNAR && archived->record_count == COLUMNAR_RECORDS;
+}
+
+// Helper function to restore the default segment size after a test
+static void close_store(void) {
+    LogStoreConfig standard = { LOG_STORE_DEFAULT_SEGMENT_BYTES };
+    log_store_close();
+    log_store_configure(&standard);
+}
+
+// Helper function to check the fields of the columns read against the
+// expected record; the fields of other columns must be left empty
+static int fields_match(const LogEntry* read, const LogEntry* expected, unsigned int columns) {
+    LogEntry empty;
+    memset(&empty, 0, sizeof(empty));
+
+    const LogEntry* timestamp = columns & LOG_COLUMN_BIT(LOG_COLUMN_TIMESTAMP) ? expected : &empty;
+    const LogEntry* module = columns & LOG_COLUMN_BIT(LOG_COLUMN_MODULE) ? expected : &empty;
+    const LogEntry* action = columns & LOG_COLUMN_BIT(LOG_COLUMN_ACTION) ? expected : &empty;
+    const LogEntry* user = columns & LOG_COLUMN_BIT(LOG_COLUMN_USER) ? expected : &empty;
+    const LogEntry* log_id = columns & LOG_COLUMN_BIT(LOG_COLUMN_LOG_ID) ? expected : &empty;
+    const LogEntry* details = columns & LOG_COLUMN_BIT(LOG_COLUMN_DETAILS) ? expected : &empty;
+
+    return read->timestamp == timestamp->timestamp &&
+           strcmp(read->module, module->module) == 0 &&
+           strcmp(read->action, action->action) == 0 &&
+           strcmp(read->userID, user->userID) == 0 &&
+           strcmp(read->logID, log_id->logID) == 0 &&
+           strcmp(read->details, details->details) == 0;
+}
+
+// Helper function to read a whole segment with a column set; returns the
+// number of records that matched, or -1 when the reader failed
+static int read_with_columns(const LogSegmentInfo* info, time_t base, unsigned int columns) {
+    LogSegmentReader reader;
+    if (log_segment_reader_open(info, &reader) != SUCCESS) {
+        return -1;
+    }
+    log_segment_reader_set_columns(&reader, columns);
+
+    int matched = 0;
+    int index = 0;
+    const LogEntry* entry;
+    while ((entry = log_segment_reader_next(&reader)) != NULL) {
+        LogEntry expected;
+        make_record(index++, base, &expected);
+        matched += fields_match(entry, &expected, columns);
+    }
+
+    log_segment_reader_close(&reader);
+    return index == COLUMNAR_RECORDS ? matched : -1;
+}
+
+// Every field of every record survives archiving
+int test_columnar_round_trips_all_columns(void) {
+    time_t base;
+    LogSegmentInfo archived;
+    int ok = archive_records(&base, &archived);
+    int matched = ok ? read_with_columns(&archived, base, LOG_COLUMNS_ALL) : -1;
+    close_store();
+
+    TEST_ASSERT(ok, "Archiving the sealed segment failed");
+    TEST_ASSERT(matched == COLUMNAR_RECORDS, "Archived records differ from the appended ones");
+    return 1;
+}
+
+// A column subset decodes exactly its fields, and changing the subset
+// mid-block decodes the block again
+int test_columnar_reads_column_subsets(void) {
+    static const unsigned int subsets[] = {
+        LOG_COLUMN_BIT(LOG_COLUMN_TIMESTAMP),
+        LOG_COLUMN_BIT(LOG_COLUMN_USER) | LOG_COLUMN_BIT(LOG_COLUMN_MODULE),
+        LOG_COLUMN_BIT(LOG_COLUMN_ACTION) | LOG_COLUMN_BIT(LOG_COLUMN_DETAILS),
+        LOG_COLUMN_BIT(LOG_COLUMN_LOG_ID) | LOG_COLUMN_BIT(LOG_COLUMN_TIMESTAMP),
+        0
+    };
+    const int subset_count = (int)(sizeof(subsets) / sizeof(subsets[0]));
+
+    time_t base;
+    LogSegmentInfo archived;
+    int ok = archive_records(&base, &archived);
+
+    int subsets_ok = ok;
+    for (int i = 0; subsets_ok && i < subset_count; i++) {
+        subsets_ok = read_with_columns(&archived, base, subsets[i]) == COLUMNAR_RECORDS;
+    }
+
+    // Widen the columns of a reader whose window already holds a block
+    int switched = 0;
+    LogSegmentReader reader;
+    if (ok && log_segment_reader_open(&archived, &reader) == SUCCESS) {
+        LogEntry expected;
+        log_segment_reader_set_columns(&reader, LOG_COLUMN_BIT(LOG_COLUMN_USER));
+        const LogEntry* narrow = log_segment_reader_read_at(&reader, 1030);
+        make_record(1030, base, &expected);
+        switched = narrow && fields_match(narrow, &expected, LOG_COLUMN_BIT(LOG_COLUMN_USER));
+
+        log_segment_reader_set_columns(&reader, LOG_COLUMNS_ALL);
+        const LogEntry* wide = log_segment_reader_read_at(&reader, 1031);
+        make_record(1031, base, &expected);
+        switched = switched && wide && fields_match(wide, &expected, LOG_COLUMNS_ALL);
+        log_segment_reader_close(&reader);
+    }
+    close_store();
+
+    TEST_ASSERT(ok, "Archiving the sealed segment failed");
+    TEST_ASSERT(subsets_ok, "A column subset decoded wrong or extra fields");
+    TEST_ASSERT(switched, "Changing the columns mid-block returned stale fields");
+    return 1;
+}
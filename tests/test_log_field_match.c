@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_tests.h"
+#include "../src/field_match.h"
+
+#define FIELD_OFFSET 3
+#define FIELD_STRIDE (FIELD_OFFSET + FIELD_MATCH_MAX_WIDTH + 1)
+#define MAX_CASE_RECORDS (FIELD_MATCH_MAX_WIDTH + 2)
+
+static const int spans[] = { 15, 16, 31, 32, 64 };
+static const FieldKernel kernels[] = { FIELD_KERNEL_SCALAR, FIELD_KERNEL_SSE2, FIELD_KERNEL_AVX2 };
+
+// Helper function to lay out records around a key of span compared bytes:
+// an exact copy, a copy with garbage after the span, and one near miss per
+// compared byte. Returns the record count and the number of matches.
+static int build_records(unsigned char* records, const char* key, size_t span, int* expected) {
+    size_t length = strlen(key);
+    int count = 0;
+    *expected = 0;
+
+    for (size_t variant = 0; variant < span + 2; variant++) {
+        unsigned char* field = records + count * FIELD_STRIDE + FIELD_OFFSET;
+        memset(field - FIELD_OFFSET, '#', FIELD_STRIDE);
+        memset(field, 0, FIELD_MATCH_MAX_WIDTH);
+        memcpy(field, key, length);
+
+        if (variant == 1 && span < FIELD_MATCH_MAX_WIDTH) {
+            memset(field + span, 'Z', FIELD_MATCH_MAX_WIDTH - span);
+        } else if (variant >= 2) {
+            size_t position = variant - 2;
+            field[position] = position < length ? (unsigned char)(field[position] ^ 0x20) : 'x';
+        }
+
+        int matches = memcmp(field, key, length) == 0 && (span == length || field[length] == '\0');
+        *expected += matches;
+        count++;
+    }
+    return count;
+}
+
+// Scalar, SSE2 and AVX2 kernels mark the same records for keys whose compared
+// span straddles the 16 and 32 byte load widths
+int test_field_match_kernels_agree(void) {
+    unsigned char* records = malloc(MAX_CASE_RECORDS * FIELD_STRIDE);
+    TEST_ASSERT(records != NULL, "Allocating records failed");
+
+    int agreed = 1;
+    int counted = 1;
+    int kernels_run = 0;
+    for (size_t s = 0; s < sizeof(spans) / sizeof(spans[0]); s++) {
+        for (int mode = FIELD_MATCH_EQUAL; mode <= FIELD_MATCH_PREFIX; mode++) {
+            // Equality also compares the terminating NUL
+            size_t length = mode == FIELD_MATCH_EQUAL ? (size_t)spans[s] - 1 : (size_t)spans[s];
+            char key[FIELD_MATCH_MAX_WIDTH + 1];
+            for (size_t i = 0; i < length; i++) {
+                key[i] = (char)('a' + (i * 7) % 26);
+            }
+            key[length] = '\0';
+
+            FieldPattern pattern;
+            if (field_pattern_init(&pattern, key, FIELD_MATCH_MAX_WIDTH, (FieldMatchMode)mode) != SUCCESS ||
+                pattern.span != (size_t)spans[s]) {
+                agreed = 0;
+                continue;
+            }
+
+            int expected = 0;
+            int count = build_records(records, key, pattern.span, &expected);
+            unsigned char reference[MAX_CASE_RECORDS];
+            int reference_matches = -1;
+
+            for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+                if (field_match_use_kernel(kernels[k]) != SUCCESS) {
+                    continue;
+                }
+                kernels_run++;
+
+                unsigned char marks[MAX_CASE_RECORDS];
+                int matches = field_match_block(&pattern, records, FIELD_STRIDE, FIELD_OFFSET, count, marks);
+                counted = counted && matches == expected;
+                if (reference_matches < 0) {
+                    memcpy(reference, marks, count);
+                    reference_matches = matches;
+                } else {
+                    agreed = agreed && matches == reference_matches && memcmp(reference, marks, count) == 0;
+                }
+            }
+        }
+    }
+
+    field_match_use_kernel(FIELD_KERNEL_AUTO);
+    free(records);
+
+    TEST_ASSERT(kernels_run >= 10, "The scalar kernel did not run for every span");
+    TEST_ASSERT(counted, "A kernel counted the wrong number of matches");
+    TEST_ASSERT(agreed, "The kernels marked different records");
+    return 1;
+}
@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "log_tests.h"
+#include "../src/utils.h"
+
+#define ID_THREADS 8
+#define IDS_PER_THREAD 5000
+#define ID_LEN 20
+#define FREE_NODE 77
+
+// IDs generated by every thread, ID_THREADS runs of IDS_PER_THREAD
+static char generated[ID_THREADS * IDS_PER_THREAD][ID_LEN];
+
+// Thread generating its run of IDs; returns non-NULL when they did not increase
+static void* generate_run(void* arg) {
+    char (*run)[ID_LEN] = generated + (long)arg * IDS_PER_THREAD;
+    for (int i = 0; i < IDS_PER_THREAD; i++) {
+        if (generate_unique_id(run[i], ID_LEN, "LOG") != 0 ||
+            (i > 0 && strcmp(run[i - 1], run[i]) >= 0)) {
+            return run;
+        }
+    }
+    return NULL;
+}
+
+static int compare_ids(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+// Helper function to read the node bits of an ID after a three-letter prefix
+static int id_node_of(const char* id) {
+    static const char alphabet[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+    unsigned long long value = 0;
+    for (const char* c = id + 3; *c; c++) {
+        const char* digit = strchr(alphabet, *c);
+        if (!digit) {
+            return -1;
+        }
+        value = (value << 5) | (unsigned long long)(digit - alphabet);
+    }
+    return (int)((value >> 12) & 1023);
+}
+
+// IDs from concurrent threads are all distinct, and each thread's IDs increase
+int test_ids_unique_and_increasing_across_threads(void) {
+    pthread_t threads[ID_THREADS];
+    int increasing = 1;
+    for (long i = 0; i < ID_THREADS; i++) {
+        TEST_ASSERT(pthread_create(&threads[i], NULL, generate_run, (void*)i) == 0, "Starting a thread failed");
+    }
+    for (int i = 0; i < ID_THREADS; i++) {
+        void* failed = NULL;
+        pthread_join(threads[i], &failed);
+        increasing = increasing && failed == NULL;
+    }
+
+    qsort(generated, ID_THREADS * IDS_PER_THREAD, ID_LEN, compare_ids);
+    int distinct = 1;
+    for (int i = 1; i < ID_THREADS * IDS_PER_THREAD; i++) {
+        distinct = distinct && strcmp(generated[i - 1], generated[i]) != 0;
+    }
+
+    TEST_ASSERT(increasing, "A thread's IDs did not strictly increase");
+    TEST_ASSERT(distinct, "Two threads generated the same ID");
+    TEST_ASSERT(strlen(generated[0]) == 16, "IDs should be the prefix plus 13 digits");
+    return 1;
+}
+
+// A process whose node is held by another process moves to a free node
+int test_ids_skip_nodes_held_by_other_processes(void) {
+    int ready[2];
+    int release[2];
+    int result[2];
+    TEST_ASSERT(pipe(ready) == 0 && pipe(release) == 0 && pipe(result) == 0, "Creating pipes failed");
+    mkdir("data", 0755);
+
+    // Holder: locks every node but FREE_NODE until released
+    pid_t holder = fork();
+    TEST_ASSERT(holder >= 0, "Forking the holder failed");
+    if (holder == 0) {
+        close(release[1]);
+        int fd = open("data/id_nodes", O_RDWR | O_CREAT, 0644);
+        struct flock below = { .l_type = F_WRLCK, .l_whence = SEEK_SET, .l_start = 0, .l_len = FREE_NODE };
+        struct flock above = { .l_type = F_WRLCK, .l_whence = SEEK_SET, .l_start = FREE_NODE + 1,
+                               .l_len = 1024 - FREE_NODE - 1 };
+        char byte = fd >= 0 && fcntl(fd, F_SETLK, &below) == 0 && fcntl(fd, F_SETLK, &above) == 0;
+        if (write(ready[1], &byte, 1) != 1 || read(release[0], &byte, 1) < 0) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    char locked = 0;
+    int holding = read(ready[0], &locked, 1) == 1 && locked;
+
+    // Generator: a fresh process claims its node on its first ID
+    char id[ID_LEN] = "";
+    pid_t generator = holding ? fork() : -1;
+    if (generator == 0) {
+        int ok = generate_unique_id(id, sizeof(id), "LOG") == 0 &&
+                 write(result[1], id, sizeof(id)) == (ssize_t)sizeof(id);
+        _exit(ok ? 0 : 1);
+    }
+    int reported = generator > 0 && read(result[0], id, sizeof(id)) == (ssize_t)sizeof(id);
+
+    close(release[1]);
+    waitpid(holder, NULL, 0);
+    if (generator > 0) {
+        waitpid(generator, NULL, 0);
+    }
+    close(ready[0]);
+    close(ready[1]);
+    close(release[0]);
+    close(result[0]);
+    close(result[1]);
+
+    TEST_ASSERT(holding, "The holder could not lock the node registry");
+    TEST_ASSERT(reported, "The generating process did not report an ID");
+    TEST_ASSERT(id_node_of(id) == FREE_NODE, "The ID did not use the only free node");
+    return 1;
+}
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log_tests.h"
+#include "../src/log_store.h"
+#include "../src/log_query.h"
+#include "../src/log_postings.h"
+
+#define PAGING_MAX_RECORDS 1200
+
+// Helper function to append records numbered from first, spread over users
+static int append_records(int first, int count, int users) {
+    for (int i = first; i < first + count; i++) {
+        LogEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        snprintf(entry.logID, sizeof(entry.logID), "LOG%05d", i);
+        snprintf(entry.userID, sizeof(entry.userID), "USER%d", i % users);
+        snprintf(entry.module, sizeof(entry.module), "Paging");
+        snprintf(entry.action, sizeof(entry.action), "Append");
+        snprintf(entry.details, sizeof(entry.details), "record %d", i);
+        entry.timestamp = time(NULL);
+
+        if (log_store_append(&entry) != SUCCESS) {
+            return 0;
+        }
+    }
+    return log_store_flush() == SUCCESS;
+}
+
+// Helper function to read a listing page by page; fills numbers with the
+// record numbers in listing order and returns how many there were, or -1.
+// With appended set, that many more records are appended after the first page.
+static int read_pages(const LogQuery* query, LogPageOrder order, int limit, int* numbers, int appended) {
+    LogEntry* records = (LogEntry*)malloc(limit * sizeof(LogEntry));
+    if (!records) {
+        return -1;
+    }
+
+    char token[LOG_PAGE_TOKEN_LEN] = "";
+    int total = 0;
+    int pages = 0;
+    do {
+        LogPage page = { records, limit, 0, "" };
+        if (log_query_page(query, order, token, &page) != SUCCESS || total + page.count > PAGING_MAX_RECORDS) {
+            free(records);
+            return -1;
+        }
+        for (int i = 0; i < page.count; i++) {
+            numbers[total++] = atoi(page.records[i].details + strlen("record "));
+        }
+        strcpy(token, page.next_token);
+
+        if (++pages == 1 && appended > 0 && !append_records(PAGING_MAX_RECORDS, appended, 1)) {
+            free(records);
+            return -1;
+        }
+    } while (token[0] != '\0');
+
+    free(records);
+    return total;
+}
+
+// Helper function to check a listing against the records first, first + step, ...
+// (or the reverse when newest first)
+static int listing_is(const int* numbers, int count, int first, int step, int expected, int newest) {
+    if (count != expected) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        int want = first + step * (newest ? expected - 1 - i : i);
+        if (numbers[i] != want) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Visitor discarding records; only the query statistics are wanted
+static int ignore_record(const LogEntry* entry, void* context) {
+    (void)entry;
+    (void)context;
+    return 0;
+}
+
+// Tokens carry a listing from one segment into the next in both orders
+int test_page_resumes_across_segments(void) {
+    LogStoreConfig small = { 100 * (long long)sizeof(LogFrame) };
+    LogStoreConfig standard = { LOG_STORE_DEFAULT_SEGMENT_BYTES };
+    TEST_ASSERT(log_store_configure(&small) == SUCCESS, "Configuring the store failed");
+
+    int appended = append_records(0, 350, 5);
+    log_store_compact();
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    log_store_list_segments(0, 0, &segments, &segment_count);
+    free(segments);
+
+    static int numbers[PAGING_MAX_RECORDS];
+    LogQuery query = { 0, 0, "USER2", "Paging", NULL, NULL, NULL };
+    int oldest = read_pages(&query, LOG_PAGE_OLDEST_FIRST, 9, numbers, 0);
+    int oldest_ok = listing_is(numbers, oldest, 2, 5, 70, 0);
+    int newest = read_pages(&query, LOG_PAGE_NEWEST_FIRST, 9, numbers, 0);
+    int newest_ok = listing_is(numbers, newest, 2, 5, 70, 1);
+
+    log_store_close();
+    log_store_configure(&standard);
+
+    TEST_ASSERT(appended, "Appending records failed");
+    TEST_ASSERT(segment_count == 4, "Expected the records to span four segments");
+    TEST_ASSERT(oldest_ok, "Oldest-first pages skipped or repeated records");
+    TEST_ASSERT(newest_ok, "Newest-first pages skipped or repeated records");
+    return 1;
+}
+
+// A newest-first listing stays on the records present at its first page
+int test_newest_first_page_pins_listing(void) {
+    TEST_ASSERT(append_records(0, 100, 1), "Appending records failed");
+
+    static int numbers[PAGING_MAX_RECORDS];
+    LogQuery query = { 0, 0, NULL, "Paging", NULL, NULL, NULL };
+    int listed = read_pages(&query, LOG_PAGE_NEWEST_FIRST, 10, numbers, 30);
+    int pinned = listing_is(numbers, listed, 0, 1, 100, 1);
+
+    // A new listing starts from the newest record
+    LogEntry first;
+    LogPage page = { &first, 1, 0, "" };
+    ErrorCode result = log_query_page(&query, LOG_PAGE_NEWEST_FIRST, NULL, &page);
+    log_store_close();
+
+    TEST_ASSERT(pinned, "Records appended during the listing shifted its pages");
+    TEST_ASSERT(result == SUCCESS && page.count == 1 &&
+                strcmp(first.details, "record 1229") == 0, "A new listing missed the appended records");
+    return 1;
+}
+
+// Pages continue across the point where a segment's postings end and its
+// unindexed tail is scanned
+int test_page_resumes_across_postings_tail_split(void) {
+    TEST_ASSERT(append_records(0, 1000, 10), "Appending records failed");
+
+    // Reopen the active postings from a snapshot 400 records short, as if
+    // they lagged the segment: records 600 and on are left to the tail scan
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    TEST_ASSERT(log_store_list_segments(0, 0, &segments, &segment_count) == SUCCESS && segment_count == 1,
+                "Expected one segment");
+    LogSegmentInfo lagging = segments[0];
+    lagging.record_count = 600;
+    free(segments);
+    TEST_ASSERT(log_postings_active_open(&lagging) == SUCCESS, "Reopening the postings failed");
+
+    LogQuery query = { 0, 0, "USER3", NULL, NULL, NULL, NULL };
+    LogQueryStats stats;
+    log_query(&query, ignore_record, &stats);
+
+    static int numbers[PAGING_MAX_RECORDS];
+    int oldest = read_pages(&query, LOG_PAGE_OLDEST_FIRST, 7, numbers, 0);
+    int oldest_ok = listing_is(numbers, oldest, 3, 10, 100, 0);
+    int newest = read_pages(&query, LOG_PAGE_NEWEST_FIRST, 7, numbers, 0);
+    int newest_ok = listing_is(numbers, newest, 3, 10, 100, 1);
+    log_store_close();
+
+    TEST_ASSERT(stats.segments_by_postings == 1, "The planner did not use the postings");
+    TEST_ASSERT(oldest_ok, "Oldest-first pages broke at the postings tail");
+    TEST_ASSERT(newest_ok, "Newest-first pages broke at the postings tail");
+    return 1;
+}
+
+// Damaged tokens, and tokens issued for the other order, are refused
+int test_page_rejects_tampered_token(void) {
+    TEST_ASSERT(append_records(0, 50, 1), "Appending records failed");
+
+    LogEntry records[10];
+    LogQuery query = { 0, 0, NULL, "Paging", NULL, NULL, NULL };
+    LogPage page = { records, 10, 0, "" };
+    ErrorCode first = log_query_page(&query, LOG_PAGE_OLDEST_FIRST, NULL, &page);
+
+    char token[LOG_PAGE_TOKEN_LEN];
+    strcpy(token, page.next_token);
+    ErrorCode valid = log_query_page(&query, LOG_PAGE_OLDEST_FIRST, token, &page);
+
+    char tampered[LOG_PAGE_TOKEN_LEN];
+    strcpy(tampered, token);
+    char* position = strchr(tampered, '.') + 1;
+    *position = *position == '1' ? '2' : '1';
+    ErrorCode edited = log_query_page(&query, LOG_PAGE_OLDEST_FIRST, tampered, &page);
+    ErrorCode other_order = log_query_page(&query, LOG_PAGE_NEWEST_FIRST, token, &page);
+    ErrorCode garbage = log_query_page(&query, LOG_PAGE_OLDEST_FIRST, "not-a-token", &page);
+    log_store_close();
+
+    TEST_ASSERT(first == SUCCESS && token[0] != '\0', "The first page carried no token");
+    TEST_ASSERT(valid == SUCCESS && strcmp(records[0].details, "record 10") == 0, "A valid token did not resume");
+    TEST_ASSERT(edited == ERROR_INVALID_INPUT, "An edited token was accepted");
+    TEST_ASSERT(other_order == ERROR_INVALID_INPUT, "A token was accepted for the other order");
+    TEST_ASSERT(garbage == ERROR_INVALID_INPUT, "A malformed token was accepted");
+    return 1;
+}
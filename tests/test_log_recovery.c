@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "log_tests.h"
+#include "../src/log_store.h"
+#include "../src/file_io.h"
+
+// Helper function to append records to the store in a child process that
+// then exits without closing it, as a crash would. With synced_records > 0,
+// the first synced_records records are synced, so the checkpoint covers them.
+static int write_and_crash(int records, int synced_records) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        return 0;
+    }
+
+    if (pid == 0) {
+        for (int i = 0; i < records; i++) {
+            LogEntry entry;
+            memset(&entry, 0, sizeof(entry));
+            snprintf(entry.logID, sizeof(entry.logID), "LOG%05d", i);
+            snprintf(entry.userID, sizeof(entry.userID), "USER%d", i % 7);
+            snprintf(entry.module, sizeof(entry.module), "Recovery");
+            snprintf(entry.action, sizeof(entry.action), "Append");
+            snprintf(entry.details, sizeof(entry.details), "record %d", i);
+            entry.timestamp = time(NULL);
+
+            if (log_store_append(&entry) != SUCCESS) {
+                _exit(1);
+            }
+            if (i + 1 == synced_records && log_store_sync() != SUCCESS) {
+                _exit(1);
+            }
+        }
+        _exit(log_store_flush() == SUCCESS ? 0 : 1);
+    }
+
+    int status = 0;
+    return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Helper function to get the path of the active segment from the manifest
+static int active_segment_path(char* path, size_t path_size) {
+    LogSegmentInfo* segments = NULL;
+    int count = 0;
+    if (log_store_read_manifest(&segments, &count) != SUCCESS || count == 0) {
+        return 0;
+    }
+
+    log_store_segment_path(&segments[count - 1], path, path_size);
+    free(segments);
+    return 1;
+}
+
+// Helper function to flip one byte inside the entry of a frame
+static int corrupt_frame(const char* path, long long frame) {
+    FILE* file = fopen(path, "r+b");
+    if (!file) {
+        return 0;
+    }
+
+    long offset = (long)(frame * (long long)sizeof(LogFrame) + offsetof(LogFrame, entry) +
+                         offsetof(LogEntry, details));
+    int byte = -1;
+    if (fseek(file, offset, SEEK_SET) == 0) {
+        byte = fgetc(file);
+    }
+    int ok = byte >= 0 && fseek(file, offset, SEEK_SET) == 0 && fputc(byte ^ 0xff, file) != EOF;
+    fclose(file);
+    return ok;
+}
+
+// Helper function to cut bytes off the end of a file
+static int truncate_file(const char* path, long bytes) {
+    FILE* file = fopen(path, "r+b");
+    if (!file) {
+        return 0;
+    }
+
+    int ok = fseek(file, 0, SEEK_END) == 0;
+    long size = ftell(file);
+    ok = ok && size >= bytes && ftruncate(fileno(file), size - bytes) == 0;
+    fclose(file);
+    return ok;
+}
+
+// Visitor counting the records a scan returns
+static int count_record(const LogEntry* entry, void* context) {
+    (void)entry;
+    (*(long long*)context)++;
+    return 0;
+}
+
+// Helper function to open the store and count the records its manifest
+// reports, and in *scanned the records a scan returns
+static long long recovered_records(long long* scanned) {
+    LogSegmentInfo* segments = NULL;
+    int count = 0;
+    if (log_store_list_segments(0, 0, &segments, &count) != SUCCESS) {
+        return -1;
+    }
+
+    long long total = 0;
+    for (int i = 0; i < count; i++) {
+        total += segments[i].record_count;
+    }
+    free(segments);
+
+    *scanned = 0;
+    log_store_scan(0, 0, count_record, scanned);
+    return total;
+}
+
+// A frame cut short by a crash is dropped, and appends continue after the last whole frame
+int test_recovery_drops_torn_final_frame(void) {
+    char path[128];
+    TEST_ASSERT(write_and_crash(100, 0), "Writer process failed");
+    TEST_ASSERT(active_segment_path(path, sizeof(path)), "No active segment in the manifest");
+    TEST_ASSERT(truncate_file(path, 100), "Could not tear the final frame");
+
+    long long scanned = 0;
+    long long recovered = recovered_records(&scanned);
+    long size = get_file_size(path);
+
+    LogEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    snprintf(entry.module, sizeof(entry.module), "Recovery");
+    entry.timestamp = time(NULL);
+    ErrorCode appended = log_store_append(&entry);
+    log_store_flush();
+    long long after = recovered_records(&scanned);
+    log_store_close();
+
+    TEST_ASSERT(recovered == 99, "Expected the 99 whole frames to survive");
+    TEST_ASSERT(size == 99 * (long)sizeof(LogFrame), "Torn frame was not truncated");
+    TEST_ASSERT(appended == SUCCESS && after == 100 && scanned == 100, "Append after recovery failed");
+    return 1;
+}
+
+// A frame whose CRC no longer matches ends the segment there, even when
+// whole frames follow it
+int test_recovery_stops_at_corrupt_crc(void) {
+    char path[128];
+    TEST_ASSERT(write_and_crash(100, 0), "Writer process failed");
+    TEST_ASSERT(active_segment_path(path, sizeof(path)), "No active segment in the manifest");
+    TEST_ASSERT(corrupt_frame(path, 40), "Could not corrupt a frame");
+
+    long long scanned = 0;
+    long long recovered = recovered_records(&scanned);
+    long size = get_file_size(path);
+    log_store_close();
+
+    TEST_ASSERT(recovered == 40 && scanned == 40, "Expected the 40 frames before the corrupt one");
+    TEST_ASSERT(size == 40 * (long)sizeof(LogFrame), "Segment was not cut at the corrupt frame");
+    return 1;
+}
+
+// Frames up to the checkpoint are trusted without verification; only the
+// tail after it is checked
+int test_recovery_starts_from_checkpoint(void) {
+    char path[128];
+    TEST_ASSERT(write_and_crash(150, 100), "Writer process failed");
+    TEST_ASSERT(active_segment_path(path, sizeof(path)), "No active segment in the manifest");
+    TEST_ASSERT(corrupt_frame(path, 20), "Could not corrupt a checkpointed frame");
+    TEST_ASSERT(corrupt_frame(path, 120), "Could not corrupt a frame after the checkpoint");
+
+    long long scanned = 0;
+    long long recovered = recovered_records(&scanned);
+    log_store_close();
+
+    TEST_ASSERT(recovered == 120 && scanned == 120,
+                "Expected the checkpointed frames plus the 20 intact frames after them");
+    return 1;
+}
@@ -0,0 +1,168 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+
+#include "log_tests.h"
+#include "../src/log_store.h"
+#include "../src/log_aggregate.h"
+#include "../src/log_retention.h"
+#include "../src/file_io.h"
+
+#define SECONDS_PER_DAY 86400
+
+// Helper function to append records stamped with one timestamp
+static int append_dated(int first, int count, time_t timestamp) {
+    for (int i = first; i < first + count; i++) {
+        LogEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        snprintf(entry.logID, sizeof(entry.logID), "LOG%05d", i);
+        snprintf(entry.userID, sizeof(entry.userID), "USER%d", i % 3);
+        snprintf(entry.module, sizeof(entry.module), "Retention");
+        snprintf(entry.action, sizeof(entry.action), "Append");
+        snprintf(entry.details, sizeof(entry.details), "record %d", i);
+        entry.timestamp = timestamp;
+
+        if (log_store_append(&entry) != SUCCESS) {
+            return 0;
+        }
+    }
+    return log_store_flush() == SUCCESS;
+}
+
+// Helper function to count the files of a segment, in any format
+static int segment_file_count(const LogSegmentInfo* info) {
+    char stem[LOG_SEGMENT_PATH_LEN];
+    snprintf(stem, sizeof(stem), "%s", info->file_name);
+    char* extension = strrchr(stem, '.');
+    if (extension) {
+        extension[1] = '\0';
+    }
+
+    DIR* directory = opendir(LOG_STORE_DIR);
+    if (!directory) {
+        return 0;
+    }
+    int count = 0;
+    struct dirent* item;
+    while ((item = readdir(directory)) != NULL) {
+        count += strncmp(item->d_name, stem, strlen(stem)) == 0;
+    }
+    closedir(directory);
+    return count;
+}
+
+// Helper function to count every record the aggregation sees, rollups included
+static long long aggregate_total(void) {
+    LogAggregateQuery query;
+    memset(&query, 0, sizeof(query));
+    query.group_by = LOG_GROUP_DAY;
+
+    LogAggregateResult result;
+    if (log_aggregate(&query, &result) != SUCCESS) {
+        return -1;
+    }
+    long long total = result.total;
+    log_aggregate_free(&result);
+    return total;
+}
+
+// Helper function to restore the default segment size after a test
+static void close_store(void) {
+    LogStoreConfig standard = { LOG_STORE_DEFAULT_SEGMENT_BYTES };
+    log_store_close();
+    log_store_configure(&standard);
+}
+
+// Expired segments are rolled up and dropped by one pass, and their files
+// unlinked by the next
+int test_retention_rolls_up_drops_then_unlinks(void) {
+    LogStoreConfig small = { 100 * (long long)sizeof(LogFrame) };
+    TEST_ASSERT(log_store_configure(&small) == SUCCESS, "Configuring the store failed");
+
+    // 150 records from 200 days ago fill two segments; today's records seal them
+    time_t now = time(NULL);
+    int appended = append_dated(0, 150, now - 200 * SECONDS_PER_DAY) && append_dated(150, 10, now);
+    log_store_compact();
+
+    LogSegmentInfo* before = NULL;
+    int before_count = 0;
+    log_store_list_segments(0, 0, &before, &before_count);
+    long long total_before = aggregate_total();
+
+    LogRetentionPolicy policy;
+    log_retention_default_policy(&policy);
+    policy.rollup_days = 0;
+    policy.segments_per_pass = 0;
+
+    LogRetentionStats first;
+    ErrorCode first_result = log_retention_run(&policy, now, &first);
+    LogSegmentInfo* after = NULL;
+    int after_count = 0;
+    log_store_list_segments(0, 0, &after, &after_count);
+    long long total_rolled = aggregate_total();
+    int kept_files = before_count == 3 ? segment_file_count(&before[0]) + segment_file_count(&before[1]) : 0;
+    int pending_written = get_file_size(LOG_RETENTION_PENDING) > 0;
+
+    LogRetentionStats second;
+    ErrorCode second_result = log_retention_run(&policy, now, &second);
+    int left_files = before_count == 3 ? segment_file_count(&before[0]) + segment_file_count(&before[1]) : -1;
+    int pending_cleared = get_file_size(LOG_RETENTION_PENDING) <= 0;
+
+    free(before);
+    free(after);
+    close_store();
+
+    TEST_ASSERT(appended, "Appending records failed");
+    TEST_ASSERT(before_count == 3 && total_before == 160, "Expected two expired segments and an active one");
+    TEST_ASSERT(first_result == SUCCESS && first.segments_dropped == 2 && first.segments_unlinked == 0,
+                "The first pass should drop both expired segments and unlink nothing");
+    TEST_ASSERT(after_count == 1, "Dropped segments are still in the manifest");
+    TEST_ASSERT(total_rolled == 160, "The rollup lost records of the dropped segments");
+    TEST_ASSERT(kept_files > 0 && pending_written, "Dropped files should wait for the next pass");
+    TEST_ASSERT(second_result == SUCCESS && second.segments_dropped == 0 && second.segments_unlinked == 2,
+                "The second pass should unlink both dropped segments");
+    TEST_ASSERT(left_files == 0 && pending_cleared, "Files of dropped segments were left behind");
+    return 1;
+}
+
+// A pending entry whose drop never reached the manifest, as after a crash
+// between the two, does not unlink the live segment
+int test_retention_keeps_pending_segment_still_listed(void) {
+    LogStoreConfig small = { 100 * (long long)sizeof(LogFrame) };
+    TEST_ASSERT(log_store_configure(&small) == SUCCESS, "Configuring the store failed");
+
+    int appended = append_dated(0, 150, time(NULL));
+    log_store_compact();
+
+    LogSegmentInfo* segments = NULL;
+    int segment_count = 0;
+    log_store_list_segments(0, 0, &segments, &segment_count);
+
+    int recorded = 0;
+    if (segment_count == 2) {
+        FILE* file = fopen(LOG_RETENTION_PENDING, "wb");
+        recorded = file && fwrite(&segments[0], sizeof(LogSegmentInfo), 1, file) == 1;
+        if (file) {
+            fclose(file);
+        }
+    }
+
+    LogRetentionPolicy policy;
+    log_retention_default_policy(&policy);
+    LogRetentionStats stats;
+    ErrorCode result = log_retention_run(&policy, time(NULL), &stats);
+    int files = segment_count == 2 ? segment_file_count(&segments[0]) : 0;
+
+    free(segments);
+    close_store();
+
+    TEST_ASSERT(appended && recorded, "Setting up the pending entry failed");
+    TEST_ASSERT(result == SUCCESS && stats.segments_unlinked == 0, "A listed segment was counted as unlinked");
+    TEST_ASSERT(files > 0, "Files of a segment still in the manifest were removed");
+    TEST_ASSERT(get_file_size(LOG_RETENTION_PENDING) <= 0, "The stale pending entry was not cleared");
+    return 1;
+}
@@ -0,0 +1,80 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log_tests.h"
+#include "../src/logging.h"
+#include "../src/log_sampling.h"
+
+// Helper function to count logged entries of a (module, action); with
+// summaries set, counts the sampling summary records instead
+static int count_logged(const char* module, const char* action, int summaries) {
+    LogEntry* logs = NULL;
+    int count = 0;
+    if (get_logs_by_module(module, &logs, &count) != SUCCESS) {
+        return -1;
+    }
+
+    int matched = 0;
+    for (int i = 0; i < count; i++) {
+        int summary = strncmp(logs[i].details, "Sampled out", 11) == 0;
+        if (strcmp(logs[i].action, action) == 0 && summary == summaries) {
+            matched++;
+        }
+    }
+    free(logs);
+    return matched;
+}
+
+// A write action is logged in full even when its (module, action) admits
+// nothing: the policy's single token is spent on the first read event
+int test_write_action_survives_sampling(void) {
+    TEST_ASSERT(init_logging_system() == SUCCESS, "Logging initialization failed");
+
+    LogSamplePolicy none = { LOG_SAMPLE_RATE_LIMIT, 0, 1e-9, 1 };
+    TEST_ASSERT(log_sampling_set_policy("Auth", "Create User", &none) == SUCCESS,
+                "Setting a policy on a write action failed");
+
+    for (int i = 0; i < 10; i++) {
+        log_action("SYSTEM", "Auth", "Create User", "sampled");
+    }
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT(log_write_action("SYSTEM", "Auth", "Create User", "written") == SUCCESS,
+                    "Logging a write action failed");
+    }
+    flush_logging_system();
+
+    int logged = count_logged("Auth", "Create User", 0);
+    int summaries = count_logged("Auth", "Create User", 1);
+    log_sampling_reset();
+    cleanup_logging_system();
+
+    TEST_ASSERT(logged == 6, "Expected one sampled event plus all five writes");
+    TEST_ASSERT(summaries == 1, "Suppressed events were not summarized");
+    return 1;
+}
+
+// A policy set explicitly, even one that logs everything, stays in place
+// until it is cleared, while slots kept only for their counts are collected
+int test_explicit_policy_survives_collect(void) {
+    LogSamplePolicy always = { LOG_SAMPLE_ALWAYS, 0, 0, 0 };
+    LogSamplePolicy one_in_two = { LOG_SAMPLE_ONE_IN_N, 2, 0, 0 };
+    TEST_ASSERT(log_sampling_set_policy("Student", "Search", &always) == SUCCESS, "Setting a policy failed");
+    TEST_ASSERT(log_sampling_set_policy("Student", "List", &one_in_two) == SUCCESS, "Setting a policy failed");
+
+    log_sampling_admit("Student", "List");
+    log_sampling_admit("Student", "List");
+    TEST_ASSERT(log_sampling_clear_policy("Student", "List") == SUCCESS, "Clearing a policy failed");
+
+    LogSamplingSummary summaries[LOG_SAMPLING_MAX_POLICIES];
+    int collected = log_sampling_collect(time(NULL), 1, summaries, LOG_SAMPLING_MAX_POLICIES);
+
+    ErrorCode search = log_sampling_clear_policy("Student", "Search");
+    ErrorCode list = log_sampling_clear_policy("Student", "List");
+    log_sampling_reset();
+
+    TEST_ASSERT(collected == 1 && summaries[0].suppressed == 1, "Cleared policy lost its counts");
+    TEST_ASSERT(search == SUCCESS, "Explicit LOG_SAMPLE_ALWAYS policy was collected");
+    TEST_ASSERT(list == ERROR_DATA_NOT_FOUND, "Cleared policy outlived its summary");
+    return 1;
+}